@@ -0,0 +1,117 @@
+// Fleet Engine Strong-Scaling Benchmark
+//
+// Fixed fleet stepped at 10 ms with 1 to N worker threads: time, throughput,
+// speedup, parallel efficiency and stolen shards. One channel in ten is in
+// overload on the standard inverse curve (powf per tick), grouped at the
+// start of the fleet, so the static shard ranges are unbalanced and stealing
+// evens them out. The checksum of trip ticks and energies must be the same on
+// every line (results independent of the thread count).
+//
+//   bench_fleet_engine [channels] [ticks] [max_threads] [pin=0|1]
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "protection_overload.h"
+#include "fleet_engine.h"
+#include "sim_threads.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CHANNELS      262144u     // Default fleet
+#define BENCH_TICKS         500u        // Default ticks (5 s)
+#define BENCH_OVERLOADED    10u         // One channel in BENCH_OVERLOADED in overload
+
+// Not used: currents are passed to the engine
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static uint32_t bench_channels;
+
+// Overloaded channels at 1.3 x I_trip (trip after about 26 s), others at half load
+static void Bench_Load(void *context, uint32_t tick, uint32_t first, uint32_t count, float *currents) {
+    (void)context;
+    (void)tick;
+    for (uint32_t i = 0; i < count; i++) {
+        currents[i] = (first + i < bench_channels / BENCH_OVERLOADED) ? 1.3f : 0.5f;
+    }
+}
+
+static double Bench_Now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// FNV-1a over trip ticks and energies
+static uint64_t Bench_Checksum(const FleetEngine *engine, const ProtectionOverloadSM *sm, uint32_t count) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t words[2] = {FleetEngine_GetTripTick(engine, i), 0};
+        float energy = ProtectionOverload_GetEnergy(&sm[i]);
+        memcpy(&words[1], &energy, sizeof(energy));
+        for (unsigned int w = 0; w < 2; w++) {
+            hash = (hash ^ words[w]) * 0x100000001B3ull;
+        }
+    }
+    return hash;
+}
+
+int main(int argc, char *argv[]) {
+    bench_channels = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_CHANNELS;
+    uint32_t ticks = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 10) : BENCH_TICKS;
+    unsigned int max_threads = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : SimThreads_CpuCount();
+    bool pin = (argc > 4) && strcmp(argv[4], "pin=1") == 0;
+    if (bench_channels == 0 || max_threads == 0) {
+        fprintf(stderr, "Usage: %s [channels] [ticks] [max_threads] [pin=0|1]\n", argv[0]);
+        return 2;
+    }
+
+    const ProtectionOverloadParams params = {
+        .overload_threshold = 1.0f, .k_factor = 0.14f, .cooling_rate = 0.98f, .max_energy = 1.0f,
+        .curve = CURVE_STANDARD_INVERSE
+    };
+    ProtectionOverloadSM *sm = malloc(bench_channels * sizeof(ProtectionOverloadSM));
+    if (sm == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("%u channels, %u ticks, %u CPUs%s\n", bench_channels, ticks, SimThreads_CpuCount(), pin ? ", pinned" : "");
+    printf("%8s %10s %14s %9s %11s %8s %18s\n", "threads", "time_s", "Mch-ticks/s", "speedup", "efficiency", "steals", "checksum");
+    double single = 0.0;
+    // Powers of two, last line at max_threads
+    for (unsigned int threads = 1; threads <= max_threads;
+         threads = (threads < max_threads && threads * 2u > max_threads) ? max_threads : threads * 2u) {
+        for (uint32_t i = 0; i < bench_channels; i++) {
+            ProtectionOverload_Init(&sm[i], &params, ProtectionOverload_SM_GetCallRate());
+        }
+        FleetEngineConfig config = {.sm = sm, .count = bench_channels, .threads = threads, .pin = pin, .load = Bench_Load};
+        FleetEngine engine;
+        if (!FleetEngine_Create(&engine, &config)) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+
+        double start = Bench_Now();
+        if (!FleetEngine_Run(&engine, ticks)) {
+            fprintf(stderr, "Out of memory\n");
+            return 1;
+        }
+        double elapsed = Bench_Now() - start;
+        if (threads == 1) single = elapsed;
+
+        printf("%8u %10.3f %14.1f %9.2f %10.0f%% %8llu %18llx\n", engine.config.threads, elapsed,
+               (double)bench_channels * ticks / elapsed / 1e6, single / elapsed, 100.0 * single / elapsed / threads,
+               (unsigned long long)FleetEngine_GetSteals(&engine),
+               (unsigned long long)Bench_Checksum(&engine, sm, bench_channels));
+        FleetEngine_Destroy(&engine);
+    }
+
+    free(sm);
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Overload Protection Benchmark
+//
+// Measures the cost of ProtectionOverload_SM_Run over a deterministic load
+// profile (idle, heating and tripped ticks). The same binary is used on the
+// host (ns per call) and under QEMU (instructions per call, see Makefile).
+//
+//   bench_protection_overload [iterations]
+
+#include "protection_overload.h"
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef BENCH_NO_CLOCK
+#include <time.h>
+#endif
+
+#ifndef BENCH_ITERATIONS
+#define BENCH_ITERATIONS    10000000UL  // Default number of SM_Run calls
+#endif
+
+#define BENCH_STEP_SHIFT    8           // Profile level changes every 2^8 calls
+
+#ifndef BENCH_CURVE
+#define BENCH_CURVE         CURVE_I2T
+#endif
+
+#ifndef BENCH_VARIANT
+#define BENCH_VARIANT       "runtime params"
+#endif
+
+// Load profile [x I_trip]: below pickup, nominal, overload and cooling levels
+static const float bench_profile[] = {0.5f, 0.9f, 1.2f, 1.5f, 2.0f, 3.0f, 0.0f, 1.0f};
+#define BENCH_PROFILE_SIZE  (sizeof(bench_profile) / sizeof(bench_profile[0]))
+
+// Benchmark protection parameters (same as unit tests)
+static ProtectionOverloadParams bench_params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = BENCH_CURVE
+};
+
+// Mocked sensor value
+static volatile float bench_current = 0.0f;
+
+float Sensor_Read() {
+    return bench_current;
+}
+
+#ifndef BENCH_NO_CLOCK
+static double Bench_NowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+#endif
+
+int main(int argc, char *argv[]) {
+    unsigned long iterations = BENCH_ITERATIONS;
+    if (argc > 1) {
+        iterations = strtoul(argv[1], NULL, 10);
+    }
+
+    ProtectionOverload_SM_Init(&bench_params);
+    unsigned long trips = 0;
+
+#ifndef BENCH_NO_CLOCK
+    double start = Bench_NowNs();
+#endif
+    for (unsigned long i = 0; i < iterations; i++) {
+        bench_current = bench_profile[(i >> BENCH_STEP_SHIFT) % BENCH_PROFILE_SIZE];
+        ProtectionOverload_SM_Run();
+
+        // Re-arm after trip so that the profile keeps exercising the hot path
+        if (ProtectionOverload_SM_GetState() == ST_OVERLOAD_TRIGGERED) {
+            ProtectionOverload_SM_Init(&bench_params);
+            trips++;
+        }
+    }
+#ifndef BENCH_NO_CLOCK
+    double elapsed = Bench_NowNs() - start;
+    printf("ProtectionOverload_SM_Run (%s): %lu calls, %lu trips, %.2f ns/call\n",
+           BENCH_VARIANT, iterations, trips, iterations ? elapsed / iterations : 0.0);
+#else
+    printf("ProtectionOverload_SM_Run (%s): %lu calls, %lu trips\n", BENCH_VARIANT, iterations, trips);
+#endif
+    return 0;
+}
@@ -0,0 +1,101 @@
+// Multi-channel Bank Benchmark
+//
+// Cost per tick of ProtectionOverload_BankRun against one ProtectionOverload_Run
+// per channel, for activity ratios from an idle panel to all channels in
+// overload. Active channels are spread pseudo-randomly over the panel.
+//
+//   bench_protection_overload_bank [channels] [ticks]
+
+#include "protection_overload.h"
+#include "protection_overload_bank.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_CHANNELS      4096u       // Default number of channels
+#define BENCH_TICKS         2000u       // Default number of ticks per ratio
+
+// Active channels [per mille]
+static const unsigned int bench_ratios[] = {0, 1, 10, 100, 500, 1000};
+#define BENCH_RATIOS        (sizeof(bench_ratios) / sizeof(bench_ratios[0]))
+
+// Channel parameters: long trip time, active channels never trip during the run
+static const ProtectionOverloadParams bench_params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1e6f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+// Not used: currents are passed to the bank
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static double Bench_NowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int channels = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 10) : BENCH_CHANNELS;
+    unsigned int ticks = (argc > 2) ? (unsigned int)strtoul(argv[2], NULL, 10) : BENCH_TICKS;
+    unsigned int words = PROTECTION_OVERLOAD_BANK_WORDS(channels);
+
+    ProtectionOverloadParams *params = malloc(channels * sizeof(*params));
+    float *currents = malloc(channels * sizeof(*currents));
+    float *pickup_current = malloc(channels * sizeof(*pickup_current));
+    ProtectionOverloadBankChannel *channel = malloc(channels * sizeof(*channel));
+    uint64_t *armed = malloc(words * sizeof(*armed));
+    uint64_t *active = malloc(words * sizeof(*active));
+    ProtectionOverloadSM *sm = malloc(channels * sizeof(*sm));
+    if (!params || !currents || !pickup_current || !channel || !armed || !active || !sm) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    for (unsigned int i = 0; i < channels; i++) {
+        params[i] = bench_params;
+    }
+    const ProtectionOverloadBankStorage storage = {pickup_current, channel, armed, active};
+
+    printf("%-8s %10s %14s %14s %14s\n", "active", "channels", "bank_ns/tick", "full_ns/tick", "bank_ns/active");
+    for (unsigned int r = 0; r < BENCH_RATIOS; r++) {
+        ProtectionOverloadBank bank;
+        ProtectionOverload_BankInit(&bank, params, channels, ProtectionOverload_SM_GetCallRate(), &storage);
+        for (unsigned int i = 0; i < channels; i++) {
+            ProtectionOverload_Init(&sm[i], &params[i], ProtectionOverload_SM_GetCallRate());
+            currents[i] = ((i * 2654435761u) % 1000u < bench_ratios[r]) ? 1.5f : 0.5f;
+        }
+
+        double start = Bench_NowNs();
+        for (unsigned int t = 0; t < ticks; t++) {
+            ProtectionOverload_BankRun(&bank, currents);
+        }
+        double bank_ns = (Bench_NowNs() - start) / ticks;
+
+        start = Bench_NowNs();
+        for (unsigned int t = 0; t < ticks; t++) {
+            for (unsigned int i = 0; i < channels; i++) {
+                ProtectionOverload_Run(&sm[i], currents[i]);
+            }
+        }
+        double full_ns = (Bench_NowNs() - start) / ticks;
+
+        unsigned int active_count = ProtectionOverload_BankGetActiveCount(&bank);
+        char ratio[16];
+        snprintf(ratio, sizeof(ratio), "%.1f%%", bench_ratios[r] / 10.0);
+        printf("%-8s %10u %14.0f %14.0f %14.2f\n", ratio, channels, bank_ns, full_ns,
+               active_count ? bank_ns / active_count : 0.0);
+    }
+
+    free(params);
+    free(currents);
+    free(pickup_current);
+    free(channel);
+    free(armed);
+    free(active);
+    free(sm);
+    return 0;
+}
@@ -0,0 +1,155 @@
+// Channel State Layout Benchmark
+//
+// Throughput of a fleet of channels against its size, from L1-resident to
+// DRAM-resident working sets. Before: one ProtectionOverloadSM per channel,
+// every field of the instance is loaded each tick. After: the bank with its
+// storage carved from one pooled block (hot arrays first, cache-line aligned),
+// where an idle channel costs its current, pickup level and armed bit, and
+// only active channels touch their 8-byte record and their parameters.
+//
+// Both layouts are measured with all channels idle (below pickup) and all
+// channels heating (worst case for the bank: every record and parameter set
+// is read). huge=1 backs the blocks with huge pages when available.
+//
+//   bench_protection_overload_layout [max_channels] [huge=0|1]
+
+#if defined(__linux__)
+#define _DEFAULT_SOURCE                 // sysconf cache sizes
+#include <unistd.h>
+#endif
+
+#include "protection_overload.h"
+#include "protection_overload_bank.h"
+#include "protection_overload_pool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_MAX_CHANNELS  (1u << 22)  // Default largest fleet
+#define BENCH_MIN_CHANNELS  (1u << 8)   // Smallest fleet
+#define BENCH_CHANNEL_TICKS (1u << 24)  // Channel evaluations per measurement
+
+// Heating channels never trip during the run (t_trip > 10^5 s)
+static const ProtectionOverloadParams bench_params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1e6f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+// Not used: currents are passed to the engines
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static double Bench_NowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Data cache size of a level [bytes] (typical sizes if not reported)
+static double Bench_CacheSize(int level) {
+    long size = 0;
+#if defined(_SC_LEVEL1_DCACHE_SIZE)
+    size = sysconf(level == 1 ? _SC_LEVEL1_DCACHE_SIZE : level == 2 ? _SC_LEVEL2_CACHE_SIZE : _SC_LEVEL3_CACHE_SIZE);
+#endif
+    if (size > 0) {
+        return (double)size;
+    }
+    return (level == 1) ? 32768.0 : (level == 2) ? 1048576.0 : 8388608.0;
+}
+
+static const char *Bench_Pages(ProtectionOverloadPoolPages pages) {
+    return (pages == POOL_PAGES_HUGETLB) ? "hugetlb" : (pages == POOL_PAGES_TRANSPARENT) ? "transparent huge" : "normal";
+}
+
+// Per tick, ns per channel: one instance per channel
+static double Bench_Instances(ProtectionOverloadSM *sm, const float *currents, unsigned int channels, unsigned int ticks) {
+    for (unsigned int i = 0; i < channels; i++) {
+        ProtectionOverload_Init(&sm[i], &bench_params, ProtectionOverload_SM_GetCallRate());
+        ProtectionOverload_Run(&sm[i], currents[i]);
+    }
+    double start = Bench_NowNs();
+    for (unsigned int t = 0; t < ticks; t++) {
+        for (unsigned int i = 0; i < channels; i++) {
+            ProtectionOverload_Run(&sm[i], currents[i]);
+        }
+    }
+    return (Bench_NowNs() - start) / ((double)ticks * channels);
+}
+
+// Per tick, ns per channel: bank with pooled storage
+static double Bench_Bank(const ProtectionOverloadParams *params, const ProtectionOverloadBankStorage *storage,
+                         const float *currents, unsigned int channels, unsigned int ticks) {
+    ProtectionOverloadBank bank;
+    ProtectionOverload_BankInit(&bank, params, channels, ProtectionOverload_SM_GetCallRate(), storage);
+    ProtectionOverload_BankRun(&bank, currents);
+    double start = Bench_NowNs();
+    for (unsigned int t = 0; t < ticks; t++) {
+        ProtectionOverload_BankRun(&bank, currents);
+    }
+    return (Bench_NowNs() - start) / ((double)ticks * channels);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int max_channels = (argc > 1) ? (unsigned int)strtoul(argv[1], NULL, 10) : BENCH_MAX_CHANNELS;
+    bool huge_pages = (argc > 2) && strcmp(argv[2], "huge=1") == 0;
+    if (max_channels < BENCH_MIN_CHANNELS) max_channels = BENCH_MIN_CHANNELS;
+
+    // Blocks for the largest fleet, reused by the smaller ones
+    ProtectionOverloadPool sm_pool, bank_pool, cold_pool;
+    if (!ProtectionOverload_PoolAlloc(&sm_pool, max_channels * sizeof(ProtectionOverloadSM), huge_pages) ||
+        !ProtectionOverload_PoolAlloc(&bank_pool, ProtectionOverload_BankStorageSize(max_channels), huge_pages) ||
+        !ProtectionOverload_PoolAlloc(&cold_pool, max_channels * (sizeof(ProtectionOverloadParams) + 2u * sizeof(float)), huge_pages)) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    ProtectionOverloadSM *sm = sm_pool.base;
+    ProtectionOverloadParams *params = cold_pool.base;
+    float *idle = (float *)(params + max_channels);
+    float *heating = idle + max_channels;
+    for (unsigned int i = 0; i < max_channels; i++) {
+        params[i] = bench_params;
+        idle[i] = 0.5f;
+        heating[i] = 1.5f;
+    }
+
+    // Bytes loaded per channel and tick, channels resident in each cache level
+    double bitmaps = 2.0 / 8.0;
+    double bytes[3] = {
+        sizeof(ProtectionOverloadSM) + sizeof(float),
+        2.0 * sizeof(float) + bitmaps,
+        2.0 * sizeof(float) + bitmaps + sizeof(ProtectionOverloadBankChannel) + sizeof(ProtectionOverloadParams)
+    };
+    const char *names[3] = {"instances", "bank idle", "bank heating"};
+    printf("Pages: %s, caches L1 %.0f KB, L2 %.0f KB, LLC %.0f KB\n", Bench_Pages(bank_pool.pages),
+           Bench_CacheSize(1) / 1024.0, Bench_CacheSize(2) / 1024.0, Bench_CacheSize(3) / 1024.0);
+    printf("%-14s %12s %12s %12s %12s\n", "layout", "bytes/ch", "L1_channels", "L2_channels", "LLC_channels");
+    for (int l = 0; l < 3; l++) {
+        printf("%-14s %12.2f %12.0f %12.0f %12.0f\n", names[l], bytes[l],
+               Bench_CacheSize(1) / bytes[l], Bench_CacheSize(2) / bytes[l], Bench_CacheSize(3) / bytes[l]);
+    }
+
+    printf("\nns per channel and tick\n%10s %12s %12s %12s %12s\n", "channels", "inst_idle", "inst_heat", "bank_idle", "bank_heat");
+    for (unsigned int channels = BENCH_MIN_CHANNELS; channels <= max_channels; channels *= 4u) {
+        unsigned int ticks = BENCH_CHANNEL_TICKS / channels;
+        if (ticks < 4u) ticks = 4u;
+
+        ProtectionOverloadBankStorage storage;
+        ProtectionOverload_BankStorageInit(&storage, bank_pool.base, channels);
+
+        double inst_idle = Bench_Instances(sm, idle, channels, ticks);
+        double inst_heat = Bench_Instances(sm, heating, channels, ticks);
+        double bank_idle = Bench_Bank(params, &storage, idle, channels, ticks);
+        double bank_heat = Bench_Bank(params, &storage, heating, channels, ticks);
+        printf("%10u %12.2f %12.2f %12.2f %12.2f\n", channels, inst_idle, inst_heat, bank_idle, bank_heat);
+    }
+
+    ProtectionOverload_PoolFree(&sm_pool);
+    ProtectionOverload_PoolFree(&bank_pool);
+    ProtectionOverload_PoolFree(&cold_pool);
+    return 0;
+}
@@ -0,0 +1,609 @@
+// COMTRADE (IEEE C37.111) Reader
+//
+// The .cfg file is small and parsed into a ComtradeRecord. The .dat file is
+// memory-mapped and decoded sample-by-sample through a cursor, so replaying a
+// multi-GB record never copies it into the heap.
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "comtrade.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define CFG_MAX_SIZE    (256u * 1024u)  // Max accepted .cfg size [bytes]
+#define CFG_MAX_FIELDS  16              // Max comma separated fields per .cfg line
+
+/* ------------------------------------------------
+        Configuration file parsing
+   ------------------------------------------------ */
+
+// Line tokenizer over a NUL-terminated buffer (modified in place)
+typedef struct {
+    char *next;
+} CfgReader;
+
+// Return next line (CR/LF stripped) or NULL at end of buffer
+static char *Cfg_NextLine(CfgReader *reader) {
+    char *line = reader->next;
+    if (line == NULL || *line == '\0') {
+        return NULL;
+    }
+
+    char *eol = line + strcspn(line, "\r\n");
+    if (*eol == '\0') {
+        reader->next = eol;
+    } else {
+        char *next = eol + 1;
+        if (*eol == '\r' && *next == '\n') {
+            next++;
+        }
+        *eol = '\0';
+        reader->next = next;
+    }
+    return line;
+}
+
+// Split a line on commas, return number of fields
+static unsigned int Cfg_Split(char *line, char *fields[], unsigned int max_fields) {
+    unsigned int count = 0;
+    char *field = line;
+
+    while (count < max_fields) {
+        fields[count++] = field;
+        char *comma = strchr(field, ',');
+        if (comma == NULL) {
+            break;
+        }
+        *comma = '\0';
+        field = comma + 1;
+    }
+
+    // Trim surrounding blanks
+    for (unsigned int i = 0; i < count; i++) {
+        while (*fields[i] == ' ' || *fields[i] == '\t') {
+            fields[i]++;
+        }
+        size_t len = strlen(fields[i]);
+        while (len > 0 && (fields[i][len - 1] == ' ' || fields[i][len - 1] == '\t')) {
+            fields[i][--len] = '\0';
+        }
+    }
+    return count;
+}
+
+static void Cfg_CopyString(char *dst, size_t size, const char *src) {
+    strncpy(dst, src, size - 1);
+    dst[size - 1] = '\0';
+}
+
+static ComtradeResult Cfg_Parse(ComtradeRecord *rec, char *text) {
+    CfgReader reader = {.next = text};
+    char *fields[CFG_MAX_FIELDS];
+    char *line;
+
+    // Station name, recording device id, revision year
+    if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+    unsigned int n = Cfg_Split(line, fields, CFG_MAX_FIELDS);
+    Cfg_CopyString(rec->station, sizeof(rec->station), fields[0]);
+    rec->rev_year = (n >= 3) ? (unsigned int)strtoul(fields[2], NULL, 10) : 1991u;
+
+    // Channel counts: TT,##A,##D
+    if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+    if (Cfg_Split(line, fields, CFG_MAX_FIELDS) < 3) return COMTRADE_ERR_CFG;
+    rec->analog_count = (unsigned int)strtoul(fields[1], NULL, 10);
+    rec->digital_count = (unsigned int)strtoul(fields[2], NULL, 10);
+    if (rec->analog_count > COMTRADE_MAX_ANALOG) return COMTRADE_ERR_CFG;
+
+    // Analog channels: An,ch_id,ph,ccbm,uu,a,b,skew,min,max[,primary,secondary,PS]
+    for (unsigned int i = 0; i < rec->analog_count; i++) {
+        if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+        n = Cfg_Split(line, fields, CFG_MAX_FIELDS);
+        if (n < 10) return COMTRADE_ERR_CFG;
+
+        ComtradeAnalogChannel *ch = &rec->analog[i];
+        Cfg_CopyString(ch->name, sizeof(ch->name), fields[1]);
+        Cfg_CopyString(ch->unit, sizeof(ch->unit), fields[4]);
+        ch->a = strtof(fields[5], NULL);
+        ch->b = strtof(fields[6], NULL);
+        ch->primary = (n >= 13) ? strtof(fields[10], NULL) : 1.0f;
+        ch->secondary = (n >= 13) ? strtof(fields[11], NULL) : 1.0f;
+        ch->is_primary = (n >= 13) ? (fields[12][0] == 'P' || fields[12][0] == 'p') : true;
+    }
+
+    // Digital channels (not decoded)
+    for (unsigned int i = 0; i < rec->digital_count; i++) {
+        if (Cfg_NextLine(&reader) == NULL) return COMTRADE_ERR_CFG;
+    }
+
+    // Line frequency
+    if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+    rec->line_freq = strtof(line, NULL);
+
+    // Sampling rates: a single rate is replayed by index, multiple rates by timestamp
+    if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+    unsigned int nrates = (unsigned int)strtoul(line, NULL, 10);
+    rec->sample_rate = 0.0f;
+    rec->sample_count = 0;
+    for (unsigned int i = 0; i < (nrates == 0 ? 1u : nrates); i++) {
+        if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+        if (Cfg_Split(line, fields, CFG_MAX_FIELDS) < 2) return COMTRADE_ERR_CFG;
+        if (i == 0) {
+            rec->sample_rate = strtof(fields[0], NULL);
+        }
+        rec->sample_count = (uint32_t)strtoul(fields[1], NULL, 10);
+    }
+    if (nrates != 1) {
+        rec->sample_rate = 0.0f;
+    }
+
+    // Start and trigger date/time (not used for replay)
+    if (Cfg_NextLine(&reader) == NULL) return COMTRADE_ERR_CFG;
+    if (Cfg_NextLine(&reader) == NULL) return COMTRADE_ERR_CFG;
+
+    // Data file type
+    if ((line = Cfg_NextLine(&reader)) == NULL) return COMTRADE_ERR_CFG;
+    Cfg_Split(line, fields, CFG_MAX_FIELDS);
+    if (strcmp(fields[0], "ASCII") == 0 || strcmp(fields[0], "ascii") == 0) {
+        rec->format = COMTRADE_ASCII;
+    } else if (strcmp(fields[0], "BINARY") == 0 || strcmp(fields[0], "binary") == 0) {
+        rec->format = COMTRADE_BINARY;
+    } else if (strcmp(fields[0], "BINARY32") == 0 || strcmp(fields[0], "binary32") == 0) {
+        rec->format = COMTRADE_BINARY32;
+    } else if (strcmp(fields[0], "FLOAT32") == 0 || strcmp(fields[0], "float32") == 0) {
+        rec->format = COMTRADE_FLOAT32;
+    } else {
+        return COMTRADE_ERR_CFG;
+    }
+
+    // Time stamp multiplier (optional before 1999)
+    rec->timemult = 1.0;
+    if ((line = Cfg_NextLine(&reader)) != NULL && *line != '\0') {
+        rec->timemult = strtod(line, NULL);
+        if (rec->timemult <= 0.0) rec->timemult = 1.0;
+    }
+
+    return COMTRADE_OK;
+}
+
+static ComtradeResult Cfg_Load(ComtradeRecord *rec, const char *cfg_path) {
+    FILE *file = fopen(cfg_path, "rb");
+    if (file == NULL) {
+        return COMTRADE_ERR_IO;
+    }
+
+    char *text = malloc(CFG_MAX_SIZE + 1);
+    if (text == NULL) {
+        fclose(file);
+        return COMTRADE_ERR_IO;
+    }
+
+    size_t size = fread(text, 1, CFG_MAX_SIZE, file);
+    fclose(file);
+    text[size] = '\0';
+
+    ComtradeResult result = Cfg_Parse(rec, text);
+    free(text);
+    return result;
+}
+
+/* ------------------------------------------------
+        Data file mapping
+   ------------------------------------------------ */
+
+#if defined(_WIN32)
+
+static ComtradeResult Dat_Map(ComtradeRecord *rec, const char *dat_path) {
+    HANDLE file = CreateFileA(dat_path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return COMTRADE_ERR_IO;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return COMTRADE_ERR_DAT;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        return COMTRADE_ERR_IO;
+    }
+
+    const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (data == NULL) {
+        CloseHandle(mapping);
+        return COMTRADE_ERR_IO;
+    }
+
+    rec->data = data;
+    rec->data_size = (size_t)size.QuadPart;
+    rec->map_handle = mapping;
+    return COMTRADE_OK;
+}
+
+static void Dat_Unmap(ComtradeRecord *rec) {
+    UnmapViewOfFile(rec->data);
+    CloseHandle((HANDLE)rec->map_handle);
+}
+
+#else
+
+static ComtradeResult Dat_Map(ComtradeRecord *rec, const char *dat_path) {
+    int fd = open(dat_path, O_RDONLY);
+    if (fd < 0) {
+        return COMTRADE_ERR_IO;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return COMTRADE_ERR_DAT;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return COMTRADE_ERR_IO;
+    }
+
+    // Replay is a single forward pass: let the kernel read ahead aggressively
+    posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+
+    rec->data = data;
+    rec->data_size = (size_t)st.st_size;
+    rec->map_handle = NULL;
+    return COMTRADE_OK;
+}
+
+static void Dat_Unmap(ComtradeRecord *rec) {
+    munmap((void *)rec->data, rec->data_size);
+}
+
+#endif
+
+/* ------------------------------------------------
+        Record API
+   ------------------------------------------------ */
+
+// Open a record: parse .cfg and memory-map .dat
+ComtradeResult Comtrade_Open(ComtradeRecord *rec, const char *cfg_path, const char *dat_path) {
+    memset(rec, 0, sizeof(*rec));
+
+    ComtradeResult result = Cfg_Load(rec, cfg_path);
+    if (result != COMTRADE_OK) {
+        return result;
+    }
+
+    // Fixed binary record size: sample number, timestamp, analogs, digital words
+    size_t analog_size = (rec->format == COMTRADE_BINARY) ? 2u : 4u;
+    if (rec->format != COMTRADE_ASCII) {
+        rec->record_size = 8u + rec->analog_count * analog_size + 2u * ((rec->digital_count + 15u) / 16u);
+    }
+
+    result = Dat_Map(rec, dat_path);
+    if (result != COMTRADE_OK) {
+        return result;
+    }
+
+    // Derive sample count from file size when .cfg does not declare it
+    if (rec->record_size != 0) {
+        uint32_t available = (uint32_t)(rec->data_size / rec->record_size);
+        if (rec->sample_count == 0 || rec->sample_count > available) {
+            rec->sample_count = available;
+        }
+    }
+    return COMTRADE_OK;
+}
+
+// Release mapped data file
+void Comtrade_Close(ComtradeRecord *rec) {
+    if (rec->data != NULL) {
+        Dat_Unmap(rec);
+    }
+    rec->data = NULL;
+    rec->data_size = 0;
+}
+
+/* ------------------------------------------------
+        Sample decoding
+   ------------------------------------------------ */
+
+// Little-endian loads (COMTRADE binary files are little-endian)
+static inline uint32_t Dat_LoadU32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline int16_t Dat_LoadI16(const uint8_t *p) {
+    return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+// Bounded decimal parser for ASCII fields (mapped data is not NUL-terminated)
+// Returns false for an empty field (missing value)
+static bool Dat_ParseNumber(const uint8_t **pp, const uint8_t *end, double *value) {
+    const uint8_t *p = *pp;
+    double mantissa = 0.0;
+    double scale = 1.0;
+    int exponent = 0;
+    bool negative = false;
+    bool digits = false;
+
+    while (p < end && (*p == ' ' || *p == '\t')) p++;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = (*p == '-');
+        p++;
+    }
+    while (p < end && *p >= '0' && *p <= '9') {
+        mantissa = mantissa * 10.0 + (*p++ - '0');
+        digits = true;
+    }
+    if (p < end && *p == '.') {
+        p++;
+        while (p < end && *p >= '0' && *p <= '9') {
+            mantissa = mantissa * 10.0 + (*p++ - '0');
+            scale *= 10.0;
+            digits = true;
+        }
+    }
+    if (digits && p < end && (*p == 'e' || *p == 'E')) {
+        bool exp_negative = false;
+        p++;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = (*p == '-');
+            p++;
+        }
+        while (p < end && *p >= '0' && *p <= '9') {
+            exponent = exponent * 10 + (*p++ - '0');
+        }
+        if (exp_negative) exponent = -exponent;
+    }
+
+    // Skip to field separator
+    while (p < end && *p != ',' && *p != '\n' && *p != '\r') p++;
+    *pp = p;
+
+    if (!digits) {
+        return false;
+    }
+    double result = mantissa / scale;
+    if (exponent != 0) {
+        result *= pow(10.0, exponent);
+    }
+    *value = negative ? -result : result;
+    return true;
+}
+
+static ComtradeResult Dat_NextAscii(ComtradeCursor *cursor, double *timestamp, double *raw) {
+    const ComtradeRecord *rec = cursor->rec;
+    const uint8_t *p = rec->data + cursor->offset;
+    const uint8_t *end = rec->data + rec->data_size;
+
+    // Skip blank lines
+    while (p < end && (*p == '\n' || *p == '\r' || *p == ' ')) p++;
+    if (p >= end) {
+        return COMTRADE_END;
+    }
+
+    // Sample number, timestamp, then analog channels
+    double value = 0.0;
+    unsigned int fields = 2u + rec->analog_count;
+    for (unsigned int i = 0; i < fields; i++) {
+        if (i > 0) {
+            if (p >= end || *p != ',') return COMTRADE_ERR_DAT;
+            p++;
+        }
+
+        bool present = Dat_ParseNumber(&p, end, &value);
+        if (i == 1) {
+            *timestamp = present ? value : -1.0;
+        } else if (i >= 2) {
+            // 99999 marks a missing ASCII sample
+            raw[i - 2] = (present && value != 99999.0) ? value : NAN;
+        }
+    }
+
+    // Skip digital channels to end of line
+    while (p < end && *p != '\n') p++;
+    cursor->offset = (size_t)(p - rec->data);
+    return COMTRADE_OK;
+}
+
+static void Dat_DecodeBinary(const ComtradeRecord *rec, const uint8_t *sample, unsigned int channel, double *raw) {
+    const uint8_t *p = sample + 8u;
+    switch (rec->format) {
+        case COMTRADE_BINARY: {
+            int16_t v = Dat_LoadI16(p + 2u * channel);
+            *raw = (v == INT16_MIN) ? NAN : (double)v;
+            break;
+        }
+        case COMTRADE_BINARY32: {
+            int32_t v = (int32_t)Dat_LoadU32(p + 4u * channel);
+            *raw = (v == INT32_MIN) ? NAN : (double)v;
+            break;
+        }
+        case COMTRADE_FLOAT32: {
+            uint32_t bits = Dat_LoadU32(p + 4u * channel);
+            float v;
+            memcpy(&v, &bits, sizeof(v));
+            *raw = v;
+            break;
+        }
+        default:
+            *raw = NAN;
+            break;
+    }
+}
+
+/* ------------------------------------------------
+        Cursor API
+   ------------------------------------------------ */
+
+void Comtrade_CursorInit(ComtradeCursor *cursor, const ComtradeRecord *rec) {
+    cursor->rec = rec;
+    cursor->offset = 0;
+    cursor->index = 0;
+    cursor->last_time_sec = 0.0;
+    cursor->last_step_sec = 0.0;
+}
+
+// Decode the next sample of the selected channels, scaled as value = a * raw + b
+// Missing samples are returned as NaN
+ComtradeResult Comtrade_CursorNext(ComtradeCursor *cursor, double *time_sec,
+                                   const unsigned int *channels, unsigned int channel_count,
+                                   float *values) {
+    const ComtradeRecord *rec = cursor->rec;
+    double timestamp = -1.0;
+
+    for (unsigned int i = 0; i < channel_count; i++) {
+        if (channels[i] >= rec->analog_count) return COMTRADE_ERR_ARG;
+    }
+
+    if (rec->format == COMTRADE_ASCII) {
+        double raw[COMTRADE_MAX_ANALOG];
+        ComtradeResult result = Dat_NextAscii(cursor, &timestamp, raw);
+        if (result != COMTRADE_OK) {
+            return result;
+        }
+        for (unsigned int i = 0; i < channel_count; i++) {
+            const ComtradeAnalogChannel *ch = &rec->analog[channels[i]];
+            values[i] = (float)(ch->a * raw[channels[i]] + ch->b);
+        }
+    } else {
+        if (cursor->index >= rec->sample_count) {
+            return COMTRADE_END;
+        }
+        const uint8_t *sample = rec->data + cursor->offset;
+        // 0xFFFFFFFF marks a missing binary timestamp
+        uint32_t stamp = Dat_LoadU32(sample + 4u);
+        timestamp = (stamp == 0xFFFFFFFFu) ? -1.0 : (double)stamp;
+        for (unsigned int i = 0; i < channel_count; i++) {
+            const ComtradeAnalogChannel *ch = &rec->analog[channels[i]];
+            double raw;
+            Dat_DecodeBinary(rec, sample, channels[i], &raw);
+            values[i] = (float)(ch->a * raw + ch->b);
+        }
+        cursor->offset += rec->record_size;
+    }
+
+    // Sample time: fixed rate by index, otherwise timestamp [us] * timemult
+    // (a missing timestamp continues the last sample interval)
+    if (rec->sample_rate > 0.0f) {
+        *time_sec = cursor->index / (double)rec->sample_rate;
+    } else if (timestamp < 0.0) {
+        *time_sec = cursor->last_time_sec + cursor->last_step_sec;
+    } else {
+        *time_sec = timestamp * rec->timemult * 1e-6;
+        if (cursor->index > 0) {
+            cursor->last_step_sec = *time_sec - cursor->last_time_sec;
+        }
+    }
+    cursor->last_time_sec = *time_sec;
+    cursor->index++;
+    return COMTRADE_OK;
+}
+
+/* ------------------------------------------------
+        Replay API
+   ------------------------------------------------ */
+
+ComtradeResult Comtrade_ReplayInit(ComtradeReplay *replay, const ComtradeRecord *rec,
+                                   const unsigned int *channels, unsigned int channel_count,
+                                   ComtradeSide side, float period_sec) {
+    if (channel_count == 0 || channel_count > COMTRADE_MAX_ANALOG || period_sec <= 0.0f ||
+        (unsigned int)side > COMTRADE_SIDE_SECONDARY) {
+        return COMTRADE_ERR_ARG;
+    }
+    for (unsigned int i = 0; i < channel_count; i++) {
+        if (channels[i] >= rec->analog_count) return COMTRADE_ERR_ARG;
+    }
+
+    memset(replay, 0, sizeof(*replay));
+
+    // Side conversion: channels recorded on the other side are scaled by their transformer ratio
+    for (unsigned int i = 0; i < channel_count; i++) {
+        const ComtradeAnalogChannel *ch = &rec->analog[channels[i]];
+        replay->scale[i] = 1.0f;
+        if ((side == COMTRADE_SIDE_PRIMARY && !ch->is_primary) || (side == COMTRADE_SIDE_SECONDARY && ch->is_primary)) {
+            if (ch->primary <= 0.0f || ch->secondary <= 0.0f) {
+                return COMTRADE_ERR_CFG;
+            }
+            replay->scale[i] = (side == COMTRADE_SIDE_PRIMARY) ? ch->primary / ch->secondary : ch->secondary / ch->primary;
+        }
+    }
+    Comtrade_CursorInit(&replay->cursor, rec);
+    replay->channels = channels;
+    replay->channel_count = channel_count;
+    replay->period_sec = period_sec;
+
+    // Prime first sample: windows are aligned to the record start
+    ComtradeResult result = Comtrade_CursorNext(&replay->cursor, &replay->pending_time_sec,
+                                                channels, channel_count, replay->pending_values);
+    if (result != COMTRADE_OK) {
+        return result;
+    }
+    replay->pending = true;
+    replay->window_end_sec = replay->pending_time_sec + period_sec;
+    return COMTRADE_OK;
+}
+
+// Produce the current for the next protection call: RMS of each selected channel (on the selected side)
+// over one call period, max among channels (the engine protects on the worst phase)
+// Windows without samples (record slower than call rate) hold the previous value
+ComtradeResult Comtrade_ReplayNext(ComtradeReplay *replay, float *current) {
+    double sum_sq[COMTRADE_MAX_ANALOG] = {0};
+    unsigned int count[COMTRADE_MAX_ANALOG] = {0};
+    bool any = false;
+
+    if (!replay->pending) {
+        return COMTRADE_END;
+    }
+
+    while (replay->pending && replay->pending_time_sec < replay->window_end_sec) {
+        for (unsigned int i = 0; i < replay->channel_count; i++) {
+            float v = replay->pending_values[i];
+            if (!isnan(v)) {
+                sum_sq[i] += (double)v * v;
+                count[i]++;
+            }
+        }
+        any = true;
+
+        ComtradeResult result = Comtrade_CursorNext(&replay->cursor, &replay->pending_time_sec,
+                                                    replay->channels, replay->channel_count,
+                                                    replay->pending_values);
+        if (result == COMTRADE_END) {
+            replay->pending = false;
+        } else if (result != COMTRADE_OK) {
+            return result;
+        }
+    }
+    replay->window_end_sec += replay->period_sec;
+
+    if (any) {
+        float max_rms = 0.0f;
+        for (unsigned int i = 0; i < replay->channel_count; i++) {
+            if (count[i] > 0) {
+                float rms = (float)sqrt(sum_sq[i] / count[i]) * replay->scale[i];
+                if (rms > max_rms) max_rms = rms;
+            }
+        }
+        replay->last_current = max_rms;
+    }
+
+    *current = replay->last_current;
+    return COMTRADE_OK;
+}
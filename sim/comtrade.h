@@ -0,0 +1,106 @@
+// COMTRADE (IEEE C37.111) Reader Header
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMTRADE_MAX_ANALOG     64      // Max analog channels per record
+#define COMTRADE_MAX_NAME       64      // Max channel / station name length
+#define COMTRADE_MAX_UNIT       16      // Max channel unit length
+
+// Return codes
+typedef enum {
+    COMTRADE_OK = 0,
+    COMTRADE_END,                       // No more samples in data file
+    COMTRADE_ERR_IO,                    // File not found / cannot be mapped
+    COMTRADE_ERR_CFG,                   // Malformed configuration file
+    COMTRADE_ERR_DAT,                   // Malformed or truncated data file
+    COMTRADE_ERR_ARG                    // Invalid argument (e.g. channel index)
+} ComtradeResult;
+
+// Data file formats
+typedef enum {
+    COMTRADE_ASCII,
+    COMTRADE_BINARY,                    // int16 analog samples
+    COMTRADE_BINARY32,                  // int32 analog samples
+    COMTRADE_FLOAT32                    // IEEE-754 float analog samples
+} ComtradeFormat;
+
+// Side of the instrument transformers the replayed currents refer to
+typedef enum {
+    COMTRADE_SIDE_RECORDED = 0,         // As written in the record (P or S per channel)
+    COMTRADE_SIDE_PRIMARY,              // Primary values (secondary channels x primary / secondary)
+    COMTRADE_SIDE_SECONDARY             // Secondary values (primary channels x secondary / primary)
+} ComtradeSide;
+
+// Analog channel description (from .cfg)
+typedef struct {
+    char name[COMTRADE_MAX_NAME];       // Channel identifier
+    char unit[COMTRADE_MAX_UNIT];       // Channel units (e.g. "A", "kA")
+    float a;                            // Multiplier: value = a * raw + b
+    float b;                            // Offset
+    float primary;                      // VT/CT primary ratio factor
+    float secondary;                    // VT/CT secondary ratio factor
+    bool is_primary;                    // Scaled values are primary (P) or secondary (S)
+} ComtradeAnalogChannel;
+
+// COMTRADE record (configuration + memory-mapped data file)
+typedef struct {
+    char station[COMTRADE_MAX_NAME];    // Station name
+    unsigned int rev_year;              // Standard revision year (1991 if missing)
+    ComtradeFormat format;              // Data file format
+    unsigned int analog_count;          // Number of analog channels
+    unsigned int digital_count;         // Number of digital channels
+    ComtradeAnalogChannel analog[COMTRADE_MAX_ANALOG];
+    float line_freq;                    // Nominal line frequency [Hz]
+    float sample_rate;                  // Sampling rate [Hz] (0 = use timestamps)
+    uint32_t sample_count;              // Number of samples declared in .cfg
+    double timemult;                    // Timestamp multiplier [us per unit]
+
+    // Memory-mapped data file
+    const uint8_t *data;                // Mapped data file
+    size_t data_size;                   // Mapped data size [bytes]
+    size_t record_size;                 // Binary record size [bytes] (0 for ASCII)
+    void *map_handle;                   // Platform mapping handle
+} ComtradeRecord;
+
+// Sequential sample cursor over a mapped record
+typedef struct {
+    const ComtradeRecord *rec;
+    size_t offset;                      // Byte offset of next sample
+    uint32_t index;                     // Index of next sample
+    double last_time_sec;               // Time of the last sample [s]
+    double last_step_sec;               // Last sample interval [s] (missing timestamps)
+} ComtradeCursor;
+
+// Replay of a record into a periodic protection task
+typedef struct {
+    ComtradeCursor cursor;
+    const unsigned int *channels;       // Selected analog channels (e.g. phase currents)
+    unsigned int channel_count;         // Number of selected channels
+    float scale[COMTRADE_MAX_ANALOG];   // Side conversion factor of each selected channel
+    float period_sec;                   // Protection call rate [s]
+    double window_end_sec;              // End time of current evaluation window [s]
+    bool pending;                       // A decoded sample is waiting for next window
+    double pending_time_sec;            // Time of pending sample [s]
+    float pending_values[COMTRADE_MAX_ANALOG];
+    float last_current;                 // Last produced current (held on empty windows)
+} ComtradeReplay;
+
+// Record API
+ComtradeResult Comtrade_Open(ComtradeRecord *rec, const char *cfg_path, const char *dat_path);
+void Comtrade_Close(ComtradeRecord *rec);
+
+// Cursor API
+void Comtrade_CursorInit(ComtradeCursor *cursor, const ComtradeRecord *rec);
+ComtradeResult Comtrade_CursorNext(ComtradeCursor *cursor, double *time_sec,
+                                   const unsigned int *channels, unsigned int channel_count,
+                                   float *values);
+
+// Replay API
+ComtradeResult Comtrade_ReplayInit(ComtradeReplay *replay, const ComtradeRecord *rec,
+                                   const unsigned int *channels, unsigned int channel_count,
+                                   ComtradeSide side, float period_sec);
+ComtradeResult Comtrade_ReplayNext(ComtradeReplay *replay, float *current);
@@ -0,0 +1,458 @@
+// Event-Driven Fleet Simulation
+//
+// Long-term coordination study of a large installation: every breaker sees a
+// piecewise-constant load (random segments, occasional overloads) and its
+// energy follows the closed-form engine model within a segment (linear
+// heating above pickup at 1 / t_trip, linear cooling below). The next trip of
+// a heating breaker is therefore known analytically. Each breaker has exactly
+// one pending event (load change, predicted trip or reclose after repair),
+// kept in a hashed timing wheel per worker: only these events are processed,
+// never the 10 ms ticks in between. An open breaker cools in closed form, so
+// the end of its reset lockout is known at the trip and folded into the
+// reclose time. Breakers are independent, so events of
+// different breakers within one wheel slot need no ordering: insert and
+// removal are O(1), where a heap of 100k pending events costs a cache-missing
+// sift per event.
+//
+// verify=1 also steps every breaker tick by tick through ProtectionOverload_Run
+// with the same load segments (use a small fleet and horizon). The first trip
+// of each breaker must match within two ticks plus tol relative to the trip
+// time (float accumulation of the engine); later trips follow recloses that are
+// shifted by up to one tick and by the engine float accumulation (cooling
+// decrements of a few ulps), so only the total number of trips is compared
+// for them, within tripdiff.
+//
+//   fleet [key=value ...]
+//     breakers=100000 number of breakers
+//     hours=87600     simulated time [h] (default 10 years)
+//     change=3600     mean load segment duration [s]
+//     overload=0.002  probability of an overload segment
+//     repair=3600     open time after a trip [s]
+//     lockout=0       reclose locked out until the thermal image has cooled to this energy (0: none)
+//     rate=0.01       engine call rate for verify [s]
+//     verify=0        1 = compare with tick-by-tick engine
+//     tol=2e-3        verify first trip time tolerance (relative, + 2 ticks)
+//     tripdiff=0.01   verify total trips tolerance (relative)
+//     seed=1          master seed
+//     threads=N       worker threads (default: all CPUs)
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "protection_overload.h"
+#include "protection_overload_curve.h"
+#include "sim_random.h"
+#include "sim_threads.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Breakers are driven through the instance API: no sensor is read
+float Sensor_Read() {
+    return 0.0f;
+}
+
+/* ------------------------------------------------
+        Study configuration
+   ------------------------------------------------ */
+
+typedef struct {
+    uint32_t breakers;                  // Number of breakers
+    double horizon_sec;                 // Simulated time [s]
+    double change_sec;                  // Mean load segment duration [s]
+    float overload_probability;         // Probability of an overload segment
+    double repair_sec;                  // Open time after a trip [s]
+    float lockout_energy;               // Reset lockout energy (0: none)
+    float call_rate_sec;                // Engine call rate (verify) [s]
+    bool verify;                        // Compare with tick-by-tick engine
+    double tolerance;                   // Verify first trip time tolerance (relative, + 2 ticks)
+    double trip_tolerance;              // Verify total trips tolerance (relative)
+    uint64_t seed;
+    unsigned int threads;
+} FleetConfig;
+
+static int Fleet_ParseArgs(FleetConfig *cfg, int argc, char *argv[]) {
+    *cfg = (FleetConfig){
+        .breakers = 100000, .horizon_sec = 87600.0 * 3600.0, .change_sec = 3600.0,
+        .overload_probability = 0.002f, .repair_sec = 3600.0, .call_rate_sec = 0.01f,
+        .verify = false, .tolerance = 2e-3, .trip_tolerance = 0.01, .seed = 1,
+        .threads = SimThreads_CpuCount()
+    };
+
+    for (int i = 1; i < argc; i++) {
+        char *value = strchr(argv[i], '=');
+        if (value == NULL) return -1;
+        *value++ = '\0';
+        if (strcmp(argv[i], "breakers") == 0) cfg->breakers = (uint32_t)strtoul(value, NULL, 10);
+        else if (strcmp(argv[i], "hours") == 0) cfg->horizon_sec = strtod(value, NULL) * 3600.0;
+        else if (strcmp(argv[i], "change") == 0) cfg->change_sec = strtod(value, NULL);
+        else if (strcmp(argv[i], "overload") == 0) cfg->overload_probability = strtof(value, NULL);
+        else if (strcmp(argv[i], "repair") == 0) cfg->repair_sec = strtod(value, NULL);
+        else if (strcmp(argv[i], "lockout") == 0) cfg->lockout_energy = strtof(value, NULL);
+        else if (strcmp(argv[i], "rate") == 0) cfg->call_rate_sec = strtof(value, NULL);
+        else if (strcmp(argv[i], "verify") == 0) cfg->verify = strtoul(value, NULL, 10) != 0;
+        else if (strcmp(argv[i], "tol") == 0) cfg->tolerance = strtod(value, NULL);
+        else if (strcmp(argv[i], "tripdiff") == 0) cfg->trip_tolerance = strtod(value, NULL);
+        else if (strcmp(argv[i], "seed") == 0) cfg->seed = strtoull(value, NULL, 0);
+        else if (strcmp(argv[i], "threads") == 0) cfg->threads = (unsigned int)strtoul(value, NULL, 10);
+        else return -1;
+    }
+
+    if (cfg->threads < 1) cfg->threads = 1;
+    if (cfg->threads > SIM_MAX_THREADS) cfg->threads = SIM_MAX_THREADS;
+    if (cfg->threads > cfg->breakers) cfg->threads = cfg->breakers ? cfg->breakers : 1;
+    if (cfg->breakers == 0 || cfg->horizon_sec <= 0.0 || cfg->change_sec <= 0.0 || cfg->call_rate_sec <= 0.0f) return -1;
+    return 0;
+}
+
+/* ------------------------------------------------
+        Breaker settings and load model
+   ------------------------------------------------ */
+
+// Settings of a breaker, derived from its index (same in both simulations)
+static ProtectionOverloadParams Fleet_Params(const FleetConfig *cfg, uint32_t breaker) {
+    SimRandom rng;
+    SimRandom_Seed(&rng, cfg->seed ^ 0xB4EA4E45ull ^ ((uint64_t)breaker * 0x9E3779B97F4A7C15ull));
+    ProtectionOverloadCurve curve = (ProtectionOverloadCurve)SimRandom_Below(&rng, 3);
+    return (ProtectionOverloadParams){
+        .overload_threshold = SimRandom_Uniform(&rng, 10.0f, 1000.0f),
+        .k_factor = (curve == CURVE_STANDARD_INVERSE) ? SimRandom_Uniform(&rng, 0.05f, 1.0f) : SimRandom_Uniform(&rng, 1.0f, 100.0f),
+        .cooling_rate = 0.98f,
+        .max_energy = SimRandom_Uniform(&rng, 10.0f, 600.0f),
+        .curve = curve,
+        .lockout_energy = cfg->lockout_energy
+    };
+}
+
+// Load segment stream of a breaker
+typedef struct {
+    SimRandom rng;
+    double next_change;                 // End of current segment [s]
+    float current;                      // Current of current segment [A]
+} FleetLoad;
+
+// Next load segment: exponential duration, overload with given probability
+static void Fleet_LoadAdvance(const FleetConfig *cfg, const ProtectionOverloadParams *params, FleetLoad *load) {
+    float factor = (SimRandom_Uniform(&load->rng, 0.0f, 1.0f) < cfg->overload_probability) ?
+                   SimRandom_Uniform(&load->rng, 1.2f, 4.0f) : SimRandom_Uniform(&load->rng, 0.1f, 1.1f);
+    load->current = factor * params->overload_threshold;
+    load->next_change += -cfg->change_sec * log(1.0 - SimRandom_Uniform(&load->rng, 0.0f, 1.0f));
+}
+
+static void Fleet_LoadInit(const FleetConfig *cfg, const ProtectionOverloadParams *params, uint32_t breaker, FleetLoad *load) {
+    SimRandom_Seed(&load->rng, cfg->seed ^ ((uint64_t)breaker * 0xD1B54A32D192ED03ull));
+    load->next_change = 0.0;
+    Fleet_LoadAdvance(cfg, params, load);
+}
+
+/* ------------------------------------------------
+        Event-driven breaker model
+   ------------------------------------------------ */
+
+typedef struct {
+    ProtectionOverloadParams params;
+    FleetLoad load;
+    double t0;                          // Time of energy e0 [s] (open: trip time)
+    double reclose;                     // Reclose time while open [s]
+    float e0;                           // Energy at t0 (open: energy at trip)
+    float rate;                         // d energy / dt in current segment [1/s] (< 0: cooling)
+    bool open;                          // Tripped, waiting for reclose
+    uint32_t trips;
+    double first_trip;                  // Time of first trip [s] (INFINITY if none)
+    double event;                       // Time of pending event [s]
+    uint64_t due;                       // Wheel slot number of pending event (event / slot width)
+    uint32_t link;                      // Next breaker in the same wheel slot
+} FleetBreaker;
+
+// Energy slope under a load: heating 1 / t_trip above pickup, cooling below
+static float Fleet_Rate(const FleetBreaker *b) {
+    float overload_factor = b->load.current / b->params.overload_threshold;
+    if (overload_factor > PROTECTION_OVERLOAD_PICKUP) {
+        return ProtectionOverload_CurveTerm(b->params.curve, overload_factor) / b->params.k_factor;
+    }
+    return -1.0f / b->params.max_energy;
+}
+
+static float Fleet_Energy(const FleetBreaker *b, double t) {
+    float energy = b->e0 + b->rate * (float)(t - b->t0);
+    return (energy < 0.0f) ? 0.0f : energy;
+}
+
+// Analytic trip time of a heating breaker [s] (INFINITY if cooling)
+static double Fleet_TripTime(const FleetBreaker *b) {
+    return (b->rate > 0.0f) ? b->t0 + (1.0 - b->e0) / b->rate : INFINITY;
+}
+
+// Time of the pending event of a breaker
+static double Fleet_NextEvent(const FleetBreaker *b) {
+    double next = b->load.next_change;
+    double other = b->open ? b->reclose : Fleet_TripTime(b);
+    return (other < next) ? other : next;
+}
+
+// Event counters of a worker
+typedef struct {
+    uint64_t changes;
+    uint64_t trips;
+    uint64_t recloses;
+} FleetStats;
+
+// Process the pending event of a breaker at time t
+static void Fleet_Process(const FleetConfig *cfg, FleetBreaker *b, double t, FleetStats *stats) {
+    if (b->open && b->reclose <= b->load.next_change) {
+        // Reclose: re-armed with the thermal image cooled since the trip
+        b->open = false;
+        b->e0 = ProtectionOverload_TrippedEnergy(b->e0, b->params.max_energy, (float)(t - b->t0));
+        b->t0 = t;
+        b->rate = Fleet_Rate(b);
+        stats->recloses++;
+    } else if (!b->open && Fleet_TripTime(b) <= b->load.next_change) {
+        // Trip
+        if (b->trips++ == 0) {
+            b->first_trip = t;
+        }
+        b->open = true;
+        b->e0 = 1.0f;
+        b->t0 = t;
+        // Repair, and reset lockout in closed form
+        double lockout = ProtectionOverload_LockoutTime(1.0f, b->params.max_energy, b->params.lockout_energy, 0.0f);
+        b->reclose = t + fmax(cfg->repair_sec, lockout);
+        stats->trips++;
+    } else {
+        // Load change: energy carried over into the new segment
+        if (!b->open) {
+            b->e0 = Fleet_Energy(b, t);
+            b->t0 = t;
+        }
+        Fleet_LoadAdvance(cfg, &b->params, &b->load);
+        b->rate = Fleet_Rate(b);
+        stats->changes++;
+    }
+}
+
+/* ------------------------------------------------
+        Timing wheel (pending event of each breaker)
+   ------------------------------------------------ */
+
+// Slots of width change / 256: the wheel spans 16 mean load segments, events
+// further out stay in their slot for the next turns
+#define FLEET_WHEEL_SLOTS   4096u
+#define FLEET_WHEEL_SPAN    16.0
+#define FLEET_NONE          UINT32_MAX
+
+typedef struct {
+    double slot_sec;                    // Slot width [s]
+    uint32_t head[FLEET_WHEEL_SLOTS];   // First breaker of each slot (FLEET_NONE: empty)
+} FleetWheel;
+
+// Queue the pending event of a breaker (dropped if past the horizon)
+static void Fleet_WheelInsert(const FleetConfig *cfg, FleetWheel *wheel, FleetBreaker *breakers, uint32_t n) {
+    FleetBreaker *b = &breakers[n];
+    b->event = Fleet_NextEvent(b);
+    if (b->event > cfg->horizon_sec) return;
+    b->due = (uint64_t)(b->event / wheel->slot_sec);
+    uint32_t *head = &wheel->head[b->due % FLEET_WHEEL_SLOTS];
+    b->link = *head;
+    *head = n;
+}
+
+/* ------------------------------------------------
+        Parallel workers (independent breaker shards)
+   ------------------------------------------------ */
+
+typedef struct {
+    pthread_t thread;
+    const FleetConfig *cfg;
+    uint32_t first;                     // First breaker of this worker
+    uint32_t count;                     // Breakers of this worker
+    FleetStats stats;
+    uint64_t verify_trips;              // Verify: trips of tick-by-tick engine
+    uint64_t verify_mismatches;         // Verify: breakers with different first trip
+    double verify_max_error;            // Verify: max first trip time difference [s]
+    int error;
+} FleetWorker;
+
+// Step breakers tick by tick through the engine, compare with the event-driven trips
+static void Fleet_Verify(FleetWorker *w, const FleetBreaker *breakers) {
+    const FleetConfig *cfg = w->cfg;
+    uint64_t ticks = (uint64_t)(cfg->horizon_sec / cfg->call_rate_sec);
+
+    for (uint32_t n = 0; n < w->count; n++) {
+        const FleetBreaker *b = &breakers[n];
+        FleetLoad load;
+        Fleet_LoadInit(cfg, &b->params, w->first + n, &load);
+        ProtectionOverloadSM sm;
+        ProtectionOverload_Init(&sm, &b->params, cfg->call_rate_sec);
+
+        bool open = false;
+        double reclose = 0.0;
+        double first_trip = INFINITY;
+        for (uint64_t tick = 1; tick <= ticks; tick++) {
+            double t = tick * (double)cfg->call_rate_sec;
+            while (load.next_change <= t) {
+                Fleet_LoadAdvance(cfg, &b->params, &load);
+            }
+            if (open) {
+                // Tripped engine ticks on (thermal image), reset after repair once the lockout has expired
+                if (t < reclose || !ProtectionOverload_Reset(&sm)) {
+                    ProtectionOverload_Run(&sm, load.current);
+                    continue;
+                }
+                open = false;
+            }
+            ProtectionOverload_Run(&sm, load.current);
+            if (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED) {
+                if (w->verify_trips++, isinf(first_trip)) {
+                    first_trip = t;
+                }
+                open = true;
+                reclose = t + cfg->repair_sec;
+            }
+        }
+
+        // No trip in one model only: both must be close to the horizon
+        double error = fabs(first_trip - b->first_trip);
+        if (isinf(first_trip) != isinf(b->first_trip)) {
+            error = cfg->horizon_sec - fmin(first_trip, b->first_trip);
+        } else if (isinf(first_trip)) {
+            error = 0.0;
+        }
+        if (error > w->verify_max_error) w->verify_max_error = error;
+        if (error > 2.0 * cfg->call_rate_sec + cfg->tolerance * fmin(first_trip, b->first_trip)) w->verify_mismatches++;
+    }
+}
+
+static void *Fleet_Worker(void *arg) {
+    FleetWorker *w = arg;
+    const FleetConfig *cfg = w->cfg;
+
+    FleetBreaker *breakers = calloc(w->count, sizeof(FleetBreaker));
+    FleetWheel *wheel = malloc(sizeof(FleetWheel));
+    if (breakers == NULL || wheel == NULL) {
+        w->error = 1;
+        free(breakers);
+        free(wheel);
+        return NULL;
+    }
+    wheel->slot_sec = cfg->change_sec * FLEET_WHEEL_SPAN / FLEET_WHEEL_SLOTS;
+    for (uint32_t i = 0; i < FLEET_WHEEL_SLOTS; i++) {
+        wheel->head[i] = FLEET_NONE;
+    }
+
+    // Initial segment and pending event of every breaker
+    for (uint32_t n = 0; n < w->count; n++) {
+        FleetBreaker *b = &breakers[n];
+        b->params = Fleet_Params(cfg, w->first + n);
+        Fleet_LoadInit(cfg, &b->params, w->first + n, &b->load);
+        b->rate = Fleet_Rate(b);
+        b->first_trip = INFINITY;
+        Fleet_WheelInsert(cfg, wheel, breakers, n);
+    }
+
+    // One slot after the other: due events are processed and queued again (possibly
+    // in the same slot), events of later turns are kept
+    uint64_t last = (uint64_t)(cfg->horizon_sec / wheel->slot_sec);
+    for (uint64_t now = 0; now <= last; now++) {
+        uint32_t *head = &wheel->head[now % FLEET_WHEEL_SLOTS];
+        uint32_t later = FLEET_NONE;
+        while (*head != FLEET_NONE) {
+            uint32_t n = *head;
+            FleetBreaker *b = &breakers[n];
+            *head = b->link;
+            if (b->due != now) {
+                b->link = later;
+                later = n;
+                continue;
+            }
+            Fleet_Process(cfg, b, b->event, &w->stats);
+            Fleet_WheelInsert(cfg, wheel, breakers, n);
+        }
+        *head = later;
+    }
+
+    if (cfg->verify) {
+        Fleet_Verify(w, breakers);
+    }
+
+    free(breakers);
+    free(wheel);
+    return NULL;
+}
+
+static double Fleet_Now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    FleetConfig cfg;
+    if (Fleet_ParseArgs(&cfg, argc, argv) != 0) {
+        fprintf(stderr, "Usage: %s [breakers=N] [hours=X] [change=X] [overload=X] [repair=X] [lockout=X] "
+                        "[rate=X] [verify=0|1] [tol=X] [tripdiff=X] [seed=N] [threads=N]\n", argv[0]);
+        return 2;
+    }
+
+    static FleetWorker workers[SIM_MAX_THREADS];
+    uint32_t per_thread = cfg.breakers / cfg.threads;
+
+    double start = Fleet_Now();
+    for (unsigned int t = 0; t < cfg.threads; t++) {
+        workers[t] = (FleetWorker){
+            .cfg = &cfg,
+            .first = t * per_thread,
+            .count = (t == cfg.threads - 1) ? cfg.breakers - t * per_thread : per_thread
+        };
+        pthread_create(&workers[t].thread, NULL, Fleet_Worker, &workers[t]);
+    }
+
+    FleetStats total = {0};
+    uint64_t mismatches = 0, verify_trips = 0;
+    double max_error = 0.0;
+    int error = 0;
+    for (unsigned int t = 0; t < cfg.threads; t++) {
+        pthread_join(workers[t].thread, NULL);
+        total.changes += workers[t].stats.changes;
+        total.trips += workers[t].stats.trips;
+        total.recloses += workers[t].stats.recloses;
+        mismatches += workers[t].verify_mismatches;
+        verify_trips += workers[t].verify_trips;
+        if (workers[t].verify_max_error > max_error) max_error = workers[t].verify_max_error;
+        error |= workers[t].error;
+    }
+    double elapsed = Fleet_Now() - start;
+    if (error) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    uint64_t events = total.changes + total.trips + total.recloses;
+    double breaker_years = cfg.breakers * cfg.horizon_sec / (365.0 * 86400.0);
+    printf("%u breakers, %.1f years, seed 0x%llx, %u threads\n", cfg.breakers,
+           cfg.horizon_sec / (365.0 * 86400.0), (unsigned long long)cfg.seed, cfg.threads);
+    printf("%llu events: %llu load changes, %llu trips (%.4f per breaker-year), %llu recloses\n",
+           (unsigned long long)events, (unsigned long long)total.changes, (unsigned long long)total.trips,
+           total.trips / breaker_years, (unsigned long long)total.recloses);
+    printf("%.3f s, %.1f Mevents/s, %.0f breaker-years/s (%.3g engine ticks/s equivalent)\n",
+           elapsed, events / elapsed / 1e6, breaker_years / elapsed,
+           cfg.breakers * (cfg.horizon_sec / cfg.call_rate_sec) / elapsed);
+
+    if (cfg.verify) {
+        double trip_diff = fabs((double)verify_trips - (double)total.trips) / (total.trips ? total.trips : 1);
+        printf("verify: tick-by-tick engine %llu trips (%.2f %% difference), first trip of %llu of %u breakers "
+               "differs, max first trip time error %.4f s\n", (unsigned long long)verify_trips, trip_diff * 100.0,
+               (unsigned long long)mismatches, cfg.breakers, max_error);
+        if (mismatches != 0 || trip_diff > cfg.trip_tolerance) {
+            printf("FAIL\n");
+            return 1;
+        }
+        printf("OK\n");
+    }
+    return 0;
+}
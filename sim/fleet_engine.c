@@ -0,0 +1,206 @@
+// Fleet Engine
+
+#if defined(__linux__)
+#define _GNU_SOURCE                     // pthread_setaffinity_np
+#elif !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "fleet_engine.h"
+#include "sim_threads.h"
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Barrier spins before yielding the CPU (more workers than cores)
+#define FLEET_ENGINE_SPINS  2000u
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define FleetEngine_Relax() _mm_pause()
+#else
+#define FleetEngine_Relax() ((void)0)
+#endif
+
+// Worker thread argument
+typedef struct {
+    FleetEngine *engine;
+    unsigned int worker;
+} FleetEngineWorker;
+
+// Create engine: shards, worker ranges and buffers
+bool FleetEngine_Create(FleetEngine *engine, const FleetEngineConfig *config) {
+    memset(engine, 0, sizeof(*engine));
+    if (config->sm == NULL || config->count == 0 || config->load == NULL) {
+        return false;
+    }
+    engine->config = *config;
+    FleetEngineConfig *cfg = &engine->config;
+
+    // Shard size rounded up to whole cache lines of instances
+    if (cfg->shard_channels == 0) cfg->shard_channels = FLEET_ENGINE_SHARD_CHANNELS;
+    cfg->shard_channels = (cfg->shard_channels + FLEET_ENGINE_SHARD_ALIGN - 1u) / FLEET_ENGINE_SHARD_ALIGN * FLEET_ENGINE_SHARD_ALIGN;
+    engine->shards = (cfg->count + cfg->shard_channels - 1u) / cfg->shard_channels;
+
+    if (cfg->threads == 0) cfg->threads = SimThreads_CpuCount();
+    if (cfg->threads > FLEET_ENGINE_MAX_THREADS) cfg->threads = FLEET_ENGINE_MAX_THREADS;
+    if (cfg->threads > engine->shards) cfg->threads = engine->shards;
+
+    engine->trip_tick = malloc(cfg->count * sizeof(uint32_t));
+    engine->range = aligned_alloc(_Alignof(FleetEngineRange), cfg->threads * sizeof(FleetEngineRange));
+    engine->currents = malloc((size_t)cfg->threads * cfg->shard_channels * sizeof(float));
+    engine->steals = calloc(cfg->threads, sizeof(uint64_t));
+    if (engine->trip_tick == NULL || engine->range == NULL || engine->currents == NULL || engine->steals == NULL) {
+        FleetEngine_Destroy(engine);
+        return false;
+    }
+    for (uint32_t i = 0; i < cfg->count; i++) {
+        engine->trip_tick[i] = FLEET_ENGINE_NO_TRIP;
+    }
+
+    // Contiguous shard ranges, sizes differing by at most one shard
+    for (unsigned int w = 0; w < cfg->threads; w++) {
+        engine->range[w].begin = (unsigned int)((uint64_t)engine->shards * w / cfg->threads);
+        engine->range[w].end = (unsigned int)((uint64_t)engine->shards * (w + 1u) / cfg->threads);
+        atomic_init(&engine->range[w].next, engine->range[w].begin);
+    }
+    atomic_init(&engine->arrived, 0);
+    atomic_init(&engine->generation, 0);
+    atomic_init(&engine->workers, cfg->threads);
+    return true;
+}
+
+// Step the instances of a shard over one tick
+static void FleetEngine_Shard(FleetEngine *engine, unsigned int worker, unsigned int shard, uint32_t tick) {
+    const FleetEngineConfig *cfg = &engine->config;
+    uint32_t first = shard * cfg->shard_channels;
+    uint32_t count = (cfg->count - first < cfg->shard_channels) ? cfg->count - first : cfg->shard_channels;
+    float *currents = &engine->currents[(size_t)worker * cfg->shard_channels];
+
+    cfg->load(cfg->context, tick, first, count, currents);
+    for (uint32_t i = 0; i < count; i++) {
+        ProtectionOverloadSM *sm = &cfg->sm[first + i];
+        ProtectionOverload_Run(sm, currents[i]);
+        if (ProtectionOverload_GetState(sm) == ST_OVERLOAD_TRIGGERED && engine->trip_tick[first + i] == FLEET_ENGINE_NO_TRIP) {
+            engine->trip_tick[first + i] = tick;
+        }
+    }
+}
+
+// End of tick: the last worker to arrive completes the tick and releases the others
+static void FleetEngine_Barrier(FleetEngine *engine, uint32_t tick) {
+    unsigned int generation = atomic_load_explicit(&engine->generation, memory_order_acquire);
+    if (atomic_fetch_add_explicit(&engine->arrived, 1u, memory_order_acq_rel) + 1u ==
+        atomic_load_explicit(&engine->workers, memory_order_relaxed)) {
+        if (engine->config.tick_hook != NULL) {
+            engine->config.tick_hook(engine->config.context, tick);
+        }
+        for (unsigned int w = 0; w < engine->config.threads; w++) {
+            atomic_store_explicit(&engine->range[w].next, engine->range[w].begin, memory_order_relaxed);
+        }
+        atomic_store_explicit(&engine->arrived, 0u, memory_order_relaxed);
+        atomic_store_explicit(&engine->generation, generation + 1u, memory_order_release);
+        return;
+    }
+    for (unsigned int spins = 0; atomic_load_explicit(&engine->generation, memory_order_acquire) == generation; spins++) {
+        if (spins < FLEET_ENGINE_SPINS) {
+            FleetEngine_Relax();
+        } else {
+            sched_yield();
+        }
+    }
+}
+
+// Worker: own shards first, then the shards left in the other ranges
+static void *FleetEngine_Worker(void *arg) {
+    FleetEngineWorker *worker = arg;
+    FleetEngine *engine = worker->engine;
+    unsigned int w = worker->worker;
+    unsigned int threads = engine->config.threads;
+    uint64_t steals = 0;
+
+    for (uint32_t tick = engine->tick + 1u; tick <= engine->last_tick; tick++) {
+        for (unsigned int v = 0; v < threads; v++) {
+            FleetEngineRange *range = &engine->range[(w + v) % threads];
+            unsigned int shard;
+            while ((shard = atomic_fetch_add_explicit(&range->next, 1u, memory_order_relaxed)) < range->end) {
+                FleetEngine_Shard(engine, w, shard, tick);
+                steals += (v != 0);
+            }
+        }
+        FleetEngine_Barrier(engine, tick);
+    }
+    engine->steals[w] += steals;
+    return NULL;
+}
+
+// Run a number of ticks (the caller is worker 0)
+bool FleetEngine_Run(FleetEngine *engine, uint32_t ticks) {
+    unsigned int threads = engine->config.threads;
+    FleetEngineWorker *workers = malloc(threads * sizeof(FleetEngineWorker));
+    pthread_t *thread = malloc(threads * sizeof(pthread_t));
+    if (workers == NULL || thread == NULL) {
+        free(workers);
+        free(thread);
+        return false;
+    }
+    engine->last_tick = engine->tick + ticks;
+    atomic_store_explicit(&engine->workers, threads, memory_order_relaxed);
+
+    // Workers that could not be started leave their range to the others (stealing).
+    // The reduced count is stored before worker 0 arrives at the barrier, so the
+    // last worker to arrive (ordered after worker 0 on arrived) reads it.
+    unsigned int started = 1;
+    for (unsigned int w = 1; w < threads; w++) {
+        workers[started] = (FleetEngineWorker){engine, w};
+        if (pthread_create(&thread[started], NULL, FleetEngine_Worker, &workers[started]) != 0) {
+            break;
+        }
+#if defined(__linux__)
+        if (engine->config.pin) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(w % SimThreads_CpuCount(), &cpus);
+            pthread_setaffinity_np(thread[started], sizeof(cpus), &cpus);
+        }
+#endif
+        started++;
+    }
+    atomic_store_explicit(&engine->workers, started, memory_order_relaxed);
+
+    workers[0] = (FleetEngineWorker){engine, 0};
+    FleetEngine_Worker(&workers[0]);
+    for (unsigned int w = 1; w < started; w++) {
+        pthread_join(thread[w], NULL);
+    }
+    engine->tick = engine->last_tick;
+    free(workers);
+    free(thread);
+    return true;
+}
+
+/* Returns tick of first trip of an instance (FLEET_ENGINE_NO_TRIP if none) */
+uint32_t FleetEngine_GetTripTick(const FleetEngine *engine, uint32_t instance) {
+    return engine->trip_tick[instance];
+}
+
+/* Returns shards stolen from other workers since Create */
+uint64_t FleetEngine_GetSteals(const FleetEngine *engine) {
+    uint64_t steals = 0;
+    for (unsigned int w = 0; w < engine->config.threads; w++) {
+        steals += engine->steals[w];
+    }
+    return steals;
+}
+
+// Release engine buffers (instances are owned by the caller)
+void FleetEngine_Destroy(FleetEngine *engine) {
+    free(engine->trip_tick);
+    free(engine->range);
+    free(engine->currents);
+    free(engine->steals);
+    engine->trip_tick = NULL;
+    engine->range = NULL;
+    engine->currents = NULL;
+    engine->steals = NULL;
+}
@@ -0,0 +1,77 @@
+// Fleet Engine Header
+//
+// Tick-stepped multi-threaded engine for large installations: N overload
+// instances are stepped every tick by a pool of worker threads.
+//   - Instances are split into cache-sized shards (FLEET_ENGINE_SHARD_CHANNELS
+//     instances, multiple of 64 so that shards never share a cache line).
+//   - Each worker owns a contiguous range of shards, which stays in its cache
+//     from tick to tick (workers optionally pinned to CPUs). A worker done with
+//     its range steals the remaining shards of the other workers, so a worker
+//     slowed by many channels in overload does not hold the tick back.
+//   - Workers meet once per tick at a spinning barrier; the last one to arrive
+//     runs the tick hook (e.g. load transfer after trips) before releasing the
+//     others.
+// Each instance only depends on its own currents, so results (trip ticks,
+// energies) are the same for any thread count and any stealing order.
+
+#pragma once
+
+#include "protection_overload.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FLEET_ENGINE_SHARD_CHANNELS 2048u       // Default shard: 72 KB of instances, fits L2
+#define FLEET_ENGINE_SHARD_ALIGN    64u         // Shard size granularity [instances]
+#define FLEET_ENGINE_MAX_THREADS    256u        // Max worker threads
+#define FLEET_ENGINE_NO_TRIP        UINT32_MAX  // Trip tick of an instance not tripped
+
+// Currents of instances [first, first + count) at a tick (called concurrently
+// for different shards: must only depend on its arguments and on state updated
+// by the tick hook)
+typedef void (*FleetEngineLoad)(void *context, uint32_t tick, uint32_t first, uint32_t count, float *currents);
+
+// Called once per tick after all instances were stepped, no worker running
+typedef void (*FleetEngineTickHook)(void *context, uint32_t tick);
+
+// Engine configuration
+typedef struct {
+    ProtectionOverloadSM *sm;           // Instances [count] (initialized by the caller)
+    uint32_t count;                     // Number of instances
+    uint32_t shard_channels;            // Instances per shard (0: FLEET_ENGINE_SHARD_CHANNELS)
+    unsigned int threads;               // Worker threads, caller included (0: all CPUs)
+    bool pin;                           // Pin worker w to CPU w (Linux)
+    FleetEngineLoad load;               // Current source
+    FleetEngineTickHook tick_hook;      // Optional tick completion
+    void *context;                      // Passed to load and tick_hook
+} FleetEngineConfig;
+
+// Shard range of a worker (own cache line: claimed concurrently by thieves)
+typedef struct {
+    _Alignas(64) atomic_uint next;      // Next shard to claim
+    unsigned int begin;                 // First shard of the range
+    unsigned int end;                   // End of the range
+} FleetEngineRange;
+
+// Engine
+typedef struct {
+    FleetEngineConfig config;
+    unsigned int shards;                // Number of shards
+    uint32_t *trip_tick;                // Tick of first trip of each instance [count]
+    uint32_t tick;                      // Ticks run
+    uint32_t last_tick;                 // Last tick of the current Run
+    FleetEngineRange *range;            // Shard range of each worker [threads]
+    float *currents;                    // Current buffer of each worker [threads * shard_channels]
+    uint64_t *steals;                   // Shards stolen by each worker [threads]
+    atomic_uint workers;                // Workers taking part in the barrier
+    _Alignas(64) atomic_uint arrived;   // Barrier: workers arrived in this tick
+    _Alignas(64) atomic_uint generation;// Barrier: released ticks
+} FleetEngine;
+
+// Fleet engine API (Create returns false when out of memory or misconfigured)
+bool FleetEngine_Create(FleetEngine *engine, const FleetEngineConfig *config);
+bool FleetEngine_Run(FleetEngine *engine, uint32_t ticks);  // false when out of memory
+uint32_t FleetEngine_GetTripTick(const FleetEngine *engine, uint32_t instance);
+uint64_t FleetEngine_GetSteals(const FleetEngine *engine);
+void FleetEngine_Destroy(FleetEngine *engine);
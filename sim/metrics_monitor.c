@@ -0,0 +1,74 @@
+// Live Metrics Monitor Tool
+//
+// Maps the metrics segment of a running protection process read-only and
+// prints the counters of every attached instance, one line per slot:
+//   slot  source  state  ticks  pickup [s]  trips  energy  peak  Run p50/p99/p99.9 [ns]
+//
+//   metrics_monitor [name=/protection_overload] [interval=1] [count=0 (until interrupted)]
+
+#define _POSIX_C_SOURCE 200809L         // nanosleep
+
+#include "protection_overload_metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Not used: the monitor runs no instance
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static const char *const Monitor_StateNames[ST_COUNT] = {
+    [ST_IDLE]               = "IDLE",
+    [ST_OVERLOAD_TRIGGERED] = "TRIGGERED",
+    [ST_PICKUP]             = "PICKUP"
+};
+
+int main(int argc, char *argv[]) {
+    const char *name = "/protection_overload";
+    double interval = 1.0;
+    unsigned long count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "name=", 5) == 0) {
+            name = argv[i] + 5;
+        } else if (strncmp(argv[i], "interval=", 9) == 0) {
+            interval = strtod(argv[i] + 9, NULL);
+        } else if (strncmp(argv[i], "count=", 6) == 0) {
+            count = strtoul(argv[i] + 6, NULL, 10);
+        } else {
+            fprintf(stderr, "Usage: %s [name=/protection_overload] [interval=1] [count=0]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    ProtectionOverloadMetrics metrics;
+    if (!ProtectionOverload_MetricsOpen(&metrics, name)) {
+        fprintf(stderr, "No metrics segment %s (version %u)\n", name, (unsigned int)PROTECTION_OVERLOAD_METRICS_VERSION);
+        return 1;
+    }
+    struct timespec pause = {(time_t)interval, (long)((interval - (double)(time_t)interval) * 1e9)};
+    for (unsigned long poll = 0; count == 0 || poll < count; poll++) {
+        if (poll > 0) {
+            nanosleep(&pause, NULL);
+        }
+        printf("%5s %7s %-10s %14s %12s %6s %8s %8s %8s %8s %8s\n", "slot", "source", "state", "ticks", "pickup[s]", "trips",
+               "energy", "peak", "p50[ns]", "p99[ns]", "p999[ns]");
+        for (uint32_t index = 0; index < metrics.header->slots; index++) {
+            ProtectionOverloadMetricsValues values;
+            ProtectionOverload_MetricsRead(ProtectionOverload_MetricsSlot(&metrics, index), &values);
+            if (!values.attached) {
+                continue;
+            }
+            printf("%5u %7u %-10s %14llu %12.3f %6u %8.4f %8.4f %8llu %8llu %8llu\n", (unsigned int)index,
+                   (unsigned int)values.source, (values.state < ST_COUNT) ? Monitor_StateNames[values.state] : "?",
+                   (unsigned long long)values.ticks, values.pickup_sec, (unsigned int)values.trips, values.energy,
+                   values.peak_energy, (unsigned long long)ProtectionOverload_MetricsPercentile(&values, 0.5),
+                   (unsigned long long)ProtectionOverload_MetricsPercentile(&values, 0.99),
+                   (unsigned long long)ProtectionOverload_MetricsPercentile(&values, 0.999));
+        }
+        fflush(stdout);
+    }
+    ProtectionOverload_MetricsClose(&metrics);
+    return 0;
+}
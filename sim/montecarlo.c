@@ -0,0 +1,331 @@
+// Sensor Noise and Quantization Monte Carlo Study
+//
+// Wraps the overload engine with a current transformer / ADC chain model:
+//   measured = quantize(I * (1 + gain_error) + offset + noise)
+// gain_error and offset are drawn once per trial (device tolerance), noise
+// once per sample. For each operating point the tool reports the trip time
+// distribution and the nuisance trip probability (trip while the true current
+// is not above the configured pickup) as CSV. A trial ends at the trip, so the
+// lockout and re-arm settings do not apply.
+//
+//   montecarlo [key=value ...]
+//     trials=100000   trials per operating point (at least 1)
+//     points=1.0,1.1  operating points [x I_trip]
+//     bits=12         ADC resolution (0 = ideal, no quantization, max 24)
+//     fs=10           ADC full scale [x I_trip]
+//     gain=0.01       gain error sigma (relative)
+//     offset=0.002    offset sigma [x I_trip]
+//     noise=0.01      sample noise sigma [x I_trip]
+//     rate=0.01       engine call rate [s]
+//     tmax=60         max simulated time per trial [s]
+//     curve=i2t       trip curve (i2t, it, si)
+//     pickup=0        pickup overload factor (0: PROTECTION_OVERLOAD_PICKUP)
+//     dropout=0       dropout / pickup ratio (0: no hysteresis)
+//     seed=1          master seed
+//     threads=N       worker threads (default: all CPUs)
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "protection_overload.h"
+#include "protection_overload_curve.h"
+#include "sim_random.h"
+#include "sim_threads.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MC_MAX_POINTS       32          // Max operating points
+#define MC_MAX_ADC_BITS     24u         // Max ADC resolution [bits]
+
+// Trials are driven through the instance API: no sensor is read
+float Sensor_Read() {
+    return 0.0f;
+}
+
+/* ------------------------------------------------
+        Study configuration
+   ------------------------------------------------ */
+
+typedef struct {
+    uint64_t trials;                    // Trials per operating point
+    unsigned int point_count;
+    float points[MC_MAX_POINTS];        // Operating points [x I_trip]
+    unsigned int adc_bits;              // ADC resolution (0 = ideal)
+    float adc_full_scale;               // ADC full scale [x I_trip]
+    float gain_sigma;                   // Gain error sigma (relative)
+    float offset_sigma;                 // Offset sigma [x I_trip]
+    float noise_sigma;                  // Per-sample noise sigma [x I_trip]
+    float call_rate_sec;                // Engine call rate [s]
+    float max_time_sec;                 // Max simulated time per trial [s]
+    ProtectionOverloadParams params;    // Engine settings (currents normalized to I_trip)
+    uint64_t seed;
+    unsigned int threads;
+} McConfig;
+
+// Same settings as the unit tests: currents are normalized to I_trip
+static const ProtectionOverloadParams mc_params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f
+};
+
+static const char *const mc_curve_names[] = {"i2t", "it", "si"};
+
+static int Mc_ParseCurve(McConfig *cfg, const char *name) {
+    for (unsigned int c = 0; c < sizeof(mc_curve_names) / sizeof(mc_curve_names[0]); c++) {
+        if (strcmp(name, mc_curve_names[c]) == 0) {
+            cfg->params.curve = (ProtectionOverloadCurve)c;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Comma separated list: an empty or malformed token, or more than MC_MAX_POINTS, is an error
+static int Mc_ParsePoints(McConfig *cfg, const char *list) {
+    cfg->point_count = 0;
+    for (;;) {
+        char *end;
+        float point = strtof(list, &end);
+        if (end == list || (*end != ',' && *end != '\0') || cfg->point_count == MC_MAX_POINTS) return -1;
+        cfg->points[cfg->point_count++] = point;
+        if (*end == '\0') return 0;
+        list = end + 1;
+    }
+}
+
+static int Mc_ParseArgs(McConfig *cfg, int argc, char *argv[]) {
+    *cfg = (McConfig){
+        .trials = 100000, .adc_bits = 12, .adc_full_scale = 10.0f,
+        .gain_sigma = 0.01f, .offset_sigma = 0.002f, .noise_sigma = 0.01f,
+        .call_rate_sec = 0.01f, .max_time_sec = 60.0f, .params = mc_params, .seed = 1,
+        .threads = SimThreads_CpuCount()
+    };
+    Mc_ParsePoints(cfg, "0.9,1.0,1.1,1.15,1.2,1.4,2.0,3.0");
+
+    for (int i = 1; i < argc; i++) {
+        char *value = strchr(argv[i], '=');
+        if (value == NULL) return -1;
+        *value++ = '\0';
+        if (strcmp(argv[i], "trials") == 0) cfg->trials = strtoull(value, NULL, 10);
+        else if (strcmp(argv[i], "points") == 0) {
+            if (Mc_ParsePoints(cfg, value) != 0) return -1;
+        }
+        else if (strcmp(argv[i], "bits") == 0) cfg->adc_bits = (unsigned int)strtoul(value, NULL, 10);
+        else if (strcmp(argv[i], "fs") == 0) cfg->adc_full_scale = strtof(value, NULL);
+        else if (strcmp(argv[i], "gain") == 0) cfg->gain_sigma = strtof(value, NULL);
+        else if (strcmp(argv[i], "offset") == 0) cfg->offset_sigma = strtof(value, NULL);
+        else if (strcmp(argv[i], "noise") == 0) cfg->noise_sigma = strtof(value, NULL);
+        else if (strcmp(argv[i], "rate") == 0) cfg->call_rate_sec = strtof(value, NULL);
+        else if (strcmp(argv[i], "tmax") == 0) cfg->max_time_sec = strtof(value, NULL);
+        else if (strcmp(argv[i], "curve") == 0) {
+            if (Mc_ParseCurve(cfg, value) != 0) return -1;
+        }
+        else if (strcmp(argv[i], "pickup") == 0) cfg->params.pickup_ratio = strtof(value, NULL);
+        else if (strcmp(argv[i], "dropout") == 0) cfg->params.dropout_ratio = strtof(value, NULL);
+        else if (strcmp(argv[i], "seed") == 0) cfg->seed = strtoull(value, NULL, 0);
+        else if (strcmp(argv[i], "threads") == 0) cfg->threads = (unsigned int)strtoul(value, NULL, 10);
+        else return -1;
+    }
+
+    if (cfg->threads < 1) cfg->threads = 1;
+    if (cfg->threads > SIM_MAX_THREADS) cfg->threads = SIM_MAX_THREADS;
+    if (cfg->call_rate_sec <= 0.0f || cfg->max_time_sec <= 0.0f || cfg->point_count == 0) return -1;
+    // Codes above 2^24 do not fit the float mantissa, and no trials gives no probability
+    if (cfg->adc_bits > MC_MAX_ADC_BITS || cfg->trials == 0) return -1;
+    return 0;
+}
+
+/* ------------------------------------------------
+        Sensor chain model
+   ------------------------------------------------ */
+
+typedef struct {
+    float gain;                         // 1 + gain error
+    float offset;                       // Offset [x I_trip]
+    float noise_sigma;                  // Noise sigma [x I_trip]
+    float lsb;                          // Quantization step (0 = ideal)
+    float full_scale;                   // Saturation level
+} McSensor;
+
+static inline float Mc_SensorSample(const McSensor *sensor, SimRandom *rng, float current) {
+    float value = current * sensor->gain + sensor->offset;
+    if (sensor->noise_sigma > 0.0f) {
+        value += sensor->noise_sigma * SimRandom_Gaussian(rng);
+    }
+    if (sensor->lsb > 0.0f) {
+        // Unipolar ADC on the rectified magnitude: round to LSB, saturate
+        if (value < 0.0f) value = 0.0f;
+        if (value > sensor->full_scale) value = sensor->full_scale;
+        value = sensor->lsb * (float)(uint32_t)(value / sensor->lsb + 0.5f);
+    }
+    return value;
+}
+
+/* ------------------------------------------------
+        Parallel trials
+   ------------------------------------------------ */
+
+typedef struct {
+    pthread_t thread;
+    const McConfig *cfg;
+    float current;                      // Operating point [x I_trip]
+    unsigned int point;                 // Operating point index (seed stream)
+    uint64_t first;                     // First trial of this worker
+    uint64_t count;                     // Trials of this worker
+    uint32_t max_ticks;
+    uint32_t *histogram;                // Trip tick histogram, [max_ticks] = no trip
+} McWorker;
+
+static void *Mc_Worker(void *arg) {
+    McWorker *w = arg;
+    const McConfig *cfg = w->cfg;
+    ProtectionOverloadSM sm;
+    SimRandom rng;
+
+    float lsb = 0.0f;
+    if (cfg->adc_bits > 0) {
+        lsb = cfg->adc_full_scale / (float)((1ull << cfg->adc_bits) - 1u);
+    }
+
+    for (uint64_t trial = w->first; trial < w->first + w->count; trial++) {
+        // Independent stream per (point, trial): results do not depend on thread count
+        SimRandom_Seed(&rng, cfg->seed ^ ((uint64_t)w->point << 48) ^ (trial * 0x9E3779B97F4A7C15ull));
+
+        McSensor sensor = {
+            .gain = 1.0f + cfg->gain_sigma * SimRandom_Gaussian(&rng),
+            .offset = cfg->offset_sigma * SimRandom_Gaussian(&rng),
+            .noise_sigma = cfg->noise_sigma,
+            .lsb = lsb,
+            .full_scale = cfg->adc_full_scale
+        };
+
+        ProtectionOverload_Init(&sm, &cfg->params, cfg->call_rate_sec);
+        uint32_t tick = 0;
+        while (tick < w->max_ticks) {
+            ProtectionOverload_Run(&sm, Mc_SensorSample(&sensor, &rng, w->current));
+            tick++;
+            if (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED) {
+                break;
+            }
+        }
+        w->histogram[ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED ? tick : w->max_ticks]++;
+    }
+    return NULL;
+}
+
+// Trip time [s] at given percentile of all trials (NAN if not reached by trips)
+static double Mc_Percentile(const uint32_t *histogram, uint32_t max_ticks, uint64_t trials,
+                            double percentile, float call_rate_sec) {
+    uint64_t target = (uint64_t)ceil(percentile / 100.0 * trials);
+    uint64_t cumulated = 0;
+    if (target == 0) target = 1;
+    for (uint32_t tick = 0; tick < max_ticks; tick++) {
+        cumulated += histogram[tick];
+        if (cumulated >= target) {
+            return tick * (double)call_rate_sec;
+        }
+    }
+    return NAN;
+}
+
+static double Mc_Now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    McConfig cfg;
+    if (Mc_ParseArgs(&cfg, argc, argv) != 0) {
+        fprintf(stderr, "Usage: %s [trials=N] [points=a,b,...] [bits=N] [fs=X] [gain=X] [offset=X] "
+                        "[noise=X] [rate=X] [tmax=X] [curve=i2t|it|si] [pickup=X] [dropout=X] [seed=N] [threads=N]\n", argv[0]);
+        return 2;
+    }
+
+    uint32_t max_ticks = (uint32_t)(cfg.max_time_sec / cfg.call_rate_sec);
+    static McWorker workers[SIM_MAX_THREADS];
+    uint32_t *histograms = calloc((size_t)cfg.threads * (max_ticks + 1u), sizeof(uint32_t));
+    uint32_t *merged = calloc(max_ticks + 1u, sizeof(uint32_t));
+    if (histograms == NULL || merged == NULL) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    printf("# bits=%u fs=%g gain=%g offset=%g noise=%g rate=%g tmax=%g curve=%s pickup=%g dropout=%g trials=%llu threads=%u\n",
+           cfg.adc_bits, cfg.adc_full_scale, cfg.gain_sigma, cfg.offset_sigma, cfg.noise_sigma,
+           cfg.call_rate_sec, cfg.max_time_sec, mc_curve_names[cfg.params.curve],
+           ProtectionOverload_PickupFactor(&cfg.params), ProtectionOverload_DropoutFactor(&cfg.params),
+           (unsigned long long)cfg.trials, cfg.threads);
+    printf("current,trip_probability,nuisance_trip_probability,t_min,t_p1,t_p5,t_p50,t_p95,t_p99,t_max,mean\n");
+
+    float pickup = ProtectionOverload_PickupFactor(&cfg.params);
+    double start = Mc_Now();
+    uint64_t total_trials = 0;
+
+    for (unsigned int p = 0; p < cfg.point_count; p++) {
+        memset(histograms, 0, (size_t)cfg.threads * (max_ticks + 1u) * sizeof(uint32_t));
+        memset(merged, 0, (max_ticks + 1u) * sizeof(uint32_t));
+
+        uint64_t per_thread = cfg.trials / cfg.threads;
+        for (unsigned int t = 0; t < cfg.threads; t++) {
+            workers[t] = (McWorker){
+                .cfg = &cfg, .current = cfg.points[p], .point = p,
+                .first = t * per_thread,
+                .count = (t == cfg.threads - 1) ? cfg.trials - t * per_thread : per_thread,
+                .max_ticks = max_ticks,
+                .histogram = &histograms[(size_t)t * (max_ticks + 1u)]
+            };
+            pthread_create(&workers[t].thread, NULL, Mc_Worker, &workers[t]);
+        }
+        for (unsigned int t = 0; t < cfg.threads; t++) {
+            pthread_join(workers[t].thread, NULL);
+            for (uint32_t tick = 0; tick <= max_ticks; tick++) {
+                merged[tick] += workers[t].histogram[tick];
+            }
+        }
+
+        // Trip statistics
+        uint64_t trips = cfg.trials - merged[max_ticks];
+        double sum = 0.0;
+        uint32_t first_tick = max_ticks, last_tick = 0;
+        for (uint32_t tick = 0; tick < max_ticks; tick++) {
+            if (merged[tick] != 0) {
+                sum += (double)merged[tick] * tick * cfg.call_rate_sec;
+                if (tick < first_tick) first_tick = tick;
+                last_tick = tick;
+            }
+        }
+        double trip_probability = (double)trips / cfg.trials;
+        double nuisance = (cfg.points[p] <= pickup) ? trip_probability : 0.0;
+
+        printf("%g,%.6g,%.6g", cfg.points[p], trip_probability, nuisance);
+        if (trips > 0) {
+            const double percentiles[] = {1.0, 5.0, 50.0, 95.0, 99.0};
+            printf(",%.4f", first_tick * (double)cfg.call_rate_sec);
+            for (unsigned int i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+                printf(",%.4f", Mc_Percentile(merged, max_ticks, cfg.trials, percentiles[i], cfg.call_rate_sec));
+            }
+            printf(",%.4f,%.4f\n", last_tick * (double)cfg.call_rate_sec, sum / trips);
+        } else {
+            printf(",,,,,,,,\n");
+        }
+        fflush(stdout);
+        total_trials += cfg.trials;
+    }
+
+    double elapsed = Mc_Now() - start;
+    printf("# %llu trials in %.3f s (%.0f trials/s)\n",
+           (unsigned long long)total_trials, elapsed, total_trials / elapsed);
+
+    free(histograms);
+    free(merged);
+    return 0;
+}
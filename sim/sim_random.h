@@ -0,0 +1,44 @@
+// Simulation Random Numbers Header
+//
+// Small, fast and reproducible generator (splitmix64) shared by the host-side
+// simulation tools. Every scenario is derived from its own seed, so results do
+// not depend on the number of threads.
+
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+
+typedef struct {
+    uint64_t state;
+} SimRandom;
+
+static inline void SimRandom_Seed(SimRandom *rng, uint64_t seed) {
+    rng->state = seed;
+}
+
+// Next 64-bit value (splitmix64)
+static inline uint64_t SimRandom_Next(SimRandom *rng) {
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform float in [lo, hi)
+static inline float SimRandom_Uniform(SimRandom *rng, float lo, float hi) {
+    return lo + (hi - lo) * (float)(SimRandom_Next(rng) >> 40) * (1.0f / 16777216.0f);
+}
+
+// Uniform integer in [0, n)
+static inline uint32_t SimRandom_Below(SimRandom *rng, uint32_t n) {
+    return (uint32_t)(((SimRandom_Next(rng) >> 32) * (uint64_t)n) >> 32);
+}
+
+// Standard normal deviate (Box-Muller, one value per call)
+static inline float SimRandom_Gaussian(SimRandom *rng) {
+    float u1 = SimRandom_Uniform(rng, 0.0f, 1.0f);
+    float u2 = SimRandom_Uniform(rng, 0.0f, 1.0f);
+    if (u1 < 1e-30f) u1 = 1e-30f;
+    return sqrtf(-2.0f * logf(u1)) * cosf(6.28318530718f * u2);
+}
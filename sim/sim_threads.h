@@ -0,0 +1,26 @@
+// Simulation Threads Header
+
+#pragma once
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#define SIM_MAX_THREADS     256         // Max worker threads of simulation tools
+
+// Number of online CPUs (at least 1, at most SIM_MAX_THREADS)
+static inline unsigned int SimThreads_CpuCount(void) {
+    long count;
+#if defined(_WIN32)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = (long)info.dwNumberOfProcessors;
+#else
+    count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    if (count < 1) count = 1;
+    if (count > SIM_MAX_THREADS) count = SIM_MAX_THREADS;
+    return (unsigned int)count;
+}
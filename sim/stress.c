@@ -0,0 +1,384 @@
+// Overload Protection Property-Based Stress Harness
+//
+// Generates seeded random load profiles (steps, ramps, duty cycles, noise) and
+// checks state machine invariants on each:
+//   - accumulated energy is never negative
+//   - the breaker never trips while idle below the configured pickup, nor
+//     once picked up on a tick at or below the configured dropout
+//   - trip time never increases when a constant current increases
+//   - a profile dominating another one never trips later
+// Failing profiles are shrunk to a minimal reproducer.
+//
+//   stress [scenarios] [seed] [threads]
+
+#if !defined(_WIN32)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "protection_overload.h"
+#include "protection_overload_curve.h"
+#include "sim_random.h"
+#include "sim_threads.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define STRESS_MAX_SEGMENTS     8       // Max segments per profile
+#define STRESS_MAX_TICKS        2000    // Max profile length [ticks] (20 s at 10 ms)
+#define STRESS_MAX_LEVEL        4.0f    // Max generated level [x I_trip]
+#define STRESS_CALL_RATE        0.01f   // Engine call rate [s]
+#define STRESS_NO_TRIP          UINT32_MAX
+
+// Profiles are driven through the instance API: no sensor is read
+float Sensor_Read() {
+    return 0.0f;
+}
+
+/* ------------------------------------------------
+        Load profiles
+   ------------------------------------------------ */
+
+typedef enum {
+    SEG_STEP,                           // Constant level
+    SEG_RAMP,                           // Linear ramp level -> level_end
+    SEG_DUTY,                           // level for on_ticks, level_end for the rest of period
+    SEG_NOISE,                          // level + uniform noise of amplitude level_end
+    SEG_KIND_COUNT
+} StressSegmentKind;
+
+static const char *const segment_names[SEG_KIND_COUNT] = {"step", "ramp", "duty", "noise"};
+
+typedef struct {
+    StressSegmentKind kind;
+    uint32_t ticks;                     // Segment duration [ticks]
+    float level;                        // Start level [x I_trip]
+    float level_end;                    // Ramp end / duty low level / noise amplitude
+    uint32_t period;                    // Duty cycle period [ticks]
+    uint32_t on_ticks;                  // Duty cycle on time [ticks]
+    uint32_t noise_seed;                // Noise sequence seed
+} StressSegment;
+
+typedef struct {
+    ProtectionOverloadParams params;    // Randomized protection settings
+    unsigned int segment_count;
+    StressSegment segments[STRESS_MAX_SEGMENTS];
+    float dominated_scale;              // Dominated profile = scale * profile
+    float constant_current;             // Monotonicity check: I and I * (1 + step)
+    float constant_step;
+} StressProfile;
+
+typedef enum {
+    INV_OK,
+    INV_NEGATIVE_ENERGY,
+    INV_TRIP_BELOW_PICKUP,
+    INV_TRIP_TIME_NOT_MONOTONIC,
+    INV_DOMINATED_TRIPS_EARLIER,
+    INV_COUNT
+} StressInvariant;
+
+static const char *const invariant_names[INV_COUNT] = {
+    "ok",
+    "energy is negative",
+    "trip below the configured pickup/dropout",
+    "trip time increases with current",
+    "dominated profile trips earlier"
+};
+
+// Deterministic noise in [-1, 1) for a given seed and tick
+static inline float Stress_Noise(uint32_t seed, uint32_t tick) {
+    SimRandom rng;
+    SimRandom_Seed(&rng, ((uint64_t)seed << 32) | tick);
+    return SimRandom_Uniform(&rng, -1.0f, 1.0f);
+}
+
+// Current of a segment at a tick relative to segment start
+static float Stress_SegmentLevel(const StressSegment *seg, uint32_t t) {
+    float level;
+    switch (seg->kind) {
+        case SEG_RAMP:
+            level = seg->level + (seg->level_end - seg->level) * (float)t / (float)seg->ticks;
+            break;
+        case SEG_DUTY:
+            level = (t % seg->period) < seg->on_ticks ? seg->level : seg->level_end;
+            break;
+        case SEG_NOISE:
+            level = seg->level + seg->level_end * Stress_Noise(seg->noise_seed, t);
+            break;
+        default:
+            level = seg->level;
+            break;
+    }
+    return level > 0.0f ? level : 0.0f;
+}
+
+// Render profile currents (scaled by I_trip and by scale), return number of ticks
+static uint32_t Stress_Render(const StressProfile *p, float scale, float *currents) {
+    uint32_t n = 0;
+    for (unsigned int s = 0; s < p->segment_count; s++) {
+        const StressSegment *seg = &p->segments[s];
+        for (uint32_t t = 0; t < seg->ticks && n < STRESS_MAX_TICKS; t++) {
+            currents[n++] = scale * Stress_SegmentLevel(seg, t) * p->params.overload_threshold;
+        }
+    }
+    return n;
+}
+
+static void Stress_Generate(StressProfile *p, uint64_t seed) {
+    SimRandom rng;
+    SimRandom_Seed(&rng, seed);
+    memset(p, 0, sizeof(*p));
+
+    p->params.overload_threshold = SimRandom_Uniform(&rng, 0.5f, 2.0f);
+    p->params.k_factor = SimRandom_Uniform(&rng, 0.2f, 5.0f);
+    p->params.cooling_rate = 0.98f;
+    p->params.max_energy = SimRandom_Uniform(&rng, 0.5f, 10.0f);
+    // Settings: half of the profiles keep each default (0)
+    p->params.curve = (ProtectionOverloadCurve)SimRandom_Below(&rng, 3);
+    if (SimRandom_Below(&rng, 2)) p->params.pickup_ratio = SimRandom_Uniform(&rng, 1.0f, 1.3f);
+    if (SimRandom_Below(&rng, 2)) p->params.dropout_ratio = SimRandom_Uniform(&rng, 0.8f, 1.0f);
+    if (SimRandom_Below(&rng, 2)) p->params.lockout_energy = SimRandom_Uniform(&rng, 0.1f, 0.9f);
+    p->params.auto_reset = SimRandom_Below(&rng, 2) != 0;
+
+    p->segment_count = 1 + SimRandom_Below(&rng, STRESS_MAX_SEGMENTS);
+    for (unsigned int s = 0; s < p->segment_count; s++) {
+        StressSegment *seg = &p->segments[s];
+        seg->kind = (StressSegmentKind)SimRandom_Below(&rng, SEG_KIND_COUNT);
+        seg->ticks = 1 + SimRandom_Below(&rng, STRESS_MAX_TICKS / 4);
+        seg->level = SimRandom_Uniform(&rng, 0.0f, STRESS_MAX_LEVEL);
+        seg->level_end = SimRandom_Uniform(&rng, 0.0f, STRESS_MAX_LEVEL);
+        seg->period = 2 + SimRandom_Below(&rng, 200);
+        seg->on_ticks = SimRandom_Below(&rng, seg->period);
+        seg->noise_seed = (uint32_t)SimRandom_Next(&rng);
+        if (seg->kind == SEG_NOISE) {
+            seg->level_end *= 0.25f;
+        }
+    }
+
+    p->dominated_scale = SimRandom_Uniform(&rng, 0.0f, 1.0f);
+    p->constant_current = SimRandom_Uniform(&rng, 0.0f, STRESS_MAX_LEVEL);
+    p->constant_step = SimRandom_Uniform(&rng, 0.0f, 0.5f);
+}
+
+/* ------------------------------------------------
+        Invariant checks
+   ------------------------------------------------ */
+
+// Run the engine over a rendered profile, check per-tick invariants
+static StressInvariant Stress_RunProfile(const ProtectionOverloadParams *params, const float *currents,
+                                         uint32_t ticks, uint32_t *trip_tick) {
+    ProtectionOverloadSM sm;
+    ProtectionOverload_Init(&sm, params, STRESS_CALL_RATE);
+    float pickup = ProtectionOverload_PickupFactor(params);
+    float dropout = ProtectionOverload_DropoutFactor(params);
+
+    *trip_tick = STRESS_NO_TRIP;
+    for (uint32_t n = 0; n < ticks; n++) {
+        // Idle: a trip needs the tick above pickup, picked up: above dropout
+        float level = (ProtectionOverload_GetState(&sm) == ST_IDLE) ? pickup : dropout;
+        ProtectionOverload_Run(&sm, currents[n]);
+
+        if (!(ProtectionOverload_GetEnergy(&sm) >= 0.0f)) {
+            return INV_NEGATIVE_ENERGY;
+        }
+        if (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED) {
+            if (currents[n] / params->overload_threshold <= level) {
+                return INV_TRIP_BELOW_PICKUP;
+            }
+            *trip_tick = n;
+            break;
+        }
+    }
+    return INV_OK;
+}
+
+static StressInvariant Stress_Check(const StressProfile *p, uint64_t *ticks_run) {
+    float currents[STRESS_MAX_TICKS];
+    uint32_t trip, trip_dominated, trip_low, trip_high;
+    StressInvariant result;
+
+    // Profile and dominated profile
+    uint32_t ticks = Stress_Render(p, 1.0f, currents);
+    if ((result = Stress_RunProfile(&p->params, currents, ticks, &trip)) != INV_OK) return result;
+
+    Stress_Render(p, p->dominated_scale, currents);
+    if ((result = Stress_RunProfile(&p->params, currents, ticks, &trip_dominated)) != INV_OK) return result;
+    if (trip_dominated < trip) return INV_DOMINATED_TRIPS_EARLIER;
+
+    // Constant currents I < I' must give t_trip(I') <= t_trip(I)
+    float low = p->constant_current * p->params.overload_threshold;
+    float high = low * (1.0f + p->constant_step);
+    for (uint32_t n = 0; n < STRESS_MAX_TICKS; n++) currents[n] = low;
+    if ((result = Stress_RunProfile(&p->params, currents, STRESS_MAX_TICKS, &trip_low)) != INV_OK) return result;
+    for (uint32_t n = 0; n < STRESS_MAX_TICKS; n++) currents[n] = high;
+    if ((result = Stress_RunProfile(&p->params, currents, STRESS_MAX_TICKS, &trip_high)) != INV_OK) return result;
+    if (trip_high > trip_low) return INV_TRIP_TIME_NOT_MONOTONIC;
+
+    *ticks_run += 2u * ticks + 2u * STRESS_MAX_TICKS;
+    return INV_OK;
+}
+
+/* ------------------------------------------------
+        Shrinking
+   ------------------------------------------------ */
+
+// Accept candidate if it still violates the same invariant
+static bool Stress_TryShrink(StressProfile *p, const StressProfile *candidate, StressInvariant invariant) {
+    uint64_t ticks = 0;
+    if (Stress_Check(candidate, &ticks) == invariant) {
+        *p = *candidate;
+        return true;
+    }
+    return false;
+}
+
+static void Stress_Shrink(StressProfile *p, StressInvariant invariant) {
+    bool progress = true;
+    while (progress) {
+        progress = false;
+
+        for (unsigned int s = 0; s < p->segment_count; s++) {
+            StressProfile c = *p;
+
+            // Drop segment
+            if (c.segment_count > 1) {
+                memmove(&c.segments[s], &c.segments[s + 1], (c.segment_count - s - 1) * sizeof(c.segments[0]));
+                c.segment_count--;
+                if (Stress_TryShrink(p, &c, invariant)) { progress = true; break; }
+            }
+
+            // Simplify to step
+            c = *p;
+            if (c.segments[s].kind != SEG_STEP) {
+                c.segments[s].kind = SEG_STEP;
+                if (Stress_TryShrink(p, &c, invariant)) { progress = true; continue; }
+            }
+
+            // Halve duration
+            c = *p;
+            if (c.segments[s].ticks > 1) {
+                c.segments[s].ticks /= 2;
+                if (Stress_TryShrink(p, &c, invariant)) { progress = true; continue; }
+            }
+
+            // Round levels to 0.1
+            c = *p;
+            c.segments[s].level = roundf(c.segments[s].level * 10.0f) / 10.0f;
+            c.segments[s].level_end = roundf(c.segments[s].level_end * 10.0f) / 10.0f;
+            if (memcmp(&c, p, sizeof(c)) != 0 && Stress_TryShrink(p, &c, invariant)) progress = true;
+        }
+    }
+}
+
+static void Stress_PrintProfile(const StressProfile *p) {
+    printf("  params: threshold=%.9g k=%.9g max_energy=%.9g curve=%d pickup=%.9g dropout=%.9g lockout=%.9g auto_reset=%d\n",
+           p->params.overload_threshold, p->params.k_factor, p->params.max_energy, (int)p->params.curve,
+           p->params.pickup_ratio, p->params.dropout_ratio, p->params.lockout_energy, (int)p->params.auto_reset);
+    for (unsigned int s = 0; s < p->segment_count; s++) {
+        const StressSegment *seg = &p->segments[s];
+        printf("  segment %u: %s ticks=%u level=%.9g level_end=%.9g period=%u on=%u noise_seed=%u\n",
+               s, segment_names[seg->kind], seg->ticks, seg->level, seg->level_end,
+               seg->period, seg->on_ticks, seg->noise_seed);
+    }
+    printf("  dominated_scale=%.9g constant_current=%.9g constant_step=%.9g\n",
+           p->dominated_scale, p->constant_current, p->constant_step);
+}
+
+/* ------------------------------------------------
+        Parallel driver
+   ------------------------------------------------ */
+
+typedef struct {
+    pthread_t thread;
+    unsigned int id;
+    unsigned int thread_count;
+    uint64_t seed;
+    uint64_t scenarios;
+    uint64_t done;                      // Scenarios checked
+    uint64_t ticks;                     // Engine ticks executed
+    uint64_t failed_index;              // First failing scenario of this worker
+    StressInvariant failed_invariant;
+} StressWorker;
+
+static atomic_bool stress_failed;
+
+// Worker t checks scenarios t, t + T, t + 2T, ... (scenario i uses seed + i)
+static void *Stress_Worker(void *arg) {
+    StressWorker *w = arg;
+    StressProfile p;
+
+    w->failed_invariant = INV_OK;
+    for (uint64_t i = w->id; i < w->scenarios; i += w->thread_count) {
+        if (atomic_load_explicit(&stress_failed, memory_order_relaxed)) {
+            break;
+        }
+        Stress_Generate(&p, w->seed + i);
+        StressInvariant result = Stress_Check(&p, &w->ticks);
+        w->done++;
+        if (result != INV_OK) {
+            w->failed_index = i;
+            w->failed_invariant = result;
+            atomic_store(&stress_failed, true);
+            break;
+        }
+    }
+    return NULL;
+}
+
+static double Stress_Now(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+    uint64_t scenarios = (argc > 1) ? strtoull(argv[1], NULL, 10) : 1000000u;
+    uint64_t seed = (argc > 2) ? strtoull(argv[2], NULL, 0) : 0x5EEDu;
+    unsigned int thread_count = (argc > 3) ? (unsigned int)strtoul(argv[3], NULL, 10) : SimThreads_CpuCount();
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > SIM_MAX_THREADS) thread_count = SIM_MAX_THREADS;
+
+    static StressWorker workers[SIM_MAX_THREADS];
+    atomic_init(&stress_failed, false);
+
+    double start = Stress_Now();
+    for (unsigned int t = 0; t < thread_count; t++) {
+        workers[t] = (StressWorker){.id = t, .thread_count = thread_count, .seed = seed, .scenarios = scenarios};
+        pthread_create(&workers[t].thread, NULL, Stress_Worker, &workers[t]);
+    }
+
+    uint64_t done = 0, ticks = 0;
+    StressWorker *failed = NULL;
+    for (unsigned int t = 0; t < thread_count; t++) {
+        pthread_join(workers[t].thread, NULL);
+        done += workers[t].done;
+        ticks += workers[t].ticks;
+        if (workers[t].failed_invariant != INV_OK &&
+            (failed == NULL || workers[t].failed_index < failed->failed_index)) {
+            failed = &workers[t];
+        }
+    }
+    double elapsed = Stress_Now() - start;
+
+    printf("%llu scenarios, %u threads, seed 0x%llx: %.3f s, %.0f scenarios/s, %.1f Mticks/s\n",
+           (unsigned long long)done, thread_count, (unsigned long long)seed, elapsed,
+           done / elapsed, ticks / elapsed / 1e6);
+
+    if (failed != NULL) {
+        StressProfile p;
+        Stress_Generate(&p, seed + failed->failed_index);
+        Stress_Shrink(&p, failed->failed_invariant);
+        printf("FAIL: scenario %llu (seed 0x%llx): %s\nMinimal profile:\n",
+               (unsigned long long)failed->failed_index,
+               (unsigned long long)(seed + failed->failed_index), invariant_names[failed->failed_invariant]);
+        Stress_PrintProfile(&p);
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
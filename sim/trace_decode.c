@@ -0,0 +1,37 @@
+// Trace Decoder Tool
+//
+// Prints the timeline of a trace dump (sim/trace_dump.h), one line per record:
+//   thread  sequence  timestamp  instance  point  details
+//
+//   trace_decode <dump.bin>
+
+#include "trace_dump.h"
+#include <stdio.h>
+
+int main(int argc, char *argv[]) {
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <dump.bin>\n", argv[0]);
+        return 2;
+    }
+    FILE *file = fopen(argv[1], "rb");
+    if (file == NULL) {
+        fprintf(stderr, "Cannot open %s\n", argv[1]);
+        return 1;
+    }
+
+    static ProtectionOverloadTraceRecord records[PROTECTION_OVERLOAD_TRACE_RECORDS];
+    TraceDumpHeader header;
+    unsigned int blocks = 0;
+    printf("%4s %10s %10s  %-11s  %-12s %s\n", "thr", "sequence", "timestamp", "instance", "point", "details");
+    while (TraceDump_Read(file, &header, records, PROTECTION_OVERLOAD_TRACE_RECORDS)) {
+        TraceDump_Timeline(stdout, &header, records);
+        blocks++;
+    }
+    bool complete = feof(file) || fgetc(file) == EOF;
+    fclose(file);
+    if (!complete) {
+        fprintf(stderr, "Malformed dump after %u blocks\n", blocks);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// Trace Dump
+
+#include "trace_dump.h"
+#include "protection_overload.h"
+
+static const char *const TraceDump_StateNames[ST_COUNT] = {
+    [ST_IDLE]               = "IDLE",
+    [ST_OVERLOAD_TRIGGERED] = "TRIGGERED",
+    [ST_PICKUP]             = "PICKUP"
+};
+
+bool TraceDump_Write(FILE *file, uint32_t thread, const ProtectionOverloadTraceRing *ring) {
+    static ProtectionOverloadTraceRecord records[PROTECTION_OVERLOAD_TRACE_RECORDS];
+    uint32_t count = ProtectionOverload_TraceRead(ring, records, PROTECTION_OVERLOAD_TRACE_RECORDS);
+    TraceDumpHeader header = {
+        .magic = TRACE_DUMP_MAGIC,
+        .version = TRACE_DUMP_VERSION,
+        .record_size = sizeof(ProtectionOverloadTraceRecord),
+        .thread = thread,
+        .first_sequence = ring->head - count,
+        .count = count
+    };
+    return fwrite(&header, sizeof(header), 1, file) == 1 &&
+           fwrite(records, sizeof(records[0]), count, file) == count;
+}
+
+bool TraceDump_Read(FILE *file, TraceDumpHeader *header, ProtectionOverloadTraceRecord *records, uint32_t max) {
+    if (fread(header, sizeof(*header), 1, file) != 1 || header->magic != TRACE_DUMP_MAGIC ||
+        header->version != TRACE_DUMP_VERSION || header->record_size != sizeof(ProtectionOverloadTraceRecord)) {
+        return false;
+    }
+    uint32_t count = (header->count < max) ? header->count : max;
+    if (fread(records, sizeof(records[0]), count, file) != count) {
+        return false;
+    }
+    // Records beyond max are skipped
+    for (uint32_t i = count; i < header->count; i++) {
+        ProtectionOverloadTraceRecord skipped;
+        if (fread(&skipped, sizeof(skipped), 1, file) != 1) {
+            return false;
+        }
+    }
+    header->count = count;
+    return true;
+}
+
+void TraceDump_Timeline(FILE *out, const TraceDumpHeader *header, const ProtectionOverloadTraceRecord *records) {
+    for (uint32_t i = 0; i < header->count; i++) {
+        const ProtectionOverloadTraceRecord *record = &records[i];
+        fprintf(out, "%4u %10u %10u  sm %08x  %-12s ", (unsigned int)header->thread, (unsigned int)(header->first_sequence + i),
+                (unsigned int)record->timestamp, (unsigned int)record->instance, ProtectionOverload_TraceName(record->point));
+        switch (record->point) {
+        case TRACE_STATE_ENTRY:
+            fprintf(out, "%-9s energy %.4f\n", (record->arg < ST_COUNT) ? TraceDump_StateNames[record->arg] : "?", record->value);
+            break;
+        case TRACE_PICKUP:
+            fprintf(out, "factor %.3f\n", record->value);
+            break;
+        case TRACE_ENERGY_LEVEL:
+            fprintf(out, "%3u %%     energy %.4f\n", (unsigned int)record->arg, record->value);
+            break;
+        default:
+            fprintf(out, "energy %.4f\n", record->value);
+            break;
+        }
+    }
+}
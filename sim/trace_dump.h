@@ -0,0 +1,34 @@
+// Trace Dump Header
+//
+// Host side of the engine trace points: binary dump of thread rings and
+// timeline decoding. A dump file is a sequence of blocks, one per thread
+// ring: a header followed by its records, oldest first.
+
+#pragma once
+
+#include "protection_overload_trace.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TRACE_DUMP_MAGIC    0x52544F50u     // "POTR"
+#define TRACE_DUMP_VERSION  1u
+
+// Block header
+typedef struct {
+    uint32_t magic;                     // TRACE_DUMP_MAGIC
+    uint16_t version;                   // TRACE_DUMP_VERSION
+    uint16_t record_size;               // sizeof(ProtectionOverloadTraceRecord)
+    uint32_t thread;                    // Thread id given by the writer
+    uint32_t first_sequence;            // Sequence of the first record in the ring
+    uint32_t count;                     // Records in the block
+} TraceDumpHeader;
+
+// Append the records of a ring to a dump file
+bool TraceDump_Write(FILE *file, uint32_t thread, const ProtectionOverloadTraceRing *ring);
+
+// Read the next block (count limited to max records): false at end of file or on a malformed block
+bool TraceDump_Read(FILE *file, TraceDumpHeader *header, ProtectionOverloadTraceRecord *records, uint32_t max);
+
+// Timeline of a block: one line per record
+void TraceDump_Timeline(FILE *out, const TraceDumpHeader *header, const ProtectionOverloadTraceRecord *records);
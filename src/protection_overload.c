@@ -1,33 +1,281 @@
 // Protection Overload 
 
 #include "protection_overload.h"
-#include <math.h>
+#include "protection_overload_curve.h"
+#include "protection_overload_snapshot.h"
+#include "protection_overload_probe.h"
+#include "protection_overload_trace.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#if defined(PROTECTION_OVERLOAD_USE_LUT)
+#include "protection_overload_lut.h"
+#endif
 
 #define   CALL_RATE 0.01f       // Call rate [s] = 10 ms
 
-// State machine instance
-static ProtectionOverloadSM sm;
+// State machine instance (single instance API)
+static ProtectionOverloadSM sm_default;
 
-// Entry a new state
-static void ProtectionOverload_SM_EnterState(ProtectionOverloadState state) {  
-    // Set new state and entry flag
-    sm.state = state;
-    sm.entry = true;
+// Published state of the single instance (read by other threads) and ticks run
+static ProtectionOverloadSeqlock sm_snapshot;
+static uint32_t sm_tick;
+
+// Input tap of the single instance (NULL: none, kept across SM_Init)
+static const ProtectionOverloadInputTap *sm_tap;
+
+// Inits of all instances: Init numbers each one, without reading the instance
+static atomic_uint sm_generations;
+
+// Entry action of each state: transition hook called on entering it
+static const size_t ProtectionOverload_EntryHook[ST_COUNT] = {
+    [ST_IDLE]               = offsetof(ProtectionOverloadHooks, on_dropout),
+    [ST_OVERLOAD_TRIGGERED] = offsetof(ProtectionOverloadHooks, on_trip),
+    [ST_PICKUP]             = offsetof(ProtectionOverloadHooks, on_pickup)
+};
+
+// Call a transition hook
+static inline void ProtectionOverload_Notify(const ProtectionOverloadSM *sm, ProtectionOverloadHook hook) {
+    if (hook != NULL) {
+        hook(sm->hooks->context, sm);
+    }
+}
+
+// Entry a new state: set state and run its entry action (transition hook)
+static void ProtectionOverload_EnterState(ProtectionOverloadSM *sm, ProtectionOverloadState state) {
+    PROTECTION_OVERLOAD_PROBE3(state_change, sm, sm->state, state);
+    sm->state = state;
+    PROTECTION_OVERLOAD_TRACE_POINT(TRACE_STATE_ENTRY, sm, state, sm->accumulated_energy);
+    if (sm->hooks != NULL) {
+        ProtectionOverload_Notify(sm, *(const ProtectionOverloadHook *)((const char *)sm->hooks + ProtectionOverload_EntryHook[state]));
+    }
 }
 
 // State Machine Initialization
-void ProtectionOverload_SM_Init(ProtectionOverloadParams *params) {
-    // Init SM state
-    ProtectionOverload_SM_EnterState(ST_IDLE);
+void ProtectionOverload_Init(ProtectionOverloadSM *sm, const ProtectionOverloadParams *params, float call_rate_sec) {
+    // Clear energy storage
+    sm->accumulated_energy = 0.0f;
+    sm->overload_factor = 0.0f;
+    sm->tripped_sec = 0.0f;
+    sm->trips = 0;
+    sm->generation = atomic_fetch_add_explicit(&sm_generations, 1u, memory_order_relaxed) + 1u;
 
-    // Get call rate
-    sm.call_rate_sec = ProtectionOverload_SM_GetCallRate();
+    // Init SM state (no hooks registered yet: no entry action, no previous state)
+    sm->hooks = NULL;
+    sm->state = ST_IDLE;
+    ProtectionOverload_EnterState(sm, ST_IDLE);
 
-    // Clear energy storage
-    sm.accumulated_energy = 0.0f;
+    // Set call rate
+    sm->call_rate_sec = call_rate_sec;
+
+    // Init operating parameters and state levels
+    sm->params = *params;
+    sm->pickup_factor = ProtectionOverload_PickupFactor(params);
+    sm->dropout_factor = ProtectionOverload_DropoutFactor(params);
+
+#if defined(PROTECTION_OVERLOAD_USE_LUT)
+    // Build trip rate table of the selected curve
+    ProtectionOverload_LutInit(params->curve);
+#endif
+}
+
+// Trip time at an overload factor above pickup [s]
+static inline float ProtectionOverload_TripTime(const ProtectionOverloadSM *sm, float overload_factor) {
+    // Compute inverse-time trip curve: t_trip = k / ((I/I_trip)^n - 1)
+#if defined(PROTECTION_OVERLOAD_USE_LUT)
+    return sm->params.k_factor / ProtectionOverload_LutCurveTerm(sm->params.curve, overload_factor);
+#else
+    return sm->params.k_factor / ProtectionOverload_CurveTerm(sm->params.curve, overload_factor);
+#endif
+}
+
+// Heating above the dropout level: energy += elapsed / t_trip, trip at 1.0
+static inline void ProtectionOverload_Heat(ProtectionOverloadSM *sm, float overload_factor, float elapsed_sec) {
+    float trip_time_sec = ProtectionOverload_TripTime(sm, overload_factor);
+
+    // Accumulate energy based on time step
+    float energy = sm->accumulated_energy + (elapsed_sec / trip_time_sec);
+    PROTECTION_OVERLOAD_TRACE_ENERGY(sm, sm->accumulated_energy, energy);
+    sm->accumulated_energy = energy;
+
+    // Check if accumulated energy exceeds 1.0 (tripping threshold)
+    if (sm->accumulated_energy >= 1.0f) {
+        // Trip protection
+        PROTECTION_OVERLOAD_TRACE_POINT(TRACE_TRIP, sm, 0u, sm->accumulated_energy);
+        PROTECTION_OVERLOAD_PROBE3(trip, sm, ProtectionOverload_FloatBits(sm->accumulated_energy), ProtectionOverload_FloatBits(overload_factor));
+        sm->tripped_sec = 0.0f;
+        sm->trips++;
+        ProtectionOverload_EnterState(sm, ST_OVERLOAD_TRIGGERED);
+    }
+}
+
+// Cooling below pickup: slowly reset energy (hysteresis)
+static inline void ProtectionOverload_Cool(ProtectionOverloadSM *sm, float elapsed_sec) {
+    sm->accumulated_energy -= elapsed_sec / sm->params.max_energy;
+    if (sm->accumulated_energy < 0.0f) sm->accumulated_energy = 0.0f;
+}
+
+// ST_IDLE: cooling, pickup above the pickup level
+static void ProtectionOverload_StepIdle(ProtectionOverloadSM *sm, float current, float elapsed_sec) {
+    // Compute overload factor: I / I_trip
+    float overload_factor = current / sm->params.overload_threshold;
+    sm->overload_factor = overload_factor;
+
+    if (overload_factor > sm->pickup_factor) {
+        PROTECTION_OVERLOAD_TRACE_POINT(TRACE_PICKUP, sm, 0u, overload_factor);
+        ProtectionOverload_EnterState(sm, ST_PICKUP);
+        ProtectionOverload_Heat(sm, overload_factor, elapsed_sec);
+    } else {
+        ProtectionOverload_Cool(sm, elapsed_sec);
+    }
+}
+
+// ST_PICKUP: heating until trip, dropout at the dropout level
+static void ProtectionOverload_StepPickup(ProtectionOverloadSM *sm, float current, float elapsed_sec) {
+    float overload_factor = current / sm->params.overload_threshold;
+    sm->overload_factor = overload_factor;
+
+    if (overload_factor > sm->dropout_factor) {
+        ProtectionOverload_Heat(sm, overload_factor, elapsed_sec);
+    } else {
+        ProtectionOverload_EnterState(sm, ST_IDLE);
+        ProtectionOverload_Cool(sm, elapsed_sec);
+    }
+}
+
+// Remaining lockout of a tripped protection [s]
+static inline float ProtectionOverload_Lockout(const ProtectionOverloadSM *sm) {
+    return ProtectionOverload_LockoutTime(sm->accumulated_energy, sm->params.max_energy, sm->params.lockout_energy, sm->tripped_sec);
+}
+
+// Re-arm after a trip: the thermal image at this time becomes the energy
+// (EVENT_RESET, not a dropout)
+static void ProtectionOverload_Rearm(ProtectionOverloadSM *sm) {
+    sm->accumulated_energy = ProtectionOverload_TrippedEnergy(sm->accumulated_energy, sm->params.max_energy, sm->tripped_sec);
+    sm->overload_factor = 0.0f;
+    sm->tripped_sec = 0.0f;
+    PROTECTION_OVERLOAD_PROBE3(state_change, sm, sm->state, ST_IDLE);
+    sm->state = ST_IDLE;
+    PROTECTION_OVERLOAD_TRACE_POINT(TRACE_STATE_ENTRY, sm, ST_IDLE, sm->accumulated_energy);
+    if (sm->hooks != NULL) {
+        ProtectionOverload_Notify(sm, sm->hooks->on_reset);
+    }
+}
+
+// ST_OVERLOAD_TRIGGERED: remain in this state until ProtectionOverload_Reset,
+// or until the end of the lockout with automatic re-arm
+static void ProtectionOverload_StepTriggered(ProtectionOverloadSM *sm, float current, float elapsed_sec) {
+    (void)current;
+    sm->tripped_sec += elapsed_sec;
+    if (sm->params.auto_reset && ProtectionOverload_Lockout(sm) <= 0.0f) {
+        ProtectionOverload_Rearm(sm);
+    }
+}
+
+// Step of each state: one indexed call per tick, the idle step has a single
+// compare (no test of the other states)
+typedef void (*ProtectionOverloadStep)(ProtectionOverloadSM *sm, float current, float elapsed_sec);
+static const ProtectionOverloadStep ProtectionOverload_StateStep[ST_COUNT] = {
+    [ST_IDLE]               = ProtectionOverload_StepIdle,
+    [ST_OVERLOAD_TRIGGERED] = ProtectionOverload_StepTriggered,
+    [ST_PICKUP]             = ProtectionOverload_StepPickup
+};
+
+// State machine step over elapsed time [s]
+static inline void ProtectionOverload_Step(ProtectionOverloadSM *sm, float current, float elapsed_sec) {
+    PROTECTION_OVERLOAD_PROBE2(run_entry, sm, ProtectionOverload_FloatBits(current));
+    ProtectionOverload_StateStep[sm->state](sm, current, elapsed_sec);
+    PROTECTION_OVERLOAD_PROBE2(run_return, sm, sm->state);
+}
+
+// Run state machine (called periodically with the measured current)
+void ProtectionOverload_Run(ProtectionOverloadSM *sm, float current) {
+    ProtectionOverload_Step(sm, current, sm->call_rate_sec);
+}
+
+// Run state machine over the time elapsed since the previous evaluation
+void ProtectionOverload_RunElapsed(ProtectionOverloadSM *sm, float current, float elapsed_sec) {
+    ProtectionOverload_Step(sm, current, elapsed_sec);
+}
+
+// Next evaluation interval [s]: max_sec while idle and cool, shorter as energy
+// approaches 1.0, and above pickup at most half of the remaining time to trip
+// (the trip is detected at most min_sec late). A pickup between two evaluations
+// is seen up to one interval late. Tripped with automatic re-arm: the remaining
+// lockout, even above max_sec (nothing to detect before).
+float ProtectionOverload_GetNextInterval(const ProtectionOverloadSM *sm, float min_sec, float max_sec) {
+    if (sm->state == ST_OVERLOAD_TRIGGERED) {
+        float lockout = ProtectionOverload_Lockout(sm);
+        return (sm->params.auto_reset && lockout > max_sec) ? lockout : max_sec;
+    }
+
+    float interval = max_sec * (1.0f - sm->accumulated_energy);
+    if (sm->state == ST_PICKUP) {
+        float time_to_trip = (1.0f - sm->accumulated_energy) * ProtectionOverload_TripTime(sm, sm->overload_factor);
+        if (0.5f * time_to_trip < interval) {
+            interval = 0.5f * time_to_trip;
+        }
+    }
+
+    if (interval < min_sec) interval = min_sec;
+    if (interval > max_sec) interval = max_sec;
+    return interval;
+}
+
+/* Returns current state machine state */
+ProtectionOverloadState ProtectionOverload_GetState(const ProtectionOverloadSM *sm) {
+    return (ProtectionOverloadState)sm->state;
+}
+
+/* Returns accumulated energy (1.0 = trip) */
+float ProtectionOverload_GetEnergy(const ProtectionOverloadSM *sm) {
+    return sm->accumulated_energy;
+}
+
+/* Returns number of trips since Init */
+uint32_t ProtectionOverload_GetTrips(const ProtectionOverloadSM *sm) {
+    return sm->trips;
+}
 
-    // Init operating parameters
-    sm.params = *params;
+/* Returns the Init sequence number (changes on every Init) */
+uint32_t ProtectionOverload_GetGeneration(const ProtectionOverloadSM *sm) {
+    return sm->generation;
+}
+
+// Register transition hooks (NULL: none), kept until the next Init
+void ProtectionOverload_SetHooks(ProtectionOverloadSM *sm, const ProtectionOverloadHooks *hooks) {
+    sm->hooks = hooks;
+}
+
+// Reset command: re-arm a tripped protection once the lockout has expired
+// (false: still locked out). Not tripped: nothing to reset.
+bool ProtectionOverload_Reset(ProtectionOverloadSM *sm) {
+    if (sm->state != ST_OVERLOAD_TRIGGERED) {
+        return true;
+    }
+    if (ProtectionOverload_Lockout(sm) > 0.0f) {
+        return false;
+    }
+    ProtectionOverload_Rearm(sm);
+    return true;
+}
+
+/* Returns remaining lockout [s] (0: reset allowed or not tripped) */
+float ProtectionOverload_GetLockoutTime(const ProtectionOverloadSM *sm) {
+    return (sm->state == ST_OVERLOAD_TRIGGERED) ? ProtectionOverload_Lockout(sm) : 0.0f;
+}
+
+/* ------------------------------------------------ 
+        Single instance API
+   ------------------------------------------------ */
+
+// State Machine Initialization
+void ProtectionOverload_SM_Init(ProtectionOverloadParams *params) {
+    ProtectionOverload_Init(&sm_default, params, ProtectionOverload_SM_GetCallRate());
+    sm_tick = 0;
+    ProtectionOverload_SnapshotPublish(&sm_snapshot, &sm_default, sm_tick);
+    if (sm_tap != NULL && sm_tap->on_init != NULL) {
+        sm_tap->on_init(sm_tap->context, params);
+    }
 }
 
 // Return protection call rate [s]
@@ -37,60 +285,41 @@ float ProtectionOverload_SM_GetCallRate(void) {
 
 // Run state machine (called periodically)
 void ProtectionOverload_SM_Run() {
-
-    // Protection State Machine
-    switch (sm.state) {
-
-        case ST_IDLE: {
-
-            // Entry function
-            if (sm.entry) {
-                // Reset entry flag
-                sm.entry = false;
-            }
-
-            // Read current sensor value
-            float maxCurrent = Sensor_Read();
-            
-            // Compute overload factor: I / I_trip
-            float overload_factor = maxCurrent / sm.params.overload_threshold;
-
-            if (overload_factor > 1.15f) {
-
-                // Compute inverse-time trip curve: t_trip = k / ((I/I_trip)^n - 1)
-                float trip_time_sec = sm.params.k_factor / (powf(overload_factor, 2)-1);
-
-                // Accumulate energy based on time step
-                sm.accumulated_energy += (sm.call_rate_sec / trip_time_sec);
-
-                // Check if accumulated energy exceeds 1.0 (tripping threshold)
-                if (sm.accumulated_energy >= 1.0f) {
-                    // Trip protection
-                    ProtectionOverload_SM_EnterState(ST_OVERLOAD_TRIGGERED);
-                }
-            } else {
-                // If current drops below threshold, slowly reset energy (hysteresis)
-                sm.accumulated_energy -= sm.call_rate_sec / sm.params.max_energy;
-                if (sm.accumulated_energy < 0.0f) sm.accumulated_energy = 0.0f;
-            }
-            break;
-        }
-        
-        case ST_OVERLOAD_TRIGGERED:
-
-            // Entry function
-            if (sm.entry) {
-                // Reset entry flag
-                sm.entry = false;
-            }
-    
-            // Once triggered, remain in this state until reset (not implemented here)
-            break;
+    // Read current sensor value
+    float current = Sensor_Read();
+    ProtectionOverload_Run(&sm_default, current);
+    ProtectionOverload_SnapshotPublish(&sm_snapshot, &sm_default, ++sm_tick);
+    if (sm_tap != NULL && sm_tap->on_tick != NULL) {
+        sm_tap->on_tick(sm_tap->context, current, (ProtectionOverloadState)sm_default.state);
     }
 }
 
-/* Returns current state machine state */
+/* Returns current state machine state (published state: safe from any thread) */
 ProtectionOverloadState ProtectionOverload_SM_GetState() {
-    return sm.state;
+    return (ProtectionOverloadState)atomic_load_explicit(&sm_snapshot.state, memory_order_relaxed);
+}
+
+// Register transition hooks of the single instance (after SM_Init)
+void ProtectionOverload_SM_SetHooks(const ProtectionOverloadHooks *hooks) {
+    ProtectionOverload_SetHooks(&sm_default, hooks);
+}
+
+// Reset command of the single instance (false: locked out)
+bool ProtectionOverload_SM_Reset() {
+    bool reset = ProtectionOverload_Reset(&sm_default);
+    ProtectionOverload_SnapshotPublish(&sm_snapshot, &sm_default, sm_tick);
+    if (sm_tap != NULL && sm_tap->on_reset != NULL) {
+        sm_tap->on_reset(sm_tap->context);
+    }
+    return reset;
+}
+
+// Register the input tap of the single instance (NULL: none)
+void ProtectionOverload_SM_SetInputTap(const ProtectionOverloadInputTap *tap) {
+    sm_tap = tap;
+}
+
+/* Returns consistent state, energy, overload factor and tick of the last Run */
+void ProtectionOverload_SM_GetSnapshot(ProtectionOverloadSnapshot *snapshot) {
+    ProtectionOverload_SnapshotRead(&sm_snapshot, snapshot);
 }
-    
@@ -3,35 +3,128 @@
 #pragma once
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define PROTECTION_OVERLOAD_PICKUP  1.15f   // Default pickup overload factor (I / I_trip)
+
+// Float bits and back (bit-exact logs and counters, float bit arithmetic)
+static inline uint32_t ProtectionOverload_FloatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static inline float ProtectionOverload_BitsFloat(uint32_t bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Adaptive call rate: evaluation interval bounds [s]
+#define PROTECTION_OVERLOAD_ADAPTIVE_MIN_SEC    0.001f  // Near trip: trip time resolution
+#define PROTECTION_OVERLOAD_ADAPTIVE_MAX_SEC    0.1f    // Idle and cool: pickup detection latency
 
 // State Machine States
 typedef enum {
-    ST_IDLE,                            // Protection active and running
-    ST_OVERLOAD_TRIGGERED               // Protection triggered Breaker opening 
+    ST_IDLE,                            // Protection active and running (below pickup: cooling)
+    ST_OVERLOAD_TRIGGERED,              // Protection triggered Breaker opening 
+    ST_PICKUP,                          // Picked up, timing (above dropout level: heating)
+    ST_COUNT
 } ProtectionOverloadState;
 
+// Inverse-time curve families: t_trip = k / ((I/I_trip)^alpha - 1)
+typedef enum {
+    CURVE_I2T,                          // alpha = 2, IEC 60947-2 thermal (default)
+    CURVE_IT,                           // alpha = 1, IEC 60255 very inverse form
+    CURVE_STANDARD_INVERSE              // alpha = 0.02, IEC 60255 standard inverse form
+} ProtectionOverloadCurve;
+
+// Transition events
+typedef enum {
+    EVENT_PICKUP,                       // Overload factor rose above pickup: heating starts
+    EVENT_TRIP,                         // Protection tripped
+    EVENT_RESET,                        // Protection re-armed (ProtectionOverload_Reset)
+    EVENT_DROPOUT                       // Overload factor fell to the dropout level: cooling starts
+} ProtectionOverloadEvent;
+
 // Parameters Structure
 typedef struct {
     float overload_threshold;           // Current threshold
     float k_factor;                     // IEC 60947 protection k
     float cooling_rate;
     float max_energy;
+    ProtectionOverloadCurve curve;      // Trip curve family
+    float pickup_ratio;                 // Pickup overload factor (0: PROTECTION_OVERLOAD_PICKUP)
+    float dropout_ratio;                // Dropout level / pickup level (0: 1.0, no hysteresis)
+    float lockout_energy;               // Reset locked out while the thermal image is above (0: no lockout)
+    bool auto_reset;                    // Re-arm automatically at the end of the lockout
 } ProtectionOverloadParams;
 
-// State Machine parameters
+typedef struct ProtectionOverloadHooks ProtectionOverloadHooks;
+
+// State Machine parameters: fields used every tick first, configuration after
 typedef struct {
-    ProtectionOverloadState state;      // Current state
-    bool entry;                         // State entry flag
+    float accumulated_energy;           // Energy accumulator
+    float overload_factor;              // Last evaluated overload factor (I / I_trip)
+    float pickup_factor;                // ST_IDLE -> ST_PICKUP above this overload factor
+    float dropout_factor;               // ST_PICKUP -> ST_IDLE at or below this overload factor
+    uint8_t state;                      // Current state (ProtectionOverloadState)
+    float tripped_sec;                  // Time since trip [s] (thermal image and lockout)
     float call_rate_sec;                // Call rate [s]
     ProtectionOverloadParams params;    // Operating parameters
-    float accumulated_energy;           // Energy accumulator
+    const ProtectionOverloadHooks *hooks;       // Transition hooks (NULL: none)
+    uint32_t trips;                     // Trips since Init (EVENT_TRIP count)
+    uint32_t generation;                // Init sequence number (a new value on every Init)
 } ProtectionOverloadSM;
 
-// API Functions
+// Transition hooks: called by the state machine on the tick of the transition,
+// from the task running it (NULL members are skipped)
+typedef void (*ProtectionOverloadHook)(void *context, const ProtectionOverloadSM *sm);
+struct ProtectionOverloadHooks {
+    ProtectionOverloadHook on_pickup;   // EVENT_PICKUP
+    ProtectionOverloadHook on_trip;     // EVENT_TRIP
+    ProtectionOverloadHook on_reset;    // EVENT_RESET
+    ProtectionOverloadHook on_dropout;  // EVENT_DROPOUT
+    void *context;                      // First argument of the hooks
+};
+
+// Instance API Functions (caller owns the state machine and provides the current)
+void ProtectionOverload_Init(ProtectionOverloadSM *sm, const ProtectionOverloadParams *params, float call_rate_sec);
+void ProtectionOverload_Run(ProtectionOverloadSM *sm, float current);
+ProtectionOverloadState ProtectionOverload_GetState(const ProtectionOverloadSM *sm);
+float ProtectionOverload_GetEnergy(const ProtectionOverloadSM *sm);
+uint32_t ProtectionOverload_GetTrips(const ProtectionOverloadSM *sm);
+uint32_t ProtectionOverload_GetGeneration(const ProtectionOverloadSM *sm);
+void ProtectionOverload_SetHooks(ProtectionOverloadSM *sm, const ProtectionOverloadHooks *hooks);
+
+// Reset after a trip: false while locked out. GetLockoutTime is the remaining
+// lockout [s], in closed form from the energy at trip and the time since.
+bool ProtectionOverload_Reset(ProtectionOverloadSM *sm);
+float ProtectionOverload_GetLockoutTime(const ProtectionOverloadSM *sm);
+
+// Adaptive call rate (tickless callers): run over the actual elapsed time, then
+// schedule the next evaluation after the returned interval [s]
+void ProtectionOverload_RunElapsed(ProtectionOverloadSM *sm, float current, float elapsed_sec);
+float ProtectionOverload_GetNextInterval(const ProtectionOverloadSM *sm, float min_sec, float max_sec);
+
+// Input tap of the single instance: every input of the engine (parameters,
+// Sensor_Read values, reset commands) for record and replay (NULL members are skipped)
+typedef struct {
+    void (*on_init)(void *context, const ProtectionOverloadParams *params);    // After SM_Init
+    void (*on_tick)(void *context, float current, ProtectionOverloadState state);  // After SM_Run: Sensor_Read value, new state
+    void (*on_reset)(void *context);                                           // After SM_Reset, accepted or not
+    void *context;                      // First argument of the members
+} ProtectionOverloadInputTap;
+
+// API Functions (single instance, current read from Sensor_Read)
 void ProtectionOverload_SM_Init(ProtectionOverloadParams *params);
 float ProtectionOverload_SM_GetCallRate();
 void ProtectionOverload_SM_Run();
 ProtectionOverloadState ProtectionOverload_SM_GetState();
+void ProtectionOverload_SM_SetHooks(const ProtectionOverloadHooks *hooks);
+bool ProtectionOverload_SM_Reset();
+void ProtectionOverload_SM_SetInputTap(const ProtectionOverloadInputTap *tap);
 
 // Sensor input function (mocked in tests)
-float Sensor_Read();
\ No newline at end of file
+float Sensor_Read();
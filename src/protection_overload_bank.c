@@ -0,0 +1,184 @@
+// Protection Overload Bank
+
+#include "protection_overload_bank.h"
+#include "protection_overload_curve.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Active set of up to 64 channels: above pickup level
+static inline uint64_t ProtectionOverload_BankActiveWord(const float *currents, const float *pickup_current, unsigned int n) {
+    uint64_t mask = 0;
+    unsigned int j = 0;
+#if defined(__SSE2__)
+    // 4 channels per compare, sign bits packed by movemask
+    for (; j + 4 <= n; j += 4) {
+        __m128 above = _mm_cmpgt_ps(_mm_loadu_ps(currents + j), _mm_loadu_ps(pickup_current + j));
+        mask |= (uint64_t)_mm_movemask_ps(above) << j;
+    }
+#endif
+    for (; j < n; j++) {
+        mask |= (uint64_t)(currents[j] > pickup_current[j]) << j;
+    }
+    return mask;
+}
+
+// Energy after cooling over a number of ticks (closed form of the per-tick decrement)
+static inline float ProtectionOverload_BankCooled(const ProtectionOverloadBank *bank, unsigned int i, uint32_t ticks) {
+    float energy = bank->channel[i].energy;
+    if (ticks != 0 && energy > 0.0f) {
+        energy -= (float)ticks * (bank->call_rate_sec / bank->params[i].max_energy);
+        if (energy < 0.0f) energy = 0.0f;
+    }
+    return energy;
+}
+
+// Channel not tripped
+static inline bool ProtectionOverload_BankArmed(const ProtectionOverloadBank *bank, unsigned int i) {
+    return (bank->armed[i / 64u] >> (i % 64u)) & 1u;
+}
+
+// Bring every armed channel to the current tick (keeps tick differences below 2^32)
+static void ProtectionOverload_BankSettle(ProtectionOverloadBank *bank) {
+    for (unsigned int i = 0; i < bank->count; i++) {
+        if (ProtectionOverload_BankArmed(bank, i)) {
+            bank->channel[i].energy = ProtectionOverload_BankCooled(bank, i, bank->tick - bank->channel[i].last_tick);
+            bank->channel[i].last_tick = bank->tick;
+        }
+    }
+}
+
+// Array size rounded up to whole cache lines [bytes]
+static inline size_t ProtectionOverload_BankLines(size_t size) {
+    return (size + PROTECTION_OVERLOAD_BANK_ALIGN - 1u) & ~(size_t)(PROTECTION_OVERLOAD_BANK_ALIGN - 1u);
+}
+
+// Storage block size [bytes]
+size_t ProtectionOverload_BankStorageSize(unsigned int count) {
+    size_t words = PROTECTION_OVERLOAD_BANK_WORDS(count);
+    return 2u * ProtectionOverload_BankLines(words * sizeof(uint64_t)) +
+           ProtectionOverload_BankLines(count * sizeof(float)) +
+           ProtectionOverload_BankLines(count * sizeof(ProtectionOverloadBankChannel));
+}
+
+// Storage arrays in one block, in order of use by BankRun
+void ProtectionOverload_BankStorageInit(ProtectionOverloadBankStorage *storage, void *block, unsigned int count) {
+    size_t words = PROTECTION_OVERLOAD_BANK_WORDS(count);
+    unsigned char *next = block;
+
+    storage->armed = (uint64_t *)next;
+    next += ProtectionOverload_BankLines(words * sizeof(uint64_t));
+    storage->active = (uint64_t *)next;
+    next += ProtectionOverload_BankLines(words * sizeof(uint64_t));
+    storage->pickup_current = (float *)next;
+    next += ProtectionOverload_BankLines(count * sizeof(float));
+    storage->channel = (ProtectionOverloadBankChannel *)next;
+}
+
+// Bank Initialization
+bool ProtectionOverload_BankInit(ProtectionOverloadBank *bank, const ProtectionOverloadParams *params,
+                                 unsigned int count, float call_rate_sec, const ProtectionOverloadBankStorage *storage) {
+    // Heating between dropout and pickup, and re-arm, are not in the bank step
+    for (unsigned int i = 0; i < count; i++) {
+        if (ProtectionOverload_DropoutFactor(&params[i]) < ProtectionOverload_PickupFactor(&params[i]) || params[i].auto_reset) {
+            return false;
+        }
+    }
+
+    bank->params = params;
+    bank->count = count;
+    bank->call_rate_sec = call_rate_sec;
+    bank->pickup_current = storage->pickup_current;
+    bank->channel = storage->channel;
+    bank->armed = storage->armed;
+    bank->active = storage->active;
+    bank->active_count = 0;
+    bank->tick = 0;
+
+    for (unsigned int i = 0; i < count; i++) {
+        bank->pickup_current[i] = params[i].overload_threshold * ProtectionOverload_PickupFactor(&params[i]) *
+                                  PROTECTION_OVERLOAD_BANK_PICKUP_MARGIN;
+        bank->channel[i].energy = 0.0f;
+        bank->channel[i].last_tick = 0;
+    }
+    for (unsigned int w = 0; w < PROTECTION_OVERLOAD_BANK_WORDS(count); w++) {
+        unsigned int n = count - w * 64u;
+        bank->armed[w] = (n >= 64u) ? UINT64_MAX : ((UINT64_C(1) << n) - 1u);
+        bank->active[w] = 0;
+    }
+    return true;
+}
+
+// Run all channels (called periodically with the measured currents [count])
+void ProtectionOverload_BankRun(ProtectionOverloadBank *bank, const float *currents) {
+    uint32_t tick = ++bank->tick;
+    unsigned int active_count = 0;
+
+    for (unsigned int w = 0; w < PROTECTION_OVERLOAD_BANK_WORDS(bank->count); w++) {
+        unsigned int base = w * 64u;
+        unsigned int n = (bank->count - base < 64u) ? bank->count - base : 64u;
+
+        // Active set: tripped channels are no longer evaluated
+        uint64_t active = ProtectionOverload_BankActiveWord(currents + base, bank->pickup_current + base, n) & bank->armed[w];
+        uint64_t heating = active;
+        active_count += (unsigned int)__builtin_popcountll(active);
+
+        // State machine step of active channels only: pending cooling, then ProtectionOverload_Run heating
+        while (active != 0) {
+            unsigned int i = base + (unsigned int)__builtin_ctzll(active);
+            active &= active - 1u;
+
+            const ProtectionOverloadParams *params = &bank->params[i];
+            ProtectionOverloadBankChannel *channel = &bank->channel[i];
+            float overload_factor = currents[i] / params->overload_threshold;
+
+            // Pending cooling of the ticks since the last update
+            float energy = ProtectionOverload_BankCooled(bank, i, tick - channel->last_tick - 1u);
+
+            if (overload_factor > ProtectionOverload_PickupFactor(params)) {
+                float trip_time_sec = params->k_factor / ProtectionOverload_CurveTerm(params->curve, overload_factor);
+                energy += (bank->call_rate_sec / trip_time_sec);
+                if (energy >= 1.0f) {
+                    // Trip protection
+                    bank->armed[w] &= ~(UINT64_C(1) << (i - base));
+                }
+            } else {
+                // Prefilter margin: cooling tick, not picked up
+                heating &= ~(UINT64_C(1) << (i - base));
+                if (energy > 0.0f) {
+                    energy -= bank->call_rate_sec / params->max_energy;
+                    if (energy < 0.0f) energy = 0.0f;
+                }
+            }
+            channel->energy = energy;
+            channel->last_tick = tick;
+        }
+        bank->active[w] = heating;
+    }
+    bank->active_count = active_count;
+
+    if (tick % PROTECTION_OVERLOAD_BANK_SETTLE_TICKS == 0) {
+        ProtectionOverload_BankSettle(bank);
+    }
+}
+
+/* Returns channel state (ST_PICKUP: heated by the last tick) */
+ProtectionOverloadState ProtectionOverload_BankGetState(const ProtectionOverloadBank *bank, unsigned int channel) {
+    if (!ProtectionOverload_BankArmed(bank, channel)) {
+        return ST_OVERLOAD_TRIGGERED;
+    }
+    return ((bank->active[channel / 64u] >> (channel % 64u)) & 1u) ? ST_PICKUP : ST_IDLE;
+}
+
+/* Returns channel accumulated energy (1.0 = trip), cooling applied up to the last tick */
+float ProtectionOverload_BankGetEnergy(const ProtectionOverloadBank *bank, unsigned int channel) {
+    if (!ProtectionOverload_BankArmed(bank, channel)) {
+        return bank->channel[channel].energy;
+    }
+    return ProtectionOverload_BankCooled(bank, channel, bank->tick - bank->channel[channel].last_tick);
+}
+
+/* Returns number of channels processed by the last tick */
+unsigned int ProtectionOverload_BankGetActiveCount(const ProtectionOverloadBank *bank) {
+    return bank->active_count;
+}
@@ -0,0 +1,92 @@
+// Protection Overload Bank Header
+//
+// Multi-channel engine for large feeder panels. Channel state is kept as
+// arrays (structure of arrays) so that each tick starts with one vector
+// compare of all currents against the pickup levels: the result is an active
+// set bitmap of the channels above pickup. Only the active channels get the
+// state machine step, iterated by count-trailing-zeros over the bitmap, so the
+// per-tick cost scales with the active channels.
+//
+// Cooling is lazy: each channel stores its energy with the tick of its last
+// update, and the closed-form cooling since then is applied only when the
+// channel is next heated or read. Channels below pickup are not written at
+// all. Up to its trip, a channel's energy matches one ProtectionOverloadSM
+// within float rounding, and it trips on the same tick (checked in
+// test_protection_overload_bank.c).
+// Storage is provided by the caller, as separate arrays or carved from one
+// cache-line aligned block (ProtectionOverload_BankStorageInit).
+//
+// Per tick, a channel below pickup costs its current, its pickup level and
+// one armed bit (8 bytes); the channel record and the parameters are only
+// read for active channels.
+//
+// Channels pick up at the pickup ratio of their parameters. A channel reads
+// ST_PICKUP when the last tick heated it. The bank has no dropout band and no
+// re-arm: ProtectionOverload_BankInit rejects a dropout ratio below 1 and
+// auto_reset, and a tripped channel stays tripped until the next BankInit
+// (lockout_energy has no effect).
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stddef.h>
+#include <stdint.h>
+
+// Bitmap words for a number of channels
+#define PROTECTION_OVERLOAD_BANK_WORDS(count)   (((count) + 63u) / 64u)
+
+// Cache line size: every array of a storage block starts on its own line
+#define PROTECTION_OVERLOAD_BANK_ALIGN          64u
+
+// Prefilter margin: the compare against threshold * pickup must never skip a
+// channel whose overload factor (I / I_trip) is above pickup after rounding
+#define PROTECTION_OVERLOAD_BANK_PICKUP_MARGIN  0.9999f
+
+// Bank ticks between two settle passes (every channel brought to the current
+// tick, so that tick differences never wrap): 2^31 ticks = 248 days at 10 ms
+#ifndef PROTECTION_OVERLOAD_BANK_SETTLE_TICKS
+#define PROTECTION_OVERLOAD_BANK_SETTLE_TICKS   0x80000000u
+#endif
+
+// Channel thermal state: 8 bytes, 8 channels per cache line
+typedef struct {
+    float energy;                       // Energy at last_tick (cooling not applied since)
+    uint32_t last_tick;                 // Bank tick of last update
+} ProtectionOverloadBankChannel;
+
+// Channel storage (arrays of count channels, bitmaps of BANK_WORDS(count))
+typedef struct {
+    float *pickup_current;              // Prefilter level: threshold * pickup * margin
+    ProtectionOverloadBankChannel *channel;     // Energy and last update tick
+    uint64_t *armed;                    // Bitmap: channel not tripped
+    uint64_t *active;                   // Bitmap: channels heated by the last tick
+} ProtectionOverloadBankStorage;
+
+// Size of one storage block for a number of channels [bytes]
+size_t ProtectionOverload_BankStorageSize(unsigned int count);
+
+// Carve the storage arrays from a block of BankStorageSize(count) bytes aligned
+// to PROTECTION_OVERLOAD_BANK_ALIGN: bitmaps, pickup levels, channel records
+void ProtectionOverload_BankStorageInit(ProtectionOverloadBankStorage *storage, void *block, unsigned int count);
+
+// Bank of protection channels
+typedef struct {
+    const ProtectionOverloadParams *params;     // Channel parameters [count]
+    unsigned int count;                 // Number of channels
+    float call_rate_sec;                // Call rate [s]
+    float *pickup_current;              // Prefilter level [count]
+    ProtectionOverloadBankChannel *channel;     // Channel thermal state [count]
+    uint64_t *armed;                    // Not tripped bitmap
+    uint64_t *active;                   // Heated channels bitmap (ST_PICKUP)
+    unsigned int active_count;          // Channels processed by the last tick
+    uint32_t tick;                      // Ticks run since Init
+} ProtectionOverloadBank;
+
+// Bank API
+// Init: false if a channel has a dropout band (dropout_ratio < 1) or auto_reset
+bool ProtectionOverload_BankInit(ProtectionOverloadBank *bank, const ProtectionOverloadParams *params,
+                                 unsigned int count, float call_rate_sec, const ProtectionOverloadBankStorage *storage);
+void ProtectionOverload_BankRun(ProtectionOverloadBank *bank, const float *currents);
+ProtectionOverloadState ProtectionOverload_BankGetState(const ProtectionOverloadBank *bank, unsigned int channel);
+float ProtectionOverload_BankGetEnergy(const ProtectionOverloadBank *bank, unsigned int channel);
+unsigned int ProtectionOverload_BankGetActiveCount(const ProtectionOverloadBank *bank);
@@ -0,0 +1,391 @@
+// Protection Overload Capture
+
+#include "protection_overload_capture.h"
+#include "protection_overload_snapshot.h"
+#include <string.h>
+
+#define CAPTURE_PARAM_WORDS 9u          // Serialized parameters [32-bit words]
+
+/* ------------------------------------------------
+        Encoding
+   ------------------------------------------------ */
+
+static inline uint64_t Capture_ZigZag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static inline int64_t Capture_UnZigZag(uint64_t value) {
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1u);
+}
+
+static inline void Capture_PutVarint(ProtectionOverloadCapture *capture, uint64_t value) {
+    while (value >= 0x80u) {
+        capture->buffer[capture->used++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    capture->buffer[capture->used++] = (uint8_t)value;
+}
+
+// Room for a token: flush a full buffer, or stop the capture without a flush callback
+static bool Capture_Reserve(ProtectionOverloadCapture *capture, size_t bytes) {
+    if (capture->overflow) {
+        return false;
+    }
+    if (capture->used + bytes > capture->size) {
+        if (capture->flush == NULL) {
+            capture->overflow = true;
+            return false;
+        }
+        capture->flush(capture->flush_context, capture->buffer, capture->used);
+        capture->used = 0;
+    }
+    return true;
+}
+
+// Counted bytes of the token written since used_before
+static inline void Capture_Count(ProtectionOverloadCapture *capture, size_t used_before) {
+    capture->bytes += capture->used - used_before;
+}
+
+// Pending repeated samples, before any other token
+static void Capture_FlushRun(ProtectionOverloadCapture *capture) {
+    if (capture->run == 0 || !Capture_Reserve(capture, 5u)) {
+        return;
+    }
+    size_t used = capture->used;
+    Capture_PutVarint(capture, ((uint64_t)capture->run << 2) | 1u);
+    Capture_Count(capture, used);
+    capture->run = 0;
+}
+
+static void Capture_Command(ProtectionOverloadCapture *capture, ProtectionOverloadCaptureCommand command,
+                            const uint32_t *words, uint32_t count, bool varints) {
+    Capture_FlushRun(capture);
+    if (!Capture_Reserve(capture, PROTECTION_OVERLOAD_CAPTURE_TOKEN)) {
+        return;
+    }
+    size_t used = capture->used;
+    Capture_PutVarint(capture, ((uint64_t)command << 2) | 3u);
+    for (uint32_t i = 0; i < count; i++) {
+        if (varints) {
+            Capture_PutVarint(capture, words[i]);
+        } else {
+            memcpy(&capture->buffer[capture->used], &words[i], sizeof(words[i]));
+            capture->used += sizeof(words[i]);
+        }
+    }
+    Capture_Count(capture, used);
+}
+
+/* ------------------------------------------------
+        Input tap
+   ------------------------------------------------ */
+
+static void Capture_OnInit(void *context, const ProtectionOverloadParams *params) {
+    ProtectionOverloadCapture *capture = context;
+    uint32_t words[CAPTURE_PARAM_WORDS] = {
+        ProtectionOverload_FloatBits(params->overload_threshold), ProtectionOverload_FloatBits(params->k_factor), ProtectionOverload_FloatBits(params->cooling_rate),
+        ProtectionOverload_FloatBits(params->max_energy), (uint32_t)params->curve, ProtectionOverload_FloatBits(params->pickup_ratio),
+        ProtectionOverload_FloatBits(params->dropout_ratio), ProtectionOverload_FloatBits(params->lockout_energy), (uint32_t)params->auto_reset
+    };
+    Capture_Command(capture, CAPTURE_CMD_INIT, words, CAPTURE_PARAM_WORDS, false);
+    capture->state = (uint8_t)ProtectionOverload_SM_GetState();
+}
+
+static void Capture_OnTick(void *context, float current, ProtectionOverloadState state) {
+    ProtectionOverloadCapture *capture = context;
+    uint32_t bits = ProtectionOverload_FloatBits(current);
+    int64_t step_delta = 0;
+    if (capture->clock != NULL) {
+        uint64_t now = capture->clock();
+        int64_t step = (int64_t)(now - capture->timestamp);
+        step_delta = step - capture->step;
+        capture->timestamp = now;
+        capture->step = step;
+    }
+
+    // Same current on the same step: one more repeated sample
+    uint32_t changed = bits ^ capture->bits;
+    if ((changed | (uint64_t)step_delta) == 0 && capture->run < PROTECTION_OVERLOAD_CAPTURE_RUN_MAX) {
+        capture->run++;
+    } else {
+        Capture_FlushRun(capture);
+        if (Capture_Reserve(capture, 15u)) {
+            size_t used = capture->used;
+            Capture_PutVarint(capture, (uint64_t)changed << 1);
+            if (capture->clock != NULL) {
+                Capture_PutVarint(capture, Capture_ZigZag(step_delta));
+            }
+            Capture_Count(capture, used);
+        }
+        capture->bits = bits;
+    }
+
+    if (state == ST_OVERLOAD_TRIGGERED && capture->state != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverloadSnapshot snapshot;
+        ProtectionOverload_SM_GetSnapshot(&snapshot);
+        uint32_t energy = ProtectionOverload_FloatBits(snapshot.energy);
+        Capture_Command(capture, CAPTURE_CMD_TRIP, &energy, 1u, true);
+    }
+    capture->state = (uint8_t)state;
+}
+
+static void Capture_OnReset(void *context) {
+    ProtectionOverloadCapture *capture = context;
+    Capture_Command(capture, CAPTURE_CMD_RESET, NULL, 0u, true);
+    capture->state = (uint8_t)ProtectionOverload_SM_GetState();
+}
+
+void ProtectionOverload_CaptureStart(ProtectionOverloadCapture *capture, uint8_t *buffer, size_t size,
+                                     ProtectionOverloadCaptureFlush flush, void *flush_context, uint64_t (*clock)(void)) {
+    *capture = (ProtectionOverloadCapture){
+        .tap = {Capture_OnInit, Capture_OnTick, Capture_OnReset, capture},
+        .buffer = buffer,
+        .size = size,
+        .flush = flush,
+        .flush_context = flush_context,
+        .clock = clock,
+        .state = (uint8_t)ProtectionOverload_SM_GetState()
+    };
+    ProtectionOverloadCaptureHeader header = {
+        .magic = PROTECTION_OVERLOAD_CAPTURE_MAGIC,
+        .version = PROTECTION_OVERLOAD_CAPTURE_VERSION,
+        .header_size = sizeof(ProtectionOverloadCaptureHeader),
+        .call_rate_sec = ProtectionOverload_SM_GetCallRate(),
+        .timestamps = (clock != NULL),
+        .start = (clock != NULL) ? clock() : 0u
+    };
+    capture->timestamp = header.start;
+    if (size < sizeof(header) + PROTECTION_OVERLOAD_CAPTURE_TOKEN) {
+        capture->overflow = true;
+    } else {
+        memcpy(buffer, &header, sizeof(header));
+        capture->used = sizeof(header);
+        capture->bytes = sizeof(header);
+    }
+    ProtectionOverload_SM_SetInputTap(&capture->tap);
+}
+
+bool ProtectionOverload_CaptureStop(ProtectionOverloadCapture *capture) {
+    ProtectionOverload_SM_SetInputTap(NULL);
+    ProtectionOverloadSnapshot snapshot;
+    ProtectionOverload_SM_GetSnapshot(&snapshot);
+    uint32_t words[3] = {(uint32_t)snapshot.state, ProtectionOverload_FloatBits(snapshot.energy), snapshot.tick};
+    Capture_Command(capture, CAPTURE_CMD_END, words, 3u, true);
+    if (capture->flush != NULL && capture->used > 0) {
+        capture->flush(capture->flush_context, capture->buffer, capture->used);
+        capture->used = 0;
+    }
+    return !capture->overflow;
+}
+
+/* ------------------------------------------------
+        Decoding
+   ------------------------------------------------ */
+
+static bool Capture_GetVarint(ProtectionOverloadCaptureReader *reader, uint64_t *value) {
+    uint64_t result = 0;
+    for (unsigned int shift = 0; shift < 64u && reader->pos < reader->size; shift += 7u) {
+        uint8_t byte = reader->data[reader->pos++];
+        result |= (uint64_t)(byte & 0x7Fu) << shift;
+        if ((byte & 0x80u) == 0) {
+            *value = result;
+            return true;
+        }
+    }
+    reader->error = true;
+    return false;
+}
+
+static bool Capture_GetWord(ProtectionOverloadCaptureReader *reader, uint32_t *word) {
+    uint64_t value;
+    if (!Capture_GetVarint(reader, &value) || value > UINT32_MAX) {
+        reader->error = true;
+        return false;
+    }
+    *word = (uint32_t)value;
+    return true;
+}
+
+bool ProtectionOverload_CaptureOpen(ProtectionOverloadCaptureReader *reader, const uint8_t *data, size_t size) {
+    *reader = (ProtectionOverloadCaptureReader){.data = data, .size = size};
+    if (size < sizeof(reader->header)) {
+        reader->error = true;
+        return false;
+    }
+    memcpy(&reader->header, data, sizeof(reader->header));
+    if (reader->header.magic != PROTECTION_OVERLOAD_CAPTURE_MAGIC || reader->header.version != PROTECTION_OVERLOAD_CAPTURE_VERSION ||
+        reader->header.header_size != sizeof(reader->header)) {
+        reader->error = true;
+        return false;
+    }
+    reader->pos = sizeof(reader->header);
+    reader->timestamp = reader->header.start;
+    return true;
+}
+
+// Sample with the last current bits, one step later
+static void Capture_Sample(ProtectionOverloadCaptureReader *reader, ProtectionOverloadCaptureEvent *event) {
+    if (reader->header.timestamps) {
+        reader->timestamp += (uint64_t)reader->step;
+    }
+    event->type = CAPTURE_EVENT_SAMPLE;
+    event->current = ProtectionOverload_BitsFloat(reader->bits);
+    event->timestamp = reader->header.timestamps ? reader->timestamp : 0u;
+}
+
+bool ProtectionOverload_CaptureNext(ProtectionOverloadCaptureReader *reader, ProtectionOverloadCaptureEvent *event) {
+    if (reader->error) {
+        return false;
+    }
+    if (reader->run > 0) {
+        reader->run--;
+        Capture_Sample(reader, event);
+        return true;
+    }
+    uint64_t token;
+    if (reader->pos >= reader->size || !Capture_GetVarint(reader, &token)) {
+        return false;
+    }
+
+    if ((token & 1u) == 0) {
+        if ((token >> 1) > UINT32_MAX) {
+            reader->error = true;
+            return false;
+        }
+        reader->bits ^= (uint32_t)(token >> 1);
+        if (reader->header.timestamps) {
+            uint64_t step_delta;
+            if (!Capture_GetVarint(reader, &step_delta)) {
+                return false;
+            }
+            reader->step += Capture_UnZigZag(step_delta);
+        }
+        Capture_Sample(reader, event);
+        return true;
+    }
+    if ((token & 3u) == 1u) {
+        if ((token >> 2) == 0 || (token >> 2) > PROTECTION_OVERLOAD_CAPTURE_RUN_MAX) {
+            reader->error = true;
+            return false;
+        }
+        reader->run = (uint32_t)(token >> 2) - 1u;
+        Capture_Sample(reader, event);
+        return true;
+    }
+
+    switch (token >> 2) {
+    case CAPTURE_CMD_INIT: {
+        uint32_t words[CAPTURE_PARAM_WORDS];
+        if (reader->size - reader->pos < sizeof(words)) {
+            reader->error = true;
+            return false;
+        }
+        memcpy(words, &reader->data[reader->pos], sizeof(words));
+        reader->pos += sizeof(words);
+        event->type = CAPTURE_EVENT_INIT;
+        event->params = (ProtectionOverloadParams){
+            .overload_threshold = ProtectionOverload_BitsFloat(words[0]),
+            .k_factor = ProtectionOverload_BitsFloat(words[1]),
+            .cooling_rate = ProtectionOverload_BitsFloat(words[2]),
+            .max_energy = ProtectionOverload_BitsFloat(words[3]),
+            .curve = (ProtectionOverloadCurve)words[4],
+            .pickup_ratio = ProtectionOverload_BitsFloat(words[5]),
+            .dropout_ratio = ProtectionOverload_BitsFloat(words[6]),
+            .lockout_energy = ProtectionOverload_BitsFloat(words[7]),
+            .auto_reset = (words[8] != 0)
+        };
+        return true;
+    }
+    case CAPTURE_CMD_RESET:
+        event->type = CAPTURE_EVENT_RESET;
+        return true;
+    case CAPTURE_CMD_TRIP:
+        event->type = CAPTURE_EVENT_TRIP;
+        return Capture_GetWord(reader, &event->energy_bits);
+    case CAPTURE_CMD_END: {
+        uint32_t state;
+        event->type = CAPTURE_EVENT_END;
+        if (!Capture_GetWord(reader, &state) || !Capture_GetWord(reader, &event->energy_bits) ||
+            !Capture_GetWord(reader, &event->tick)) {
+            return false;
+        }
+        event->state = (ProtectionOverloadState)state;
+        return true;
+    }
+    default:
+        reader->error = true;
+        return false;
+    }
+}
+
+/* ------------------------------------------------
+        Replay
+   ------------------------------------------------ */
+
+bool ProtectionOverload_CaptureReplay(ProtectionOverloadCaptureReader *reader, float *sensor, ProtectionOverloadReplayResult *result) {
+    *result = (ProtectionOverloadReplayResult){0};
+    ProtectionOverloadCaptureEvent event;
+    ProtectionOverloadSnapshot snapshot;
+    ProtectionOverloadState state = ST_IDLE;
+    bool initialized = false;
+    bool trip_pending = false;          // Replayed trip, its checkpoint must follow
+
+    while (!result->mismatch && ProtectionOverload_CaptureNext(reader, &event)) {
+        if (trip_pending && event.type != CAPTURE_EVENT_TRIP) {
+            result->mismatch = true;
+            break;
+        }
+        switch (event.type) {
+        case CAPTURE_EVENT_INIT:
+            ProtectionOverload_SM_Init(&event.params);
+            state = ProtectionOverload_SM_GetState();
+            initialized = true;
+            break;
+        case CAPTURE_EVENT_SAMPLE:
+            // Samples before the first SM_Init have no known starting state
+            if (!initialized) {
+                break;
+            }
+            *sensor = event.current;
+            ProtectionOverload_SM_Run();
+            if (result->ticks == 0) {
+                result->first_timestamp = event.timestamp;
+            }
+            result->last_timestamp = event.timestamp;
+            result->ticks++;
+            ProtectionOverloadState next = ProtectionOverload_SM_GetState();
+            if (next == ST_OVERLOAD_TRIGGERED && state != ST_OVERLOAD_TRIGGERED) {
+                trip_pending = true;
+                result->trips++;
+                if (result->first_trip_tick == 0) {
+                    ProtectionOverload_SM_GetSnapshot(&snapshot);
+                    result->first_trip_tick = snapshot.tick;
+                }
+            }
+            state = next;
+            break;
+        case CAPTURE_EVENT_RESET:
+            ProtectionOverload_SM_Reset();
+            state = ProtectionOverload_SM_GetState();
+            break;
+        case CAPTURE_EVENT_TRIP:
+            ProtectionOverload_SM_GetSnapshot(&snapshot);
+            result->mismatch = !trip_pending || ProtectionOverload_FloatBits(snapshot.energy) != event.energy_bits;
+            result->checkpoints += !result->mismatch;
+            trip_pending = false;
+            break;
+        case CAPTURE_EVENT_END:
+            ProtectionOverload_SM_GetSnapshot(&snapshot);
+            result->mismatch = snapshot.state != event.state || ProtectionOverload_FloatBits(snapshot.energy) != event.energy_bits ||
+                               snapshot.tick != event.tick;
+            result->checkpoints += !result->mismatch;
+            result->complete = !result->mismatch;
+            break;
+        }
+    }
+    if (result->mismatch) {
+        result->mismatch_sample = result->ticks;
+    }
+    return result->complete && !result->mismatch && !reader->error;
+}
@@ -0,0 +1,141 @@
+// Protection Overload Capture Header
+//
+// Record and replay of the single instance API: every input of the engine
+// (SM_Init parameters, Sensor_Read values with a timestamp, reset commands)
+// is logged through the input tap, so that a field recording replayed
+// through ProtectionOverload_SM_Run reproduces the same states bit for bit.
+//
+// A capture is a header followed by varint tokens:
+//   xor << 1                   sample: current bits XOR the previous sample bits,
+//                              then the zigzag delta of the timestamp step (with a clock)
+//   (n << 2) | 1               n samples repeating the last one (same bits, same step)
+//   (command << 2) | 3         command: init (+ parameters), reset, trip or end checkpoint
+// A steady current on a steady clock costs a compare per tick and a few
+// bytes per run of up to 2^26 ticks. Trip checkpoints (energy bits at the
+// trip tick) and the end checkpoint (state, energy bits, tick) are checked
+// by the replay.
+//
+// Tokens go to a caller buffer. When it is full, the flush callback gets
+// the bytes (file, flash, socket) and the buffer restarts; without a
+// callback the capture stops and reports an overflow.
+//
+//   ProtectionOverload_CaptureStart(&capture, buffer, sizeof(buffer), Write_Chunk, file, Clock_Now);
+//   ProtectionOverload_SM_Init(&params);                // recorded
+//   ProtectionOverload_SM_Run();                        // recorded, once per call period
+//   ProtectionOverload_CaptureStop(&capture);           // end checkpoint, last chunk flushed
+//
+// Replay: ProtectionOverload_CaptureOpen, then ProtectionOverload_CaptureReplay
+// with the variable that Sensor_Read returns.
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROTECTION_OVERLOAD_CAPTURE_MAGIC   0x4E494F50u     // "POIN"
+#define PROTECTION_OVERLOAD_CAPTURE_VERSION 1u
+#define PROTECTION_OVERLOAD_CAPTURE_RUN_MAX 0x03FFFFFFu     // Longest run token (4-byte varint)
+#define PROTECTION_OVERLOAD_CAPTURE_TOKEN   48u             // Largest token [bytes] (init command)
+
+// Commands
+typedef enum {
+    CAPTURE_CMD_INIT = 0,               // SM_Init, followed by the parameters
+    CAPTURE_CMD_RESET,                  // SM_Reset
+    CAPTURE_CMD_TRIP,                   // Trip checkpoint: energy bits at the trip tick
+    CAPTURE_CMD_END                     // End checkpoint: state, energy bits, tick
+} ProtectionOverloadCaptureCommand;
+
+// Capture header
+typedef struct {
+    uint32_t magic;                     // PROTECTION_OVERLOAD_CAPTURE_MAGIC
+    uint16_t version;                   // PROTECTION_OVERLOAD_CAPTURE_VERSION
+    uint16_t header_size;               // sizeof(ProtectionOverloadCaptureHeader)
+    float call_rate_sec;                // ProtectionOverload_SM_GetCallRate of the recording
+    uint32_t timestamps;                // Samples carry a timestamp (clock units)
+    uint64_t start;                     // Clock at the start (0 without clock)
+} ProtectionOverloadCaptureHeader;
+
+// Chunk of a full buffer
+typedef void (*ProtectionOverloadCaptureFlush)(void *context, const uint8_t *data, size_t size);
+
+// Recorder (registered as the input tap of the single instance)
+typedef struct {
+    ProtectionOverloadInputTap tap;
+    uint8_t *buffer;
+    size_t size;                        // Buffer size [bytes]
+    size_t used;                        // Bytes not flushed yet
+    uint64_t bytes;                     // Bytes captured since start
+    ProtectionOverloadCaptureFlush flush;       // NULL: stop when full
+    void *flush_context;
+    uint64_t (*clock)(void);            // Timestamp source (NULL: none)
+    uint64_t timestamp;                 // Last sample
+    int64_t step;                       // Last timestamp step
+    uint32_t bits;                      // Last current bits
+    uint32_t run;                       // Pending repeated samples
+    uint8_t state;                      // State after the last tick
+    bool overflow;                      // Stopped on a full buffer
+} ProtectionOverloadCapture;
+
+// Replay event
+typedef enum {
+    CAPTURE_EVENT_SAMPLE,
+    CAPTURE_EVENT_INIT,
+    CAPTURE_EVENT_RESET,
+    CAPTURE_EVENT_TRIP,
+    CAPTURE_EVENT_END
+} ProtectionOverloadCaptureEventType;
+
+typedef struct {
+    ProtectionOverloadCaptureEventType type;
+    float current;                      // SAMPLE
+    uint64_t timestamp;                 // SAMPLE (0 without clock)
+    ProtectionOverloadParams params;    // INIT
+    ProtectionOverloadState state;      // END
+    uint32_t energy_bits;               // TRIP, END
+    uint32_t tick;                      // END: ticks since SM_Init
+} ProtectionOverloadCaptureEvent;
+
+// Reader of a capture in memory
+typedef struct {
+    const uint8_t *data;
+    size_t size;
+    size_t pos;
+    ProtectionOverloadCaptureHeader header;
+    uint64_t timestamp;
+    int64_t step;
+    uint32_t bits;
+    uint32_t run;                       // Repeated samples left
+    bool error;                         // Malformed token
+} ProtectionOverloadCaptureReader;
+
+// Replay result
+typedef struct {
+    uint64_t ticks;                     // Samples replayed
+    uint32_t trips;                     // Trips of the replayed engine
+    uint32_t checkpoints;               // Checkpoints matched
+    uint32_t first_trip_tick;           // Tick (since SM_Init) of the first trip, 0: none
+    uint64_t first_timestamp;           // Timestamps of the first and last sample
+    uint64_t last_timestamp;
+    bool complete;                      // End checkpoint reached
+    bool mismatch;                      // A checkpoint differs
+    uint64_t mismatch_sample;           // Sample before the first mismatch
+} ProtectionOverloadReplayResult;
+
+// Record: registers the input tap, then every SM_Init, SM_Run and SM_Reset is captured
+// (start before SM_Init: samples before the first SM_Init are not replayable). The
+// buffer holds at least the header and a token (72 bytes).
+void ProtectionOverload_CaptureStart(ProtectionOverloadCapture *capture, uint8_t *buffer, size_t size,
+                                     ProtectionOverloadCaptureFlush flush, void *flush_context, uint64_t (*clock)(void));
+
+// Stop: end checkpoint, last chunk flushed, tap removed (false: overflow, capture truncated)
+bool ProtectionOverload_CaptureStop(ProtectionOverloadCapture *capture);
+
+// Read a capture: header check, then events in order (false at the end or on a malformed token)
+bool ProtectionOverload_CaptureOpen(ProtectionOverloadCaptureReader *reader, const uint8_t *data, size_t size);
+bool ProtectionOverload_CaptureNext(ProtectionOverloadCaptureReader *reader, ProtectionOverloadCaptureEvent *event);
+
+// Replay through the single instance API (*sensor is the value Sensor_Read returns) and
+// check the checkpoints: true if complete and bit-exact
+bool ProtectionOverload_CaptureReplay(ProtectionOverloadCaptureReader *reader, float *sensor, ProtectionOverloadReplayResult *result);
@@ -0,0 +1,64 @@
+// Protection Overload Curves Header
+//
+// Inverse-time trip curves t_trip = k / ((I/I_trip)^alpha - 1). Kept inline so
+// that a constant curve (see protection_overload_fixed.h) folds to one branch.
+// With PROTECTION_OVERLOAD_NO_LIBM non-integer exponents use the engine's own
+// approximations (protection_overload_math.h) instead of libm.
+
+#pragma once
+
+#include "protection_overload.h"
+#if defined(PROTECTION_OVERLOAD_NO_LIBM)
+#include "protection_overload_math.h"
+#else
+#include <math.h>
+#endif
+
+// Curve term (I/I_trip)^alpha - 1 for a given overload factor
+static inline float ProtectionOverload_CurveTerm(ProtectionOverloadCurve curve, float overload_factor) {
+    switch (curve) {
+        case CURVE_IT:
+            return overload_factor - 1.0f;
+        case CURVE_STANDARD_INVERSE:
+#if defined(PROTECTION_OVERLOAD_NO_LIBM)
+            // x^0.02 - 1 = expm1(0.02 ln x): no cancellation near pickup
+            return ProtectionOverload_Expm1f(0.02f * PO_LN2 * ProtectionOverload_Log2f(overload_factor));
+#else
+            return powf(overload_factor, 0.02f) - 1.0f;
+#endif
+        case CURVE_I2T:
+        default:
+            return overload_factor * overload_factor - 1.0f;
+    }
+}
+
+// Pickup level of a parameter set: overload factor above which heating starts.
+// Levels are kept above 1.0, where every curve term is positive.
+static inline float ProtectionOverload_PickupFactor(const ProtectionOverloadParams *params) {
+    float pickup = (params->pickup_ratio > 0.0f) ? params->pickup_ratio : PROTECTION_OVERLOAD_PICKUP;
+    return (pickup > 1.0f) ? pickup : 1.0f;
+}
+
+// Dropout level: overload factor at or below which a picked-up protection cools again
+static inline float ProtectionOverload_DropoutFactor(const ProtectionOverloadParams *params) {
+    float ratio = (params->dropout_ratio > 0.0f && params->dropout_ratio < 1.0f) ? params->dropout_ratio : 1.0f;
+    float dropout = ProtectionOverload_PickupFactor(params) * ratio;
+    return (dropout > 1.0f) ? dropout : 1.0f;
+}
+
+// Thermal image of a tripped protection: the breaker is open, the energy at
+// trip cools at 1 / max_energy per second
+static inline float ProtectionOverload_TrippedEnergy(float trip_energy, float max_energy, float tripped_sec) {
+    float energy = trip_energy - tripped_sec * (1.0f / max_energy);
+    return (energy > 0.0f) ? energy : 0.0f;
+}
+
+// Remaining lockout after a trip [s]: time until the thermal image has cooled
+// to lockout_energy (0: no lockout)
+static inline float ProtectionOverload_LockoutTime(float trip_energy, float max_energy, float lockout_energy, float tripped_sec) {
+    if (lockout_energy <= 0.0f) {
+        return 0.0f;
+    }
+    float remaining = (trip_energy - lockout_energy) * max_energy - tripped_sec;
+    return (remaining > 0.0f) ? remaining : 0.0f;
+}
@@ -0,0 +1,111 @@
+// Protection Overload Events
+
+#include "protection_overload_events.h"
+
+// Init an empty queue on the caller's cells
+bool ProtectionOverload_EventQueueInit(ProtectionOverloadEventQueue *queue, ProtectionOverloadEventCell *cells, uint32_t capacity) {
+    if (cells == NULL || capacity < 2u || (capacity & (capacity - 1u)) != 0u) {
+        return false;
+    }
+    queue->cells = cells;
+    queue->mask = capacity - 1u;
+    for (uint32_t i = 0; i < capacity; i++) {
+        atomic_init(&cells[i].sequence, i);
+    }
+    atomic_init(&queue->tail, 0u);
+    queue->head = 0;
+    atomic_init(&queue->dropped, 0u);
+    return true;
+}
+
+// Producer (any thread): false if the queue is full (event dropped)
+bool ProtectionOverload_EventPush(ProtectionOverloadEventQueue *queue, const ProtectionOverloadEventRecord *record) {
+    unsigned int position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    for (;;) {
+        ProtectionOverloadEventCell *cell = &queue->cells[position & queue->mask];
+        unsigned int sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int difference = (int)(sequence - position);
+        if (difference == 0) {
+            // Free cell: claim it (on failure position is reloaded)
+            if (atomic_compare_exchange_weak_explicit(&queue->tail, &position, position + 1u,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->record = *record;
+                atomic_store_explicit(&cell->sequence, position + 1u, memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // Cell not yet consumed: full
+            atomic_fetch_add_explicit(&queue->dropped, 1u, memory_order_relaxed);
+            return false;
+        } else {
+            // Another producer claimed it
+            position = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+        }
+    }
+}
+
+// Consumer (one thread): false if the queue is empty
+bool ProtectionOverload_EventPop(ProtectionOverloadEventQueue *queue, ProtectionOverloadEventRecord *record) {
+    ProtectionOverloadEventCell *cell = &queue->cells[queue->head & queue->mask];
+    unsigned int sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    if (sequence != queue->head + 1u) {
+        return false;
+    }
+    *record = cell->record;
+    // Hand the cell back to the producers, one lap later
+    atomic_store_explicit(&cell->sequence, queue->head + queue->mask + 1u, memory_order_release);
+    queue->head++;
+    return true;
+}
+
+// Events lost on a full queue since Init
+uint32_t ProtectionOverload_EventDropped(ProtectionOverloadEventQueue *queue) {
+    return atomic_load_explicit(&queue->dropped, memory_order_relaxed);
+}
+
+/* ------------------------------------------------
+        Event source hooks
+   ------------------------------------------------ */
+
+static void ProtectionOverload_EventSourcePush(ProtectionOverloadEventSource *source, ProtectionOverloadEvent event,
+                                               const ProtectionOverloadSM *sm) {
+    ProtectionOverloadEventRecord record = {
+        .timestamp = (source->clock != NULL) ? source->clock() : 0u,
+        .source = source->source,
+        .event = (uint8_t)event,
+        .energy = ProtectionOverload_GetEnergy(sm),
+        .overload_factor = sm->overload_factor
+    };
+    ProtectionOverload_EventPush(source->queue, &record);
+}
+
+static void ProtectionOverload_EventOnPickup(void *context, const ProtectionOverloadSM *sm) {
+    ProtectionOverload_EventSourcePush(context, EVENT_PICKUP, sm);
+}
+
+static void ProtectionOverload_EventOnTrip(void *context, const ProtectionOverloadSM *sm) {
+    ProtectionOverload_EventSourcePush(context, EVENT_TRIP, sm);
+}
+
+static void ProtectionOverload_EventOnReset(void *context, const ProtectionOverloadSM *sm) {
+    ProtectionOverload_EventSourcePush(context, EVENT_RESET, sm);
+}
+
+static void ProtectionOverload_EventOnDropout(void *context, const ProtectionOverloadSM *sm) {
+    ProtectionOverload_EventSourcePush(context, EVENT_DROPOUT, sm);
+}
+
+// Fill the hooks of a source (context: the source itself)
+void ProtectionOverload_EventSourceInit(ProtectionOverloadEventSource *source, ProtectionOverloadEventQueue *queue,
+                                        uint32_t source_id, uint64_t (*clock)(void)) {
+    source->hooks = (ProtectionOverloadHooks){
+        .on_pickup = ProtectionOverload_EventOnPickup,
+        .on_trip = ProtectionOverload_EventOnTrip,
+        .on_reset = ProtectionOverload_EventOnReset,
+        .on_dropout = ProtectionOverload_EventOnDropout,
+        .context = source
+    };
+    source->queue = queue;
+    source->source = source_id;
+    source->clock = clock;
+}
@@ -0,0 +1,69 @@
+// Protection Overload Events Header
+//
+// Bounded lock-free event queue carrying timestamped transitions (pickup,
+// dropout, trip, reset) from the tasks running state machines to a supervisor
+// thread, instead of polling every instance after each Run.
+//
+// Multi-producer, single-consumer ring of cells (Vyukov): a producer claims a
+// cell with a CAS on the tail, writes the record and releases the cell through
+// its sequence number; the consumer reads cells in order and hands them back.
+// No lock and no allocation: the caller provides a power-of-two array of
+// cells. A full queue never blocks a producer: the event is dropped and
+// counted.
+//
+//   static ProtectionOverloadEventCell cells[1024];
+//   ProtectionOverload_EventQueueInit(&queue, cells, 1024);
+//   ProtectionOverload_EventSourceInit(&source, &queue, channel, Clock_Now);
+//   ProtectionOverload_SetHooks(&sm, &source.hooks);
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROTECTION_OVERLOAD_EVENTS_ALIGN    64u     // Cache line [bytes]
+
+// Transition event record
+typedef struct {
+    uint64_t timestamp;                 // Source clock at the transition
+    uint32_t source;                    // Source id (e.g. channel number)
+    uint8_t event;                      // ProtectionOverloadEvent
+    float energy;                       // Accumulated energy at the transition
+    float overload_factor;              // Overload factor at the transition
+} ProtectionOverloadEventRecord;
+
+// Queue cell: sequence == position when free, position + 1 when written
+typedef struct {
+    atomic_uint sequence;
+    ProtectionOverloadEventRecord record;
+} ProtectionOverloadEventCell;
+
+// Event queue (any number of producers, one consumer)
+typedef struct {
+    ProtectionOverloadEventCell *cells; // Caller-provided ring
+    uint32_t mask;                      // Capacity - 1
+    _Alignas(PROTECTION_OVERLOAD_EVENTS_ALIGN) atomic_uint tail;    // Next position to write (producers)
+    _Alignas(PROTECTION_OVERLOAD_EVENTS_ALIGN) uint32_t head;       // Next position to read (consumer)
+    atomic_uint dropped;                // Events lost on a full queue
+} ProtectionOverloadEventQueue;
+
+// Event source: hooks of one state machine pushing to a queue
+typedef struct {
+    ProtectionOverloadHooks hooks;      // Register with ProtectionOverload_SetHooks
+    ProtectionOverloadEventQueue *queue;
+    uint32_t source;                    // Source id of the records
+    uint64_t (*clock)(void);            // Timestamp source (NULL: 0)
+} ProtectionOverloadEventSource;
+
+// Queue API (capacity: power of two, at least 2)
+bool ProtectionOverload_EventQueueInit(ProtectionOverloadEventQueue *queue, ProtectionOverloadEventCell *cells, uint32_t capacity);
+bool ProtectionOverload_EventPush(ProtectionOverloadEventQueue *queue, const ProtectionOverloadEventRecord *record);
+bool ProtectionOverload_EventPop(ProtectionOverloadEventQueue *queue, ProtectionOverloadEventRecord *record);
+uint32_t ProtectionOverload_EventDropped(ProtectionOverloadEventQueue *queue);
+
+// Source API: fill the hooks that push the transitions of one state machine
+void ProtectionOverload_EventSourceInit(ProtectionOverloadEventSource *source, ProtectionOverloadEventQueue *queue,
+                                        uint32_t source_id, uint64_t (*clock)(void));
@@ -0,0 +1,188 @@
+// Protection Overload - Fixed Ratings
+//
+// Drop-in replacement of the single instance API (ProtectionOverload_SM_*) of
+// protection_overload.c for trip units with fixed ratings: link this file
+// instead of protection_overload.c and select the settings at build time:
+//   -DPROTECTION_OVERLOAD_FIXED_CURVE=CURVE_I2T
+//   -DPROTECTION_OVERLOAD_FIXED_THRESHOLD=1.0f
+//   -DPROTECTION_OVERLOAD_FIXED_K=1.0f
+//   -DPROTECTION_OVERLOAD_FIXED_MAX_ENERGY=1.0f
+//   -DPROTECTION_OVERLOAD_FIXED_PICKUP=1.15f    (pickup overload factor)
+//   -DPROTECTION_OVERLOAD_FIXED_DROPOUT=1.15f   (dropout overload factor, <= pickup)
+//   -DPROTECTION_OVERLOAD_FIXED_LOCKOUT=0.0f    (lockout energy, 0: no lockout)
+//   -DPROTECTION_OVERLOAD_FIXED_AUTO_RESET=0    (1: re-arm at the end of the lockout)
+
+#include "protection_overload_fixed.h"
+#include "protection_overload_snapshot.h"
+
+#ifndef PROTECTION_OVERLOAD_FIXED_CURVE
+#define PROTECTION_OVERLOAD_FIXED_CURVE         CURVE_I2T
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_THRESHOLD
+#define PROTECTION_OVERLOAD_FIXED_THRESHOLD     1.0f
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_K
+#define PROTECTION_OVERLOAD_FIXED_K             1.0f
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_MAX_ENERGY
+#define PROTECTION_OVERLOAD_FIXED_MAX_ENERGY    1.0f
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_PICKUP
+#define PROTECTION_OVERLOAD_FIXED_PICKUP        PROTECTION_OVERLOAD_PICKUP
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_DROPOUT
+#define PROTECTION_OVERLOAD_FIXED_DROPOUT       PROTECTION_OVERLOAD_FIXED_PICKUP
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_LOCKOUT
+#define PROTECTION_OVERLOAD_FIXED_LOCKOUT       0.0f
+#endif
+#ifndef PROTECTION_OVERLOAD_FIXED_AUTO_RESET
+#define PROTECTION_OVERLOAD_FIXED_AUTO_RESET    0
+#endif
+
+#define   CALL_RATE 0.01f       // Call rate [s] = 10 ms
+
+PROTECTION_OVERLOAD_FIXED_DEFINE(Fixed,
+                                 PROTECTION_OVERLOAD_FIXED_CURVE,
+                                 PROTECTION_OVERLOAD_FIXED_THRESHOLD,
+                                 PROTECTION_OVERLOAD_FIXED_K,
+                                 PROTECTION_OVERLOAD_FIXED_MAX_ENERGY,
+                                 CALL_RATE,
+                                 PROTECTION_OVERLOAD_FIXED_PICKUP,
+                                 PROTECTION_OVERLOAD_FIXED_DROPOUT,
+                                 PROTECTION_OVERLOAD_FIXED_LOCKOUT,
+                                 PROTECTION_OVERLOAD_FIXED_AUTO_RESET)
+
+// State machine instance
+static Fixed_SM sm;
+
+// Published state (read by other threads) and ticks run
+static ProtectionOverloadSeqlock sm_snapshot;
+static uint32_t sm_tick;
+
+// Transition hooks and last overload factor
+static const ProtectionOverloadHooks *sm_hooks;
+static float sm_overload_factor;
+
+// Input tap (record and replay)
+static const ProtectionOverloadInputTap *sm_tap;
+
+// Call a transition hook with an instance view of the fixed state machine
+static void Fixed_Notify(ProtectionOverloadHook hook) {
+    if (hook == NULL) {
+        return;
+    }
+    const ProtectionOverloadSM view = {
+        .accumulated_energy = sm.accumulated_energy,
+        .overload_factor = sm_overload_factor,
+        .pickup_factor = PROTECTION_OVERLOAD_FIXED_PICKUP,
+        .dropout_factor = PROTECTION_OVERLOAD_FIXED_DROPOUT,
+        .state = (uint8_t)Fixed_GetState(&sm),
+        .tripped_sec = sm.tripped_sec,
+        .call_rate_sec = CALL_RATE,
+        .params = {
+            .overload_threshold = PROTECTION_OVERLOAD_FIXED_THRESHOLD,
+            .k_factor = PROTECTION_OVERLOAD_FIXED_K,
+            .max_energy = PROTECTION_OVERLOAD_FIXED_MAX_ENERGY,
+            .curve = PROTECTION_OVERLOAD_FIXED_CURVE,
+            .pickup_ratio = PROTECTION_OVERLOAD_FIXED_PICKUP,
+            .dropout_ratio = PROTECTION_OVERLOAD_FIXED_DROPOUT / PROTECTION_OVERLOAD_FIXED_PICKUP,
+            .lockout_energy = PROTECTION_OVERLOAD_FIXED_LOCKOUT,
+            .auto_reset = PROTECTION_OVERLOAD_FIXED_AUTO_RESET
+        },
+        .hooks = sm_hooks
+    };
+    hook(sm_hooks->context, &view);
+}
+
+// State Machine Initialization
+// ! Settings are fixed at build time: params are not used
+void ProtectionOverload_SM_Init(ProtectionOverloadParams *params) {
+    (void)params;
+    Fixed_Init(&sm);
+    sm_tick = 0;
+    sm_hooks = NULL;
+    sm_overload_factor = 0.0f;
+    ProtectionOverload_SnapshotWrite(&sm_snapshot, Fixed_GetState(&sm), sm.accumulated_energy, 0.0f, sm_tick);
+    if (sm_tap != NULL && sm_tap->on_init != NULL) {
+        sm_tap->on_init(sm_tap->context, params);
+    }
+}
+
+// Return protection call rate [s]
+float ProtectionOverload_SM_GetCallRate(void) {
+    return Fixed_GetCallRate();
+}
+
+// Run state machine (called periodically)
+void ProtectionOverload_SM_Run() {
+    float current = Sensor_Read();
+    ProtectionOverloadState state = Fixed_GetState(&sm);
+    Fixed_Run(&sm, current);
+    ProtectionOverloadState next = Fixed_GetState(&sm);
+    if (state != ST_OVERLOAD_TRIGGERED) {
+        sm_overload_factor = current * (1.0f / PROTECTION_OVERLOAD_FIXED_THRESHOLD);
+    } else if (next != state) {
+        // Automatic re-arm
+        sm_overload_factor = 0.0f;
+    }
+    if (next != state && sm_hooks != NULL) {
+        if (state == ST_OVERLOAD_TRIGGERED) {
+            Fixed_Notify(sm_hooks->on_reset);
+        } else {
+            // Entry actions: pickup (also on a trip at the first tick above pickup), dropout, trip
+            if (state == ST_IDLE) {
+                Fixed_Notify(sm_hooks->on_pickup);
+            }
+            Fixed_Notify((next == ST_IDLE) ? sm_hooks->on_dropout : (next == ST_OVERLOAD_TRIGGERED) ? sm_hooks->on_trip : NULL);
+        }
+    }
+    ProtectionOverload_SnapshotWrite(&sm_snapshot, Fixed_GetState(&sm), sm.accumulated_energy, sm_overload_factor, ++sm_tick);
+    if (sm_tap != NULL && sm_tap->on_tick != NULL) {
+        sm_tap->on_tick(sm_tap->context, current, next);
+    }
+}
+
+// Register transition hooks (after SM_Init)
+void ProtectionOverload_SM_SetHooks(const ProtectionOverloadHooks *hooks) {
+    sm_hooks = hooks;
+}
+
+// Reset command (false: locked out): re-armed with the thermal image (EVENT_RESET)
+static bool Fixed_ResetCommand(void) {
+    bool tripped = (Fixed_GetState(&sm) == ST_OVERLOAD_TRIGGERED);
+    if (!Fixed_Reset(&sm)) {
+        return false;
+    }
+    if (tripped) {
+        sm_overload_factor = 0.0f;
+        if (sm_hooks != NULL) {
+            Fixed_Notify(sm_hooks->on_reset);
+        }
+        ProtectionOverload_SnapshotWrite(&sm_snapshot, Fixed_GetState(&sm), sm.accumulated_energy, sm_overload_factor, sm_tick);
+    }
+    return true;
+}
+
+bool ProtectionOverload_SM_Reset() {
+    bool reset = Fixed_ResetCommand();
+    if (sm_tap != NULL && sm_tap->on_reset != NULL) {
+        sm_tap->on_reset(sm_tap->context);
+    }
+    return reset;
+}
+
+// Register the input tap (NULL: none, kept across SM_Init)
+void ProtectionOverload_SM_SetInputTap(const ProtectionOverloadInputTap *tap) {
+    sm_tap = tap;
+}
+
+/* Returns current state machine state (published state: safe from any thread) */
+ProtectionOverloadState ProtectionOverload_SM_GetState() {
+    return (ProtectionOverloadState)atomic_load_explicit(&sm_snapshot.state, memory_order_relaxed);
+}
+
+/* Returns consistent state, energy, overload factor and tick of the last Run */
+void ProtectionOverload_SM_GetSnapshot(ProtectionOverloadSnapshot *snapshot) {
+    ProtectionOverload_SnapshotRead(&sm_snapshot, snapshot);
+}
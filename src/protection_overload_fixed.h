@@ -0,0 +1,91 @@
+// Protection Overload Fixed Ratings Header
+//
+// Header-only variant of the state machine for trip units with fixed ratings.
+// Curve, threshold, k, max energy, call rate, the pickup and dropout overload
+// factors (above 1.0), the lockout energy (0: none) and the automatic re-arm
+// (0 or 1) are compile-time constants, so the compiler folds 1/threshold,
+// call_rate/k and call_rate/max_energy and the curve selection: the generated
+// Run has no division and no runtime parameter loads.
+//
+//   PROTECTION_OVERLOAD_FIXED_DEFINE(Feeder, CURVE_I2T, 1.0f, 1.0f, 1.0f, 0.01f, 1.15f, 1.10f, 0.5f, 0)
+//   static Feeder_SM feeder;
+//   Feeder_Init(&feeder);
+//   Feeder_Run(&feeder, current);
+
+#pragma once
+
+#include "protection_overload.h"
+#include "protection_overload_curve.h"
+
+#define PROTECTION_OVERLOAD_FIXED_DEFINE(name, curve, threshold, k, max_energy, call_rate,              \
+                                         pickup, dropout, lockout_energy, auto_reset)                   \
+                                                                                                        \
+    /* State machine (settings are compile-time constants) */                                          \
+    typedef struct {                                                                                    \
+        float accumulated_energy;               /* Energy accumulator */                               \
+        ProtectionOverloadState state;          /* Current state */                                    \
+        float tripped_sec;                      /* Time since trip [s] */                              \
+    } name##_SM;                                                                                        \
+                                                                                                        \
+    static inline void name##_Init(name##_SM *sm) {                                                     \
+        sm->accumulated_energy = 0.0f;                                                                  \
+        sm->state = ST_IDLE;                                                                            \
+        sm->tripped_sec = 0.0f;                                                                         \
+    }                                                                                                   \
+                                                                                                        \
+    /* Remaining lockout [s] (closed form, 0: reset allowed or not tripped) */                         \
+    static inline float name##_GetLockoutTime(const name##_SM *sm) {                                    \
+        return (sm->state == ST_OVERLOAD_TRIGGERED) ?                                                   \
+               ProtectionOverload_LockoutTime(sm->accumulated_energy, (max_energy), (lockout_energy),   \
+                                              sm->tripped_sec) : 0.0f;                                  \
+    }                                                                                                   \
+                                                                                                        \
+    /* Reset command: false while locked out, re-armed with the thermal image */                       \
+    static inline bool name##_Reset(name##_SM *sm) {                                                    \
+        if (name##_GetLockoutTime(sm) > 0.0f) {                                                         \
+            return false;                                                                               \
+        }                                                                                               \
+        if (sm->state == ST_OVERLOAD_TRIGGERED) {                                                       \
+            sm->accumulated_energy = ProtectionOverload_TrippedEnergy(sm->accumulated_energy,           \
+                                                                      (max_energy), sm->tripped_sec);   \
+            sm->state = ST_IDLE;                                                                        \
+            sm->tripped_sec = 0.0f;                                                                     \
+        }                                                                                               \
+        return true;                                                                                    \
+    }                                                                                                   \
+                                                                                                        \
+    static inline float name##_GetCallRate(void) {                                                      \
+        return (call_rate);                                                                             \
+    }                                                                                                   \
+                                                                                                        \
+    static inline void name##_Run(name##_SM *sm, float current) {                                       \
+        if (sm->state == ST_OVERLOAD_TRIGGERED) {                                                       \
+            sm->tripped_sec += (call_rate);                                                             \
+            if ((auto_reset)) {                                                                         \
+                name##_Reset(sm);                                                                       \
+            }                                                                                           \
+            return;                                                                                     \
+        }                                                                                               \
+        /* Overload factor: I / I_trip */                                                              \
+        const float overload_factor = current * (1.0f / (threshold));                                  \
+        /* Level of the state: pickup while idle, dropout while picked up (select, no branch) */       \
+        const float level = (sm->state == ST_PICKUP) ? (dropout) : (pickup);                            \
+        if (overload_factor > level) {                                                                  \
+            /* Energy += call_rate / t_trip = curve_term * call_rate / k */                            \
+            sm->state = ST_PICKUP;                                                                      \
+            sm->accumulated_energy += ProtectionOverload_CurveTerm((curve), overload_factor) *          \
+                                      ((call_rate) / (k));                                              \
+            if (sm->accumulated_energy >= 1.0f) {                                                       \
+                sm->state = ST_OVERLOAD_TRIGGERED;                                                      \
+                sm->tripped_sec = 0.0f;                                                                 \
+            }                                                                                           \
+        } else {                                                                                        \
+            sm->state = ST_IDLE;                                                                        \
+            sm->accumulated_energy -= (call_rate) / (max_energy);                                       \
+            if (sm->accumulated_energy < 0.0f) sm->accumulated_energy = 0.0f;                           \
+        }                                                                                               \
+    }                                                                                                   \
+                                                                                                        \
+    static inline ProtectionOverloadState name##_GetState(const name##_SM *sm) {                        \
+        return sm->state;                                                                               \
+    }
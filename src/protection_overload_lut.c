@@ -0,0 +1,53 @@
+// Protection Overload Trip Rate Lookup Table
+
+#include "protection_overload_lut.h"
+#include "protection_overload_curve.h"
+
+#define LUT_SHIFT       (23u - PROTECTION_OVERLOAD_LUT_OCTAVE_BITS)    // Mantissa bits below node index
+#define LUT_CURVES      3u
+
+// One table per curve family, built on first use
+static ProtectionOverloadLutNode lut[LUT_CURVES][PROTECTION_OVERLOAD_LUT_SIZE];
+static bool lut_ready[LUT_CURVES];
+
+// Node i overload factor: first node is the pickup factor
+static inline float Lut_NodeFactor(uint32_t i) {
+    return ProtectionOverload_BitsFloat(ProtectionOverload_FloatBits(PROTECTION_OVERLOAD_PICKUP) + (i << LUT_SHIFT));
+}
+
+unsigned int ProtectionOverload_LutNodes(void) {
+    uint32_t span = ProtectionOverload_FloatBits(PROTECTION_OVERLOAD_LUT_MAX_FACTOR) - ProtectionOverload_FloatBits(PROTECTION_OVERLOAD_PICKUP);
+    return (span >> LUT_SHIFT) + 2u;
+}
+
+void ProtectionOverload_LutInit(ProtectionOverloadCurve curve) {
+    if ((unsigned int)curve >= LUT_CURVES || lut_ready[curve]) {
+        return;
+    }
+
+    unsigned int nodes = ProtectionOverload_LutNodes();
+    if (nodes > PROTECTION_OVERLOAD_LUT_SIZE) {
+        nodes = PROTECTION_OVERLOAD_LUT_SIZE;
+    }
+    for (uint32_t i = 0; i < nodes; i++) {
+        float f0 = Lut_NodeFactor(i);
+        float f1 = Lut_NodeFactor(i + 1u);
+        float t0 = ProtectionOverload_CurveTerm(curve, f0);
+        float t1 = ProtectionOverload_CurveTerm(curve, f1);
+        lut[curve][i].term = t0;
+        lut[curve][i].slope = (t1 - t0) / (f1 - f0);
+    }
+    lut_ready[curve] = true;
+}
+
+float ProtectionOverload_LutCurveTerm(ProtectionOverloadCurve curve, float overload_factor) {
+    if (overload_factor < PROTECTION_OVERLOAD_PICKUP || overload_factor >= PROTECTION_OVERLOAD_LUT_MAX_FACTOR ||
+        (unsigned int)curve >= LUT_CURVES) {
+        return ProtectionOverload_CurveTerm(curve, overload_factor);
+    }
+
+    // Node index from float bits, linear interpolation inside the node
+    uint32_t i = (ProtectionOverload_FloatBits(overload_factor) - ProtectionOverload_FloatBits(PROTECTION_OVERLOAD_PICKUP)) >> LUT_SHIFT;
+    const ProtectionOverloadLutNode *node = &lut[curve][i];
+    return node->term + node->slope * (overload_factor - Lut_NodeFactor(i));
+}
@@ -0,0 +1,62 @@
+// Protection Overload Trip Rate Lookup Table Header
+//
+// Curve term (I/I_trip)^alpha - 1 tabulated between pickup and
+// PROTECTION_OVERLOAD_LUT_MAX_FACTOR, with linear interpolation. Nodes are
+// spaced by the float bit pattern of the overload factor: 2^OCTAVE_BITS
+// nodes per octave (quasi log-spaced), so the index is an integer subtraction
+// and shift, with no log.
+//
+// Worst-case relative error against the exact curve term with the default
+// 32 nodes per octave (checked in test_protection_overload_lut.c):
+//   CURVE_I2T < 0.08 %, CURVE_IT exact (linear), CURVE_STANDARD_INVERSE < 0.07 %
+// The error scales with 4^-OCTAVE_BITS.
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdint.h>
+
+#ifndef PROTECTION_OVERLOAD_LUT_OCTAVE_BITS
+#define PROTECTION_OVERLOAD_LUT_OCTAVE_BITS 5       // 2^5 = 32 nodes per octave
+#endif
+
+#ifndef PROTECTION_OVERLOAD_LUT_MAX_FACTOR
+#define PROTECTION_OVERLOAD_LUT_MAX_FACTOR  20.0f   // Exact curve above this overload factor
+#endif
+
+// Float bits of an integer n in [1, 2^16) as an integer constant: biased exponent, then mantissa
+#define PROTECTION_OVERLOAD_LUT_EXP(n)      ((n) >= 32768u ? 15u : (n) >= 16384u ? 14u : (n) >= 8192u ? 13u : \
+                                             (n) >= 4096u ? 12u : (n) >= 2048u ? 11u : (n) >= 1024u ? 10u : \
+                                             (n) >= 512u ? 9u : (n) >= 256u ? 8u : (n) >= 128u ? 7u : (n) >= 64u ? 6u : \
+                                             (n) >= 32u ? 5u : (n) >= 16u ? 4u : (n) >= 8u ? 3u : (n) >= 4u ? 2u : \
+                                             (n) >= 2u ? 1u : 0u)
+#define PROTECTION_OVERLOAD_LUT_INT_BITS(n) (((127u + PROTECTION_OVERLOAD_LUT_EXP(n)) << 23) + \
+                                             (((n) - (1u << PROTECTION_OVERLOAD_LUT_EXP(n))) << (23u - PROTECTION_OVERLOAD_LUT_EXP(n))))
+
+// Integer above the max factor
+#define PROTECTION_OVERLOAD_LUT_MAX_INT     ((uint32_t)(PROTECTION_OVERLOAD_LUT_MAX_FACTOR) + 1u)
+
+// Table size: ProtectionOverload_LutNodes formula over [1, LUT_MAX_INT], which holds
+// [pickup, max factor] (+2 guard nodes); 140 nodes with the defaults
+#define PROTECTION_OVERLOAD_LUT_SIZE        (((PROTECTION_OVERLOAD_LUT_INT_BITS(PROTECTION_OVERLOAD_LUT_MAX_INT) - \
+                                               PROTECTION_OVERLOAD_LUT_INT_BITS(1u)) >> \
+                                              (23u - PROTECTION_OVERLOAD_LUT_OCTAVE_BITS)) + 2u)
+
+// Table node: value and slope to next node
+typedef struct {
+    float term;                         // (f_i)^alpha - 1
+    float slope;                        // d term / d f on [f_i, f_i+1]
+} ProtectionOverloadLutNode;
+
+_Static_assert(PROTECTION_OVERLOAD_LUT_MAX_INT < 65536u, "Lookup table max factor must be below 2^16 - 1");
+_Static_assert(PROTECTION_OVERLOAD_LUT_SIZE * sizeof(ProtectionOverloadLutNode) <= 4096u,
+               "Trip rate lookup table must fit in 4 KB");
+
+// Build table of a curve family (idempotent, call from Init before running)
+void ProtectionOverload_LutInit(ProtectionOverloadCurve curve);
+
+// Interpolated curve term, exact curve outside of the table range
+float ProtectionOverload_LutCurveTerm(ProtectionOverloadCurve curve, float overload_factor);
+
+// Number of nodes used by a curve table
+unsigned int ProtectionOverload_LutNodes(void);
@@ -0,0 +1,59 @@
+// Protection Overload Math Header
+//
+// libm-free approximations used by the engine when built with
+// PROTECTION_OVERLOAD_NO_LIBM (bare-metal images without libm in flash).
+// Bounded errors for positive finite inputs, checked against libm in
+// test_protection_overload_math.c:
+//   ProtectionOverload_Log2f    error < 2e-7 * max(1, |log2(x)|)
+//   ProtectionOverload_Exp2f    relative error < 2e-7 (|x| <= 20)
+//   ProtectionOverload_Expm1f   relative error < 5e-7 (|x| <= 2)
+//   ProtectionOverload_Powf     relative error < 2e-6 (|y * log2(x)| <= 25)
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdint.h>
+
+#define PO_LN2          0.693147180559945f
+#define PO_LOG2E        1.442695040888963f
+
+// log2(x) for x > 0: x = 2^e * m with m in [sqrt(1/2), sqrt(2)),
+// ln(m) = 2 * atanh(t) with t = (m - 1) / (m + 1), |t| < 0.172
+static inline float ProtectionOverload_Log2f(float x) {
+    uint32_t bits = ProtectionOverload_FloatBits(x);
+    int32_t e = (int32_t)((bits >> 23) & 0xFFu) - 127;
+    float m = ProtectionOverload_BitsFloat((bits & 0x007FFFFFu) | 0x3F800000u);
+    if (m > 1.41421356f) {
+        m *= 0.5f;
+        e++;
+    }
+    float t = (m - 1.0f) / (m + 1.0f);
+    float t2 = t * t;
+    float ln_m = 2.0f * t * (1.0f + t2 * (1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (1.0f / 7.0f + t2 * (1.0f / 9.0f)))));
+    return (float)e + ln_m * PO_LOG2E;
+}
+
+// 2^x: x = n + f with f in [-0.5, 0.5], 2^f = e^(f ln2) by Taylor series (degree 7)
+static inline float ProtectionOverload_Exp2f(float x) {
+    if (x > 127.0f) x = 127.0f;
+    if (x < -126.0f) return 0.0f;
+    float n = (float)(int32_t)(x + (x >= 0.0f ? 0.5f : -0.5f));
+    float r = (x - n) * PO_LN2;
+    float p = 1.0f + r * (1.0f + r * (1.0f / 2.0f + r * (1.0f / 6.0f + r * (1.0f / 24.0f +
+              r * (1.0f / 120.0f + r * (1.0f / 720.0f + r * (1.0f / 5040.0f)))))));
+    return p * ProtectionOverload_BitsFloat((uint32_t)((int32_t)n + 127) << 23);
+}
+
+// e^x - 1 without cancellation for small x
+static inline float ProtectionOverload_Expm1f(float x) {
+    if (x > -0.25f && x < 0.25f) {
+        return x * (1.0f + x * (1.0f / 2.0f + x * (1.0f / 6.0f + x * (1.0f / 24.0f +
+               x * (1.0f / 120.0f + x * (1.0f / 720.0f + x * (1.0f / 5040.0f)))))));
+    }
+    return ProtectionOverload_Exp2f(x * PO_LOG2E) - 1.0f;
+}
+
+// x^y for x > 0
+static inline float ProtectionOverload_Powf(float x, float y) {
+    return ProtectionOverload_Exp2f(y * ProtectionOverload_Log2f(x));
+}
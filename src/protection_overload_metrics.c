@@ -0,0 +1,204 @@
+// Protection Overload Metrics
+
+#if defined(__unix__)
+#define _POSIX_C_SOURCE 200809L         // shm_open, clock_gettime
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "protection_overload_metrics.h"
+#include <time.h>
+
+// Header of a new segment, magic last
+static void ProtectionOverload_MetricsFormat(ProtectionOverloadMetricsHeader *header, uint32_t slots) {
+    header->version = PROTECTION_OVERLOAD_METRICS_VERSION;
+    header->header_size = sizeof(ProtectionOverloadMetricsHeader);
+    header->slot_size = sizeof(ProtectionOverloadMetricsSlot);
+    header->slots = slots;
+    header->bins = PROTECTION_OVERLOAD_METRICS_BINS;
+    header->timing = PROTECTION_OVERLOAD_METRICS_TIMING;
+    atomic_store_explicit(&header->magic, PROTECTION_OVERLOAD_METRICS_MAGIC, memory_order_release);
+}
+
+// Layout written by this build, slots within size
+static bool ProtectionOverload_MetricsValid(const ProtectionOverloadMetricsHeader *header, size_t size) {
+    return size >= sizeof(*header) &&
+           atomic_load_explicit(&header->magic, memory_order_acquire) == PROTECTION_OVERLOAD_METRICS_MAGIC &&
+           header->version == PROTECTION_OVERLOAD_METRICS_VERSION &&
+           header->header_size == sizeof(ProtectionOverloadMetricsHeader) &&
+           header->slot_size == sizeof(ProtectionOverloadMetricsSlot) &&
+           header->bins == PROTECTION_OVERLOAD_METRICS_BINS &&
+           ProtectionOverload_MetricsSize(header->slots) <= size;
+}
+
+bool ProtectionOverload_MetricsCreate(ProtectionOverloadMetrics *metrics, const char *name, uint32_t slots) {
+    *metrics = (ProtectionOverloadMetrics){NULL, 0, false};
+#if defined(__unix__)
+    size_t size = ProtectionOverload_MetricsSize(slots);
+    int fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    // Truncating to 0 first zeroes a segment left by a previous run
+    if (ftruncate(fd, 0) != 0 || ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        return false;
+    }
+    void *base = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    *metrics = (ProtectionOverloadMetrics){base, size, true};
+    ProtectionOverload_MetricsFormat(metrics->header, slots);
+    return true;
+#else
+    (void)name;
+    (void)slots;
+    return false;
+#endif
+}
+
+bool ProtectionOverload_MetricsInit(ProtectionOverloadMetrics *metrics, void *base, size_t size, uint32_t slots) {
+    *metrics = (ProtectionOverloadMetrics){NULL, 0, false};
+    if (base == NULL || ((uintptr_t)base & 63u) != 0 || size < ProtectionOverload_MetricsSize(slots)) {
+        return false;
+    }
+    memset(base, 0, ProtectionOverload_MetricsSize(slots));
+    *metrics = (ProtectionOverloadMetrics){base, size, false};
+    ProtectionOverload_MetricsFormat(metrics->header, slots);
+    return true;
+}
+
+bool ProtectionOverload_MetricsOpen(ProtectionOverloadMetrics *metrics, const char *name) {
+    *metrics = (ProtectionOverloadMetrics){NULL, 0, false};
+#if defined(__unix__)
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ProtectionOverloadMetricsHeader)) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    void *base = mmap(NULL, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    if (!ProtectionOverload_MetricsValid(base, size)) {
+        munmap(base, size);
+        return false;
+    }
+    *metrics = (ProtectionOverloadMetrics){base, size, true};
+    return true;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+void ProtectionOverload_MetricsClose(ProtectionOverloadMetrics *metrics) {
+#if defined(__unix__)
+    if (metrics->header != NULL && metrics->shared) {
+        munmap(metrics->header, metrics->size);
+    }
+#endif
+    *metrics = (ProtectionOverloadMetrics){NULL, 0, false};
+}
+
+bool ProtectionOverload_MetricsUnlink(const char *name) {
+#if defined(__unix__)
+    return shm_unlink(name) == 0;
+#else
+    (void)name;
+    return false;
+#endif
+}
+
+ProtectionOverloadMetricsSlot *ProtectionOverload_MetricsSlot(const ProtectionOverloadMetrics *metrics, uint32_t index) {
+    if (metrics->header == NULL || index >= metrics->header->slots) {
+        return NULL;
+    }
+    ProtectionOverloadMetricsSlot *slots = (ProtectionOverloadMetricsSlot *)(metrics->header + 1);
+    return &slots[index];
+}
+
+void ProtectionOverload_MetricsAttach(ProtectionOverloadMetricsWriter *writer, ProtectionOverloadMetricsSlot *slot,
+                                      const ProtectionOverloadSM *sm, uint32_t source, uint64_t (*clock)(void)) {
+    uint32_t energy = ProtectionOverload_FloatBits(ProtectionOverload_GetEnergy(sm));
+    *writer = (ProtectionOverloadMetricsWriter){
+        .slot = slot,
+        .clock = clock,
+        .tick_ns = (uint64_t)((double)sm->call_rate_sec * 1e9 + 0.5),
+        .timing = PROTECTION_OVERLOAD_METRICS_TIMING,
+        .trips = ProtectionOverload_GetTrips(sm),
+        .generation = ProtectionOverload_GetGeneration(sm)
+    };
+    atomic_store_explicit(&slot->ticks, 0u, memory_order_relaxed);
+    atomic_store_explicit(&slot->pickup_ns, 0u, memory_order_relaxed);
+    atomic_store_explicit(&slot->source, source, memory_order_relaxed);
+    atomic_store_explicit(&slot->trips, 0u, memory_order_relaxed);
+    atomic_store_explicit(&slot->state, (unsigned int)ProtectionOverload_GetState(sm), memory_order_relaxed);
+    atomic_store_explicit(&slot->energy, energy, memory_order_relaxed);
+    atomic_store_explicit(&slot->peak_energy, energy, memory_order_relaxed);
+    for (uint32_t bin = 0; bin < PROTECTION_OVERLOAD_METRICS_BINS; bin++) {
+        atomic_store_explicit(&slot->run_ns[bin], 0u, memory_order_relaxed);
+    }
+    atomic_store_explicit(&slot->attached, 1u, memory_order_release);
+}
+
+void ProtectionOverload_MetricsDetach(ProtectionOverloadMetricsWriter *writer) {
+    atomic_store_explicit(&writer->slot->attached, 0u, memory_order_release);
+    writer->slot = NULL;
+}
+
+uint64_t ProtectionOverload_MetricsClockNs(void) {
+    struct timespec now;
+#if defined(__unix__)
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#else
+    timespec_get(&now, TIME_UTC);
+#endif
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+void ProtectionOverload_MetricsRead(const ProtectionOverloadMetricsSlot *slot, ProtectionOverloadMetricsValues *values) {
+    values->attached = atomic_load_explicit(&slot->attached, memory_order_acquire) != 0;
+    values->ticks = atomic_load_explicit(&slot->ticks, memory_order_relaxed);
+    values->pickup_sec = (double)atomic_load_explicit(&slot->pickup_ns, memory_order_relaxed) * 1e-9;
+    values->source = atomic_load_explicit(&slot->source, memory_order_relaxed);
+    values->trips = atomic_load_explicit(&slot->trips, memory_order_relaxed);
+    values->state = (ProtectionOverloadState)atomic_load_explicit(&slot->state, memory_order_relaxed);
+    values->energy = ProtectionOverload_BitsFloat(atomic_load_explicit(&slot->energy, memory_order_relaxed));
+    values->peak_energy = ProtectionOverload_BitsFloat(atomic_load_explicit(&slot->peak_energy, memory_order_relaxed));
+    for (uint32_t bin = 0; bin < PROTECTION_OVERLOAD_METRICS_BINS; bin++) {
+        values->run_ns[bin] = atomic_load_explicit(&slot->run_ns[bin], memory_order_relaxed);
+    }
+}
+
+uint64_t ProtectionOverload_MetricsPercentile(const ProtectionOverloadMetricsValues *values, double p) {
+    uint64_t total = 0;
+    for (uint32_t bin = 0; bin < PROTECTION_OVERLOAD_METRICS_BINS; bin++) {
+        total += values->run_ns[bin];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // Rank of the percentile, 1 to total
+    uint64_t rank = (uint64_t)(p * (double)total + 0.999999);
+    rank = (rank < 1u) ? 1u : (rank > total) ? total : rank;
+    uint64_t count = 0;
+    uint32_t bin = 0;
+    for (; bin < PROTECTION_OVERLOAD_METRICS_BINS - 1u; bin++) {
+        count += values->run_ns[bin];
+        if (count >= rank) {
+            break;
+        }
+    }
+    return (uint64_t)1u << (bin + 1u);
+}
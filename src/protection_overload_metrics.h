@@ -0,0 +1,217 @@
+// Protection Overload Metrics Header
+//
+// Live counters of protection instances for external monitors: ticks run,
+// time above pickup, peak energy, trips, state and a Run time histogram,
+// published in a shared memory segment that any local process maps and
+// reads at any rate, without a syscall or a lock on the protection side.
+//
+// The segment has a fixed, versioned layout: a 64-byte header, then one
+// 192-byte slot per instance, cache-line aligned so that instances do not
+// share lines. A slot has a single writer, the task running its instance:
+// counters are updated with a relaxed load and a relaxed store (no atomic
+// read-modify-write, no fence), so a tick costs a few plain stores. Every
+// counter read is exact and never goes back; counters of one slot read in
+// sequence may straddle a tick. The creator writes the magic last, with
+// release ordering: a monitor that sees it sees a complete header.
+//
+// Run time is taken every PROTECTION_OVERLOAD_METRICS_TIMING ticks from a
+// caller clock [ns] and counted in log2 bins, from which monitors read the
+// percentiles (upper bound of the bin, within a factor of 2).
+//
+//   ProtectionOverload_MetricsCreate(&metrics, "/protection_overload", channels);
+//   ProtectionOverload_MetricsAttach(&writer, ProtectionOverload_MetricsSlot(&metrics, channel), &sm, channel,
+//                                    ProtectionOverload_MetricsClockNs);
+//   ProtectionOverload_MetricsRun(&writer, &sm, current);          // instead of ProtectionOverload_Run
+//
+// Counters are 64-bit: lock-free on 64-bit hosts, the targets of a shared
+// memory monitor. Other targets use ProtectionOverload_MetricsInit on their
+// own memory.
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROTECTION_OVERLOAD_METRICS_MAGIC   0x4D544F50u     // "POTM"
+#define PROTECTION_OVERLOAD_METRICS_VERSION 1u
+#define PROTECTION_OVERLOAD_METRICS_BINS    32u             // Run time bins: bin b counts [2^b, 2^(b+1)) ns, bin 0 [0, 2) ns
+
+#ifndef PROTECTION_OVERLOAD_METRICS_TIMING
+#define PROTECTION_OVERLOAD_METRICS_TIMING  64u             // Ticks per timed Run (power of two)
+#endif
+
+// Segment header (64 bytes)
+typedef struct {
+    atomic_uint magic;                  // PROTECTION_OVERLOAD_METRICS_MAGIC once initialized
+    uint16_t version;                   // PROTECTION_OVERLOAD_METRICS_VERSION
+    uint16_t header_size;               // sizeof(ProtectionOverloadMetricsHeader)
+    uint32_t slot_size;                 // sizeof(ProtectionOverloadMetricsSlot)
+    uint32_t slots;                     // Instance slots after the header
+    uint32_t bins;                      // PROTECTION_OVERLOAD_METRICS_BINS
+    uint32_t timing;                    // Ticks per timed Run
+    uint8_t reserved[40];
+} ProtectionOverloadMetricsHeader;
+
+// Instance slot (one writer)
+typedef struct {
+    _Alignas(64) atomic_uint_least64_t ticks;   // Ticks run since attach
+    atomic_uint_least64_t pickup_ns;    // Time run in ST_PICKUP [ns]
+    atomic_uint source;                 // Source id (e.g. channel number)
+    atomic_uint trips;                  // Trips since attach
+    atomic_uint state;                  // State after the last tick
+    atomic_uint energy;                 // Energy after the last tick (float bits)
+    atomic_uint peak_energy;            // Highest energy since attach (float bits)
+    atomic_uint attached;               // Non-zero while a writer is attached
+    atomic_uint run_ns[PROTECTION_OVERLOAD_METRICS_BINS];   // Run time histogram
+} ProtectionOverloadMetricsSlot;
+
+_Static_assert(sizeof(ProtectionOverloadMetricsHeader) == 64, "metrics header layout");
+_Static_assert(sizeof(ProtectionOverloadMetricsSlot) == 192, "metrics slot layout");
+_Static_assert((PROTECTION_OVERLOAD_METRICS_TIMING & (PROTECTION_OVERLOAD_METRICS_TIMING - 1u)) == 0,
+               "PROTECTION_OVERLOAD_METRICS_TIMING must be a power of two");
+
+// Mapped segment
+typedef struct {
+    ProtectionOverloadMetricsHeader *header;    // Start of the segment (NULL: none)
+    size_t size;                        // Mapped bytes
+    bool shared;                        // Shared memory mapping (munmap on close)
+} ProtectionOverloadMetrics;
+
+// Writer of one slot (private to the task running the instance)
+typedef struct {
+    ProtectionOverloadMetricsSlot *slot;
+    uint64_t (*clock)(void);            // Run time clock [ns] (NULL: Run not timed)
+    uint64_t tick_ns;                   // Call rate of the instance [ns]
+    uint32_t timing;                    // Ticks until the next timed Run
+    uint32_t trips;                     // Trips of the instance at the last publish
+    uint32_t generation;                // Init of the instance at the last publish
+} ProtectionOverloadMetricsWriter;
+
+// Counters copied by a monitor
+typedef struct {
+    uint64_t ticks;
+    double pickup_sec;                  // Time above pickup [s]
+    uint32_t source;
+    uint32_t trips;
+    ProtectionOverloadState state;
+    float energy;
+    float peak_energy;
+    bool attached;
+    uint32_t run_ns[PROTECTION_OVERLOAD_METRICS_BINS];
+} ProtectionOverloadMetricsValues;
+
+// Segment bytes for a number of slots
+static inline size_t ProtectionOverload_MetricsSize(uint32_t slots) {
+    return sizeof(ProtectionOverloadMetricsHeader) + (size_t)slots * sizeof(ProtectionOverloadMetricsSlot);
+}
+
+// Create a named shared memory segment (POSIX shm_open name, "/name"), zeroed
+bool ProtectionOverload_MetricsCreate(ProtectionOverloadMetrics *metrics, const char *name, uint32_t slots);
+
+// Segment in caller memory (64-byte aligned, ProtectionOverload_MetricsSize bytes)
+bool ProtectionOverload_MetricsInit(ProtectionOverloadMetrics *metrics, void *base, size_t size, uint32_t slots);
+
+// Map a named segment read-only (monitors): false if missing or of another layout
+bool ProtectionOverload_MetricsOpen(ProtectionOverloadMetrics *metrics, const char *name);
+
+// Unmap (the name stays until ProtectionOverload_MetricsUnlink)
+void ProtectionOverload_MetricsClose(ProtectionOverloadMetrics *metrics);
+bool ProtectionOverload_MetricsUnlink(const char *name);
+
+// Slot of an instance (NULL beyond the last slot)
+ProtectionOverloadMetricsSlot *ProtectionOverload_MetricsSlot(const ProtectionOverloadMetrics *metrics, uint32_t index);
+
+// Attach a writer to a slot: counters restart from the state machine as it is
+void ProtectionOverload_MetricsAttach(ProtectionOverloadMetricsWriter *writer, ProtectionOverloadMetricsSlot *slot,
+                                      const ProtectionOverloadSM *sm, uint32_t source, uint64_t (*clock)(void));
+void ProtectionOverload_MetricsDetach(ProtectionOverloadMetricsWriter *writer);
+
+// Monotonic host clock [ns]
+uint64_t ProtectionOverload_MetricsClockNs(void);
+
+// Monitor: copy the counters of a slot, then percentile p (0 to 1) of Run time [ns]
+void ProtectionOverload_MetricsRead(const ProtectionOverloadMetricsSlot *slot, ProtectionOverloadMetricsValues *values);
+uint64_t ProtectionOverload_MetricsPercentile(const ProtectionOverloadMetricsValues *values, double p);
+
+/* ------------------------------------------------
+        Writer fast path
+   ------------------------------------------------ */
+
+// Single writer: relaxed load and store, no read-modify-write
+static inline void ProtectionOverload_MetricsAdd64(atomic_uint_least64_t *counter, uint64_t value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+static inline void ProtectionOverload_MetricsAdd32(atomic_uint *counter, unsigned int value) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + value, memory_order_relaxed);
+}
+
+// Count a Run time in its bin
+static inline void ProtectionOverload_MetricsTime(ProtectionOverloadMetricsWriter *writer, uint64_t run_ns) {
+    unsigned int bin = (run_ns < 2u) ? 0u : (unsigned int)(63 - __builtin_clzll(run_ns));
+    if (bin >= PROTECTION_OVERLOAD_METRICS_BINS) {
+        bin = PROTECTION_OVERLOAD_METRICS_BINS - 1u;
+    }
+    ProtectionOverload_MetricsAdd32(&writer->slot->run_ns[bin], 1u);
+}
+
+// Publish a tick run over elapsed_ns (a reset between ticks is published with the next tick)
+static inline void ProtectionOverload_MetricsUpdate(ProtectionOverloadMetricsWriter *writer, const ProtectionOverloadSM *sm,
+                                                    uint64_t elapsed_ns) {
+    ProtectionOverloadMetricsSlot *slot = writer->slot;
+    ProtectionOverloadState state = ProtectionOverload_GetState(sm);
+    uint32_t energy = ProtectionOverload_FloatBits(ProtectionOverload_GetEnergy(sm));
+    uint32_t trips = ProtectionOverload_GetTrips(sm);
+    uint32_t generation = ProtectionOverload_GetGeneration(sm);
+
+    ProtectionOverload_MetricsAdd64(&slot->ticks, 1u);
+    if (state == ST_PICKUP) {
+        ProtectionOverload_MetricsAdd64(&slot->pickup_ns, elapsed_ns);
+    }
+    atomic_store_explicit(&slot->state, (unsigned int)state, memory_order_relaxed);
+    // Trips counted by the state machine since its Init: a new Init restarts them from 0,
+    // and a reset and a trip between two publishes both count
+    if (generation != writer->generation) {
+        writer->generation = generation;
+        writer->trips = 0u;
+    }
+    if (trips != writer->trips) {
+        ProtectionOverload_MetricsAdd32(&slot->trips, trips - writer->trips);
+        writer->trips = trips;
+    }
+    atomic_store_explicit(&slot->energy, energy, memory_order_relaxed);
+    // Non-negative floats order like their bits
+    if (energy > atomic_load_explicit(&slot->peak_energy, memory_order_relaxed) && (energy >> 31) == 0) {
+        atomic_store_explicit(&slot->peak_energy, energy, memory_order_relaxed);
+    }
+}
+
+// Run an instance and publish its counters
+static inline void ProtectionOverload_MetricsRun(ProtectionOverloadMetricsWriter *writer, ProtectionOverloadSM *sm, float current) {
+    if (writer->clock != NULL && --writer->timing == 0) {
+        writer->timing = PROTECTION_OVERLOAD_METRICS_TIMING;
+        uint64_t start = writer->clock();
+        ProtectionOverload_Run(sm, current);
+        ProtectionOverload_MetricsTime(writer, writer->clock() - start);
+    } else {
+        ProtectionOverload_Run(sm, current);
+    }
+    ProtectionOverload_MetricsUpdate(writer, sm, writer->tick_ns);
+}
+
+// Run an instance over elapsed_sec (adaptive call rate) and publish its counters
+static inline void ProtectionOverload_MetricsRunElapsed(ProtectionOverloadMetricsWriter *writer, ProtectionOverloadSM *sm,
+                                                        float current, float elapsed_sec) {
+    if (writer->clock != NULL && --writer->timing == 0) {
+        writer->timing = PROTECTION_OVERLOAD_METRICS_TIMING;
+        uint64_t start = writer->clock();
+        ProtectionOverload_RunElapsed(sm, current, elapsed_sec);
+        ProtectionOverload_MetricsTime(writer, writer->clock() - start);
+    } else {
+        ProtectionOverload_RunElapsed(sm, current, elapsed_sec);
+    }
+    ProtectionOverload_MetricsUpdate(writer, sm, (uint64_t)(elapsed_sec * 1e9f));
+}
@@ -0,0 +1,70 @@
+// Protection Overload Pool
+
+#if defined(__linux__)
+#define _DEFAULT_SOURCE                 // MAP_ANONYMOUS, MAP_HUGETLB, madvise
+#include <sys/mman.h>
+#endif
+
+#include "protection_overload_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Size rounded up to a multiple of align (power of two)
+static inline size_t ProtectionOverload_PoolRound(size_t size, size_t align) {
+    return (size + align - 1u) & ~(align - 1u);
+}
+
+// Allocate a zeroed, cache-line aligned block
+bool ProtectionOverload_PoolAlloc(ProtectionOverloadPool *pool, size_t size, bool huge_pages) {
+    pool->base = NULL;
+    pool->size = 0;
+    pool->pages = POOL_PAGES_NORMAL;
+    if (size == 0) {
+        return false;
+    }
+
+#if defined(__linux__)
+    // Anonymous mappings are page aligned and zeroed
+    if (huge_pages) {
+        size_t huge_size = ProtectionOverload_PoolRound(size, PROTECTION_OVERLOAD_POOL_HUGE_PAGE);
+        void *base = mmap(NULL, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base != MAP_FAILED) {
+            *pool = (ProtectionOverloadPool){base, huge_size, POOL_PAGES_HUGETLB};
+            return true;
+        }
+    }
+    size_t map_size = ProtectionOverload_PoolRound(size, huge_pages ? PROTECTION_OVERLOAD_POOL_HUGE_PAGE : 4096u);
+    void *base = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    *pool = (ProtectionOverloadPool){base, map_size, POOL_PAGES_NORMAL};
+    if (huge_pages && madvise(base, map_size, MADV_HUGEPAGE) == 0) {
+        pool->pages = POOL_PAGES_TRANSPARENT;
+    }
+    return true;
+#else
+    (void)huge_pages;
+    size_t aligned_size = ProtectionOverload_PoolRound(size, PROTECTION_OVERLOAD_POOL_ALIGN);
+    void *base = aligned_alloc(PROTECTION_OVERLOAD_POOL_ALIGN, aligned_size);
+    if (base == NULL) {
+        return false;
+    }
+    memset(base, 0, aligned_size);
+    *pool = (ProtectionOverloadPool){base, aligned_size, POOL_PAGES_NORMAL};
+    return true;
+#endif
+}
+
+// Release a block
+void ProtectionOverload_PoolFree(ProtectionOverloadPool *pool) {
+    if (pool->base != NULL) {
+#if defined(__linux__)
+        munmap(pool->base, pool->size);
+#else
+        free(pool->base);
+#endif
+    }
+    pool->base = NULL;
+    pool->size = 0;
+}
@@ -0,0 +1,37 @@
+// Protection Overload Pool Header
+//
+// Host-side memory pool for large fleets of channels (bank storage blocks,
+// instance arrays). The block is aligned to a cache line and, on request,
+// backed by 2 MB huge pages so that the channel state of a whole fleet is
+// covered by a few TLB entries:
+//   - Linux: explicit huge pages (MAP_HUGETLB, needs vm.nr_hugepages), else
+//     transparent huge pages (madvise), else normal pages
+//   - other hosts: aligned_alloc
+// Embedded targets provide a static block instead:
+//   static _Alignas(PROTECTION_OVERLOAD_BANK_ALIGN) uint8_t block[...];
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PROTECTION_OVERLOAD_POOL_ALIGN      64u                 // Cache line [bytes]
+#define PROTECTION_OVERLOAD_POOL_HUGE_PAGE  (2u * 1024u * 1024u) // Huge page [bytes]
+
+// Page backing of a pool
+typedef enum {
+    POOL_PAGES_NORMAL,                  // Normal pages (or huge pages not requested)
+    POOL_PAGES_TRANSPARENT,             // Transparent huge pages requested (madvise)
+    POOL_PAGES_HUGETLB                  // Explicit huge pages
+} ProtectionOverloadPoolPages;
+
+// Pool block
+typedef struct {
+    void *base;                         // Block (PROTECTION_OVERLOAD_POOL_ALIGN aligned, zeroed)
+    size_t size;                        // Allocated size [bytes]
+    ProtectionOverloadPoolPages pages;  // Page backing
+} ProtectionOverloadPool;
+
+// Pool API (Alloc returns false when out of memory)
+bool ProtectionOverload_PoolAlloc(ProtectionOverloadPool *pool, size_t size, bool huge_pages);
+void ProtectionOverload_PoolFree(ProtectionOverloadPool *pool);
@@ -0,0 +1,87 @@
+// Protection Overload Probe Header
+//
+// USDT (user-level statically defined tracing) probes for profiling host
+// simulations with perf or bpftrace without rebuilding:
+//   perf buildid-cache --add build/fleet_probes_win.exe
+//   perf probe -x build/fleet_probes_win.exe sdt_protection_overload:trip
+//   bpftrace -e 'usdt:build/fleet_probes_win.exe:protection_overload:trip { @[arg0] = count(); }'
+//
+// Without PROTECTION_OVERLOAD_PROBES every probe expands to ((void)0). With
+// it, a probe is a single nop at the probe site plus a .note.stapsdt ELF
+// note giving the tools its address and the location of its arguments; the
+// tools patch the nop into a breakpoint when they attach. A detached probe
+// therefore costs the nop and keeping its arguments in registers.
+// <sys/sdt.h> (systemtap-sdt-dev) is used when installed. Otherwise the
+// same note is emitted here for GCC/Clang on x86-64 and AArch64 ELF hosts;
+// other hosts build without probes.
+//
+// Probes (provider protection_overload), arguments are 64-bit integers,
+// floats are passed as their IEEE-754 bits:
+//   run_entry(sm, current bits)                    ProtectionOverload_Run / RunElapsed / SM_Run
+//   run_return(sm, state)
+//   state_change(sm, old state, new state)         every transition, re-arm included
+//   trip(sm, energy bits, overload factor bits)
+
+#pragma once
+
+#include <stdint.h>
+
+#if defined(PROTECTION_OVERLOAD_PROBES) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define PROTECTION_OVERLOAD_PROBES_SDT
+#endif
+#endif
+
+#if defined(PROTECTION_OVERLOAD_PROBES) && !defined(PROTECTION_OVERLOAD_PROBES_SDT) && \
+    !(defined(__ELF__) && (defined(__x86_64__) || defined(__aarch64__)))
+#warning "USDT probes not supported on this target: built without probes"
+#undef PROTECTION_OVERLOAD_PROBES
+#endif
+
+#if defined(PROTECTION_OVERLOAD_PROBES_SDT)
+
+#define PROTECTION_OVERLOAD_PROBE2(name, a1, a2)        DTRACE_PROBE2(protection_overload, name, (uint64_t)(a1), (uint64_t)(a2))
+#define PROTECTION_OVERLOAD_PROBE3(name, a1, a2, a3)    DTRACE_PROBE3(protection_overload, name, (uint64_t)(a1), (uint64_t)(a2), (uint64_t)(a3))
+
+#elif defined(PROTECTION_OVERLOAD_PROBES)
+
+// stapsdt note (version 3): probe address, link-time base, no semaphore,
+// provider, name and argument locations ("8@<register>" per argument)
+#define PROTECTION_OVERLOAD_PROBE_NOTE(name, args)                                      \
+    "990: nop\n"                                                                        \
+    ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                       \
+    ".balign 4\n"                                                                       \
+    ".4byte 992f-991f, 994f-993f, 3\n"                                                  \
+    "991: .asciz \"stapsdt\"\n"                                                         \
+    "992: .balign 4\n"                                                                  \
+    "993: .8byte 990b\n"                                                                \
+    ".8byte _.stapsdt.base\n"                                                           \
+    ".8byte 0\n"                                                                        \
+    ".asciz \"protection_overload\"\n"                                                  \
+    ".asciz \"" #name "\"\n"                                                            \
+    ".asciz \"" args "\"\n"                                                             \
+    "994: .balign 4\n"                                                                  \
+    ".popsection\n"                                                                     \
+    ".ifndef _.stapsdt.base\n"                                                          \
+    ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"             \
+    ".weak _.stapsdt.base\n"                                                            \
+    ".hidden _.stapsdt.base\n"                                                          \
+    "_.stapsdt.base: .space 1\n"                                                        \
+    ".size _.stapsdt.base, 1\n"                                                         \
+    ".popsection\n"                                                                     \
+    ".endif\n"
+
+#define PROTECTION_OVERLOAD_PROBE2(name, a1, a2)                                        \
+    __asm__ __volatile__(PROTECTION_OVERLOAD_PROBE_NOTE(name, "8@%0 8@%1")              \
+                         :: "r"((uint64_t)(a1)), "r"((uint64_t)(a2)))
+#define PROTECTION_OVERLOAD_PROBE3(name, a1, a2, a3)                                    \
+    __asm__ __volatile__(PROTECTION_OVERLOAD_PROBE_NOTE(name, "8@%0 8@%1 8@%2")         \
+                         :: "r"((uint64_t)(a1)), "r"((uint64_t)(a2)), "r"((uint64_t)(a3)))
+
+#else
+
+#define PROTECTION_OVERLOAD_PROBE2(name, a1, a2)        ((void)0)
+#define PROTECTION_OVERLOAD_PROBE3(name, a1, a2, a3)    ((void)0)
+
+#endif
@@ -0,0 +1,266 @@
+// Protection Overload Recorder
+
+#include "protection_overload_recorder.h"
+#include <string.h>
+
+#define RECORDER_NO_STATE   0xFFu       // Last sample unknown: next sample is coded
+#define RECORDER_TOKEN_MAX  11u         // Sample token: head + 2 x 5-byte varints
+#define RECORDER_RUN_MAX    5u          // Run token, kept free in every block
+
+/* ------------------------------------------------
+        Varint coding
+   ------------------------------------------------ */
+
+static inline uint32_t Recorder_ZigZag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t Recorder_UnZigZag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1u);
+}
+
+static inline void Recorder_PutVarint(ProtectionOverloadRecorderBlock *block, uint32_t value) {
+    while (value >= 0x80u) {
+        block->data[block->used++] = (uint8_t)(value | 0x80u);
+        value >>= 7;
+    }
+    block->data[block->used++] = (uint8_t)value;
+}
+
+static inline uint32_t Recorder_GetVarint(const ProtectionOverloadRecorderBlock *block, uint32_t *offset) {
+    uint32_t value = 0;
+    for (unsigned int shift = 0; *offset < block->used; shift += 7) {
+        uint8_t byte = block->data[(*offset)++];
+        value |= (uint32_t)(byte & 0x7Fu) << shift;
+        if (byte < 0x80u) break;
+    }
+    return value;
+}
+
+/* ------------------------------------------------
+        Recorder
+   ------------------------------------------------ */
+
+// Code the pending repeats: head = run << 1 | 1 (always fits, see Recorder_NextBlock)
+static void Recorder_FlushRun(ProtectionOverloadRecorder *recorder) {
+    if (recorder->run > 0u) {
+        Recorder_PutVarint(&recorder->blocks[recorder->head], (recorder->run << 1) | 1u);
+        recorder->run = 0;
+    }
+}
+
+// Open the next block (overwrites the oldest one when the ring is full)
+static void Recorder_NextBlock(ProtectionOverloadRecorder *recorder) {
+    recorder->head = (recorder->head + 1u) % recorder->block_count;
+    if (recorder->used_blocks < recorder->block_count) {
+        recorder->used_blocks++;
+    }
+    ProtectionOverloadRecorderBlock *block = &recorder->blocks[recorder->head];
+    block->first_tick = recorder->tick;
+    block->used = 0;
+    // First sample coded against zero
+    recorder->current = 0;
+    recorder->energy = 0;
+    recorder->energy_delta = 0;
+}
+
+static void Recorder_LogTrip(ProtectionOverloadRecorder *recorder, const ProtectionOverloadSM *sm, float current) {
+    ProtectionOverloadTripRecord record = {
+        .source = recorder->source,
+        .tick = recorder->tick - 1u,
+        .history_ticks = ProtectionOverload_RecorderHistoryTicks(recorder),
+        .current = current,
+        .energy = sm->accumulated_energy,
+        .overload_factor = sm->overload_factor
+    };
+    ProtectionOverload_TripLogAppend(recorder->log, &record);
+}
+
+// Sample token: head = state << 1, zigzag current delta, zigzag energy residual
+void ProtectionOverload_RecorderAppend(ProtectionOverloadRecorder *recorder, const ProtectionOverloadSM *sm,
+                                       int32_t current, int32_t energy) {
+    Recorder_FlushRun(recorder);
+    ProtectionOverloadRecorderBlock *block = &recorder->blocks[recorder->head];
+    if (recorder->used_blocks == 0u ||
+        block->used + RECORDER_TOKEN_MAX + RECORDER_RUN_MAX > sizeof(block->data)) {
+        Recorder_NextBlock(recorder);
+        block = &recorder->blocks[recorder->head];
+    }
+
+    int32_t residual = energy - (recorder->energy + recorder->energy_delta);
+    Recorder_PutVarint(block, (uint32_t)sm->state << 1);
+    Recorder_PutVarint(block, Recorder_ZigZag(current - recorder->current));
+    Recorder_PutVarint(block, Recorder_ZigZag(residual));
+    recorder->energy_delta = energy - recorder->energy;
+    recorder->current = current;
+    recorder->energy = energy;
+    recorder->state = sm->state;
+    recorder->tick++;
+
+    if (sm->state == ST_OVERLOAD_TRIGGERED) {
+        // Freeze the pre-trigger history on the trip tick
+        recorder->frozen = true;
+        if (recorder->log != NULL) {
+            Recorder_LogTrip(recorder, sm, (float)current / recorder->current_scale);
+        }
+    }
+}
+
+// Init an empty recorder on the caller's blocks
+bool ProtectionOverload_RecorderInit(ProtectionOverloadRecorder *recorder, ProtectionOverloadRecorderBlock *blocks,
+                                     uint32_t block_count, float current_lsb, uint32_t source, ProtectionOverloadTripLog *log) {
+    if (blocks == NULL || block_count < 2u || !(current_lsb > 0.0f)) {
+        return false;
+    }
+    *recorder = (ProtectionOverloadRecorder){
+        .current_scale = 1.0f / current_lsb,
+        .blocks = blocks,
+        .block_count = block_count,
+        .head = block_count - 1u,
+        .source = source,
+        .log = log
+    };
+    ProtectionOverload_RecorderRearm(recorder);
+    return true;
+}
+
+// Discard the history and record again (e.g. after ProtectionOverload_Reset), tick numbering continues
+void ProtectionOverload_RecorderRearm(ProtectionOverloadRecorder *recorder) {
+    recorder->used_blocks = 0;
+    recorder->run = 0;
+    recorder->state = RECORDER_NO_STATE;
+    recorder->frozen = false;
+}
+
+// Ticks held in the history (pending repeats included)
+uint32_t ProtectionOverload_RecorderHistoryTicks(const ProtectionOverloadRecorder *recorder) {
+    if (recorder->used_blocks == 0u) {
+        return 0;
+    }
+    uint32_t oldest = (recorder->head + recorder->block_count + 1u - recorder->used_blocks) % recorder->block_count;
+    return recorder->tick - recorder->blocks[oldest].first_tick;
+}
+
+// Coded history [bytes]
+size_t ProtectionOverload_RecorderBytes(const ProtectionOverloadRecorder *recorder) {
+    if (recorder->used_blocks == 0u) {
+        return 0;
+    }
+    return (size_t)(recorder->used_blocks - 1u) * sizeof(ProtectionOverloadRecorderBlock) +
+           offsetof(ProtectionOverloadRecorderBlock, data) + recorder->blocks[recorder->head].used;
+}
+
+// Decoder: the last max ticks of the history, oldest first (returns the samples written)
+uint32_t ProtectionOverload_RecorderRead(const ProtectionOverloadRecorder *recorder, ProtectionOverloadRecorderSample *samples, uint32_t max) {
+    uint32_t history = ProtectionOverload_RecorderHistoryTicks(recorder);
+    uint32_t span = (history < max) ? history : max;
+    uint32_t first = recorder->tick - span;
+    uint32_t count = 0;
+    ProtectionOverloadRecorderSample sample = {0};
+    int32_t current = 0, energy = 0, energy_delta = 0;
+
+    for (uint32_t b = 0; b < recorder->used_blocks; b++) {
+        const ProtectionOverloadRecorderBlock *block =
+            &recorder->blocks[(recorder->head + recorder->block_count + 1u - recorder->used_blocks + b) % recorder->block_count];
+        uint32_t tick = block->first_tick;
+        current = energy = energy_delta = 0;
+        for (uint32_t offset = 0; offset < block->used;) {
+            uint32_t head = Recorder_GetVarint(block, &offset);
+            uint32_t repeats = 1;
+            if (head & 1u) {
+                repeats = head >> 1;
+            } else {
+                int32_t current_delta = Recorder_UnZigZag(Recorder_GetVarint(block, &offset));
+                int32_t residual = Recorder_UnZigZag(Recorder_GetVarint(block, &offset));
+                sample.state = (ProtectionOverloadState)(head >> 1);
+                current += current_delta;
+                energy_delta += residual;
+            }
+            for (; repeats > 0u; repeats--, tick++) {
+                energy += energy_delta;
+                if (tick - first < span) {
+                    sample.tick = tick;
+                    sample.current = (float)current / recorder->current_scale;
+                    sample.energy = (float)energy * PROTECTION_OVERLOAD_RECORDER_ENERGY_LSB;
+                    samples[count++] = sample;
+                }
+            }
+        }
+    }
+
+    // Repeats not yet coded
+    for (uint32_t tick = recorder->tick - recorder->run; tick != recorder->tick; tick++) {
+        energy += energy_delta;
+        if (tick - first < span) {
+            sample.tick = tick;
+            sample.current = (float)current / recorder->current_scale;
+            sample.energy = (float)energy * PROTECTION_OVERLOAD_RECORDER_ENERGY_LSB;
+            samples[count++] = sample;
+        }
+    }
+    return count;
+}
+
+/* ------------------------------------------------
+        Trip log
+   ------------------------------------------------ */
+
+// FNV-1a over the record fields before the check
+static uint32_t TripLog_Check(const ProtectionOverloadTripRecord *record) {
+    const uint8_t *bytes = (const uint8_t *)record;
+    uint32_t hash = 0x811C9DC5u;
+    for (size_t i = 0; i < offsetof(ProtectionOverloadTripRecord, check); i++) {
+        hash = (hash ^ bytes[i]) * 0x01000193u;
+    }
+    return hash;
+}
+
+static bool TripLog_Valid(const ProtectionOverloadTripRecord *record) {
+    return record->sequence != 0u && record->check == TripLog_Check(record);
+}
+
+void ProtectionOverload_TripLogInit(ProtectionOverloadTripLog *log, ProtectionOverloadTripRecord *records, uint32_t capacity) {
+    memset(records, 0, capacity * sizeof(ProtectionOverloadTripRecord));
+    log->records = records;
+    log->capacity = capacity;
+    log->sequence = 0;
+}
+
+// Restart: resume after the newest valid record
+uint32_t ProtectionOverload_TripLogAttach(ProtectionOverloadTripLog *log, ProtectionOverloadTripRecord *records, uint32_t capacity) {
+    log->records = records;
+    log->capacity = capacity;
+    log->sequence = 0;
+    uint32_t valid = 0;
+    for (uint32_t i = 0; i < capacity; i++) {
+        if (!TripLog_Valid(&records[i]) || (records[i].sequence - 1u) % capacity != i) {
+            memset(&records[i], 0, sizeof(records[i]));
+            continue;
+        }
+        valid++;
+        if (records[i].sequence > log->sequence) {
+            log->sequence = records[i].sequence;
+        }
+    }
+    return valid;
+}
+
+// Append a record (sequence and check are set), overwriting the oldest one
+void ProtectionOverload_TripLogAppend(ProtectionOverloadTripLog *log, ProtectionOverloadTripRecord *record) {
+    record->sequence = ++log->sequence;
+    record->check = TripLog_Check(record);
+    log->records[(record->sequence - 1u) % log->capacity] = *record;
+}
+
+// Record of the trip before the newest one by age (0: newest), false if none
+bool ProtectionOverload_TripLogGet(const ProtectionOverloadTripLog *log, uint32_t age, ProtectionOverloadTripRecord *record) {
+    if (age >= log->capacity || age >= log->sequence) {
+        return false;
+    }
+    const ProtectionOverloadTripRecord *slot = &log->records[(log->sequence - 1u - age) % log->capacity];
+    if (!TripLog_Valid(slot) || slot->sequence != log->sequence - age) {
+        return false;
+    }
+    *record = *slot;
+    return true;
+}
@@ -0,0 +1,130 @@
+// Protection Overload Recorder Header
+//
+// Pre-trigger disturbance recorder: an always-on history of {current,
+// energy, state} per tick of one state machine, frozen on the tick of the
+// trip, and a trip log that survives a restart.
+//
+// The history is a ring of fixed blocks in caller-provided memory: no
+// allocation, and the oldest block is overwritten when the ring is full.
+// Samples are quantized (current to a caller LSB, energy to 2^-16) and coded
+// as zigzag varints: the current as a delta to the last sample, the energy as
+// the residual of a linear prediction (heating and cooling at a steady load
+// give a residual of 0 or 1 LSB). A sample that repeats the prediction (same
+// current and state, residual 0) only increments a run counter: a steady
+// load costs a compare per tick and 5 bytes per 2^28 ticks. Every block opens
+// with a full sample, so dropping the oldest block needs no re-encoding.
+//
+//   static ProtectionOverloadRecorderBlock blocks[128];     // 32 KB
+//   ProtectionOverload_RecorderInit(&recorder, blocks, 128, 0.01f, channel, &trip_log);
+//   ProtectionOverload_Run(&sm, current);
+//   ProtectionOverload_RecorderRecord(&recorder, &sm, current);
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PROTECTION_OVERLOAD_RECORDER_BLOCK      256u            // Block size [bytes]
+#define PROTECTION_OVERLOAD_RECORDER_ENERGY_LSB (1.0f / 65536.0f)
+#define PROTECTION_OVERLOAD_RECORDER_LIMIT      536870912.0f    // Quantized value limit (2^29): deltas fit int32
+#define PROTECTION_OVERLOAD_RECORDER_RUN_MAX    0x0FFFFFFFu     // Longest run token (5-byte varint)
+
+// History block: a full sample, then tokens
+typedef struct {
+    uint32_t first_tick;                // Tick of the first sample
+    uint16_t used;                      // Bytes of data in use
+    uint8_t data[PROTECTION_OVERLOAD_RECORDER_BLOCK - 6u];
+} ProtectionOverloadRecorderBlock;
+
+// Decoded sample
+typedef struct {
+    uint32_t tick;                      // Recorder tick (samples since Init)
+    float current;                      // Current, within half a current LSB
+    float energy;                       // Accumulated energy, within half an energy LSB
+    ProtectionOverloadState state;      // State after the tick
+} ProtectionOverloadRecorderSample;
+
+// Trip record (one per trip, checked on restart)
+typedef struct {
+    uint32_t sequence;                  // Trip number since the log was created (0: empty slot)
+    uint32_t source;                    // Source id (e.g. channel number)
+    uint32_t tick;                      // Recorder tick of the trip
+    uint32_t history_ticks;             // Pre-trigger history frozen in the recorder
+    float current;                      // Current at the trip
+    float energy;                       // Accumulated energy at the trip
+    float overload_factor;              // Overload factor at the trip
+    uint32_t check;                     // FNV-1a of the fields above
+} ProtectionOverloadTripRecord;
+
+// Trip log: ring of records in memory kept over a restart (battery-backed or
+// no-init RAM, or a copy written to flash)
+typedef struct {
+    ProtectionOverloadTripRecord *records;  // Caller-provided
+    uint32_t capacity;
+    uint32_t sequence;                  // Sequence of the last record written (0: none)
+} ProtectionOverloadTripLog;
+
+// Recorder of one state machine: fields of the per-tick compare first
+typedef struct {
+    int32_t current;                    // Last sample, quantized
+    int32_t energy;
+    int32_t energy_delta;               // Last energy step (linear prediction)
+    uint32_t run;                       // Repeats of the prediction not yet coded
+    uint8_t state;
+    bool frozen;                        // Frozen on a trip until Rearm
+    float current_scale;                // 1 / current LSB
+    uint32_t tick;                      // Ticks recorded since Init
+    ProtectionOverloadRecorderBlock *blocks;    // Caller-provided ring
+    uint32_t block_count;
+    uint32_t head;                      // Block being written
+    uint32_t used_blocks;               // Blocks holding history (oldest: head - used_blocks + 1)
+    uint32_t source;                    // Source id of the trip records
+    ProtectionOverloadTripLog *log;     // Trip log (NULL: none)
+} ProtectionOverloadRecorder;
+
+// Round to the nearest quantization step, clamped to +-PROTECTION_OVERLOAD_RECORDER_LIMIT
+static inline int32_t ProtectionOverload_RecorderQuantize(float value, float scale) {
+    float scaled = value * scale;
+    if (scaled > PROTECTION_OVERLOAD_RECORDER_LIMIT) scaled = PROTECTION_OVERLOAD_RECORDER_LIMIT;
+    if (scaled < -PROTECTION_OVERLOAD_RECORDER_LIMIT) scaled = -PROTECTION_OVERLOAD_RECORDER_LIMIT;
+    return (int32_t)(scaled + ((scaled >= 0.0f) ? 0.5f : -0.5f));
+}
+
+// Slow path: code a sample that differs from the prediction (freezes on a trip)
+void ProtectionOverload_RecorderAppend(ProtectionOverloadRecorder *recorder, const ProtectionOverloadSM *sm,
+                                       int32_t current, int32_t energy);
+
+// Record the tick of a state machine after its Run (no-op while frozen)
+static inline void ProtectionOverload_RecorderRecord(ProtectionOverloadRecorder *recorder, const ProtectionOverloadSM *sm, float current) {
+    if (recorder->frozen) {
+        return;
+    }
+    int32_t quantized_current = ProtectionOverload_RecorderQuantize(current, recorder->current_scale);
+    int32_t energy = ProtectionOverload_RecorderQuantize(sm->accumulated_energy, 1.0f / PROTECTION_OVERLOAD_RECORDER_ENERGY_LSB);
+    int32_t predicted = recorder->energy + recorder->energy_delta;
+    if (quantized_current == recorder->current && energy == predicted && sm->state == recorder->state &&
+        recorder->run < PROTECTION_OVERLOAD_RECORDER_RUN_MAX) {
+        recorder->energy = predicted;
+        recorder->run++;
+        recorder->tick++;
+        return;
+    }
+    ProtectionOverload_RecorderAppend(recorder, sm, quantized_current, energy);
+}
+
+// Recorder API (block_count at least 2, current_lsb > 0, log may be NULL)
+bool ProtectionOverload_RecorderInit(ProtectionOverloadRecorder *recorder, ProtectionOverloadRecorderBlock *blocks,
+                                     uint32_t block_count, float current_lsb, uint32_t source, ProtectionOverloadTripLog *log);
+void ProtectionOverload_RecorderRearm(ProtectionOverloadRecorder *recorder);
+uint32_t ProtectionOverload_RecorderRead(const ProtectionOverloadRecorder *recorder, ProtectionOverloadRecorderSample *samples, uint32_t max);
+uint32_t ProtectionOverload_RecorderHistoryTicks(const ProtectionOverloadRecorder *recorder);
+size_t ProtectionOverload_RecorderBytes(const ProtectionOverloadRecorder *recorder);
+
+// Trip log API: Init erases the records, Attach keeps the valid records of a
+// previous run (torn or corrupted slots are erased) and returns their number
+void ProtectionOverload_TripLogInit(ProtectionOverloadTripLog *log, ProtectionOverloadTripRecord *records, uint32_t capacity);
+uint32_t ProtectionOverload_TripLogAttach(ProtectionOverloadTripLog *log, ProtectionOverloadTripRecord *records, uint32_t capacity);
+void ProtectionOverload_TripLogAppend(ProtectionOverloadTripLog *log, ProtectionOverloadTripRecord *record);
+bool ProtectionOverload_TripLogGet(const ProtectionOverloadTripLog *log, uint32_t age, ProtectionOverloadTripRecord *record);
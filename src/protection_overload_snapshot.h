@@ -0,0 +1,86 @@
+// Protection Overload Snapshot Header
+//
+// Consistent view of a state machine for readers on other cores (HMI,
+// telemetry): {state, energy, overload factor, tick} published by the
+// protection task after each Run, read by any number of threads.
+//
+// Seqlock with a single writer: the sequence is odd while the writer updates
+// the fields and even once they are complete. A reader copies the fields and
+// retries if the sequence was odd or changed meanwhile. The writer never
+// waits and takes no lock: a publish is three plain stores around the field
+// stores, plus release ordering (no instruction on x86, dmb on Arm). Fields
+// are 32-bit relaxed atomics, so a torn read is detected instead of being a
+// data race.
+
+#pragma once
+
+#include "protection_overload.h"
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Snapshot of a state machine
+typedef struct {
+    ProtectionOverloadState state;      // State after the published tick
+    float energy;                       // Accumulated energy (1.0 = trip)
+    float overload_factor;              // Last evaluated overload factor (I / I_trip)
+    uint32_t tick;                      // Ticks run when published
+} ProtectionOverloadSnapshot;
+
+// Published snapshot (one writer)
+typedef struct {
+    atomic_uint sequence;               // Odd while being written
+    atomic_uint state;
+    atomic_uint energy;                 // float bits
+    atomic_uint overload_factor;        // float bits
+    atomic_uint tick;
+} ProtectionOverloadSeqlock;
+
+// Writer: publish a tuple (never waits)
+static inline void ProtectionOverload_SnapshotWrite(ProtectionOverloadSeqlock *lock, ProtectionOverloadState state,
+                                                    float energy, float overload_factor, uint32_t tick) {
+    unsigned int sequence = atomic_load_explicit(&lock->sequence, memory_order_relaxed);
+    atomic_store_explicit(&lock->sequence, sequence + 1u, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);  // Odd sequence visible before the fields
+
+    atomic_store_explicit(&lock->state, (unsigned int)state, memory_order_relaxed);
+    atomic_store_explicit(&lock->energy, ProtectionOverload_FloatBits(energy), memory_order_relaxed);
+    atomic_store_explicit(&lock->overload_factor, ProtectionOverload_FloatBits(overload_factor), memory_order_relaxed);
+    atomic_store_explicit(&lock->tick, tick, memory_order_relaxed);
+
+    atomic_store_explicit(&lock->sequence, sequence + 2u, memory_order_release);
+}
+
+// Writer: publish a state machine after a Run
+static inline void ProtectionOverload_SnapshotPublish(ProtectionOverloadSeqlock *lock, const ProtectionOverloadSM *sm, uint32_t tick) {
+    ProtectionOverload_SnapshotWrite(lock, ProtectionOverload_GetState(sm), ProtectionOverload_GetEnergy(sm), sm->overload_factor, tick);
+}
+
+// Reader: one attempt, false if a write was in progress (nothing copied)
+static inline bool ProtectionOverload_SnapshotTryRead(ProtectionOverloadSeqlock *lock, ProtectionOverloadSnapshot *snapshot) {
+    unsigned int begin = atomic_load_explicit(&lock->sequence, memory_order_acquire);
+    if (begin & 1u) {
+        return false;
+    }
+    ProtectionOverloadSnapshot copy = {
+        .state = (ProtectionOverloadState)atomic_load_explicit(&lock->state, memory_order_relaxed),
+        .energy = ProtectionOverload_BitsFloat(atomic_load_explicit(&lock->energy, memory_order_relaxed)),
+        .overload_factor = ProtectionOverload_BitsFloat(atomic_load_explicit(&lock->overload_factor, memory_order_relaxed)),
+        .tick = atomic_load_explicit(&lock->tick, memory_order_relaxed)
+    };
+    atomic_thread_fence(memory_order_acquire);  // Field loads complete before the sequence check
+    if (atomic_load_explicit(&lock->sequence, memory_order_relaxed) != begin) {
+        return false;
+    }
+    *snapshot = copy;
+    return true;
+}
+
+// Reader: retry until consistent (a publish takes a few ns, readers only wait for the writer)
+static inline void ProtectionOverload_SnapshotRead(ProtectionOverloadSeqlock *lock, ProtectionOverloadSnapshot *snapshot) {
+    while (!ProtectionOverload_SnapshotTryRead(lock, snapshot)) {
+    }
+}
+
+// Single instance API: snapshot of the last ProtectionOverload_SM_Run (any thread)
+void ProtectionOverload_SM_GetSnapshot(ProtectionOverloadSnapshot *snapshot);
@@ -0,0 +1,36 @@
+// Protection Overload Trace
+
+#include "protection_overload_trace.h"
+
+_Static_assert((PROTECTION_OVERLOAD_TRACE_RECORDS & (PROTECTION_OVERLOAD_TRACE_RECORDS - 1u)) == 0u,
+               "PROTECTION_OVERLOAD_TRACE_RECORDS must be a power of two");
+_Static_assert(sizeof(ProtectionOverloadTraceRecord) == 16u, "Trace record is 16 bytes");
+
+// Ring of each thread
+PROTECTION_OVERLOAD_TRACE_THREAD_LOCAL ProtectionOverloadTraceRing protection_overload_trace_ring;
+
+// Point names (decoder)
+#define PROTECTION_OVERLOAD_TRACE_NAME(id, name) [id] = name,
+static const char *const ProtectionOverload_TraceNames[TRACE_COUNT] = {
+    PROTECTION_OVERLOAD_TRACE_POINTS(PROTECTION_OVERLOAD_TRACE_NAME)
+};
+#undef PROTECTION_OVERLOAD_TRACE_NAME
+
+// Ring of the calling thread (valid while the thread runs)
+ProtectionOverloadTraceRing *ProtectionOverload_TraceRing(void) {
+    return &protection_overload_trace_ring;
+}
+
+// Last max records of a ring, oldest first (returns the records copied)
+uint32_t ProtectionOverload_TraceRead(const ProtectionOverloadTraceRing *ring, ProtectionOverloadTraceRecord *records, uint32_t max) {
+    uint32_t count = (ring->head < PROTECTION_OVERLOAD_TRACE_RECORDS) ? ring->head : PROTECTION_OVERLOAD_TRACE_RECORDS;
+    if (count > max) count = max;
+    for (uint32_t i = 0; i < count; i++) {
+        records[i] = ring->records[(ring->head - count + i) & (PROTECTION_OVERLOAD_TRACE_RECORDS - 1u)];
+    }
+    return count;
+}
+
+const char *ProtectionOverload_TraceName(unsigned int point) {
+    return (point < TRACE_COUNT) ? ProtectionOverload_TraceNames[point] : "unknown";
+}
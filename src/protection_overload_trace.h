@@ -0,0 +1,103 @@
+// Protection Overload Trace Header
+//
+// Compile-time trace points of the engine hot path. The points are listed
+// once below (X-macro): the enum, the decoder names and the engine calls are
+// generated from the list. Without PROTECTION_OVERLOAD_TRACE every point
+// expands to ((void)0) and the engine object is unchanged.
+//
+// With -DPROTECTION_OVERLOAD_TRACE, a point stores one 16-byte binary record
+// {timestamp, instance, value, point, arg} in a ring owned by the calling
+// thread: no lock, no formatting and no call on the hot path, the oldest
+// records are overwritten. Rings are dumped on the host (sim/trace_dump.c)
+// or read from target memory, and turned into a timeline by trace_decode.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Trace points: X(id, name), arg and value per point
+#define PROTECTION_OVERLOAD_TRACE_POINTS(X)                                                         \
+    X(TRACE_STATE_ENTRY,    "state entry")      /* arg: entered state, value: energy */             \
+    X(TRACE_PICKUP,         "pickup")           /* arg: 0, value: overload factor */                \
+    X(TRACE_ENERGY_LEVEL,   "energy level")     /* arg: level [%], value: energy */                 \
+    X(TRACE_TRIP,           "trip")             /* arg: 0, value: energy */
+
+// Energy levels traced while heating [% of trip energy]
+#define PROTECTION_OVERLOAD_TRACE_LEVELS(X) X(50) X(75) X(90)
+
+#define PROTECTION_OVERLOAD_TRACE_ENUM(id, name) id,
+typedef enum {
+    PROTECTION_OVERLOAD_TRACE_POINTS(PROTECTION_OVERLOAD_TRACE_ENUM)
+    TRACE_COUNT
+} ProtectionOverloadTracePoint;
+#undef PROTECTION_OVERLOAD_TRACE_ENUM
+
+// Records per thread ring (power of two)
+#ifndef PROTECTION_OVERLOAD_TRACE_RECORDS
+#define PROTECTION_OVERLOAD_TRACE_RECORDS   1024u
+#endif
+
+// Ring storage class: one ring per thread (single-threaded targets: -DPROTECTION_OVERLOAD_TRACE_THREAD_LOCAL=)
+#ifndef PROTECTION_OVERLOAD_TRACE_THREAD_LOCAL
+#define PROTECTION_OVERLOAD_TRACE_THREAD_LOCAL  _Thread_local
+#endif
+
+// Timestamp of a record (default: sequence number in the thread ring)
+#ifndef PROTECTION_OVERLOAD_TRACE_CLOCK
+#define PROTECTION_OVERLOAD_TRACE_CLOCK(ring)   ((ring)->head)
+#endif
+
+// Trace record
+typedef struct {
+    uint32_t timestamp;                 // PROTECTION_OVERLOAD_TRACE_CLOCK
+    uint32_t instance;                  // State machine address (low 32 bits)
+    float value;                        // Point value (energy or overload factor)
+    uint8_t point;                      // ProtectionOverloadTracePoint
+    uint8_t arg;                        // Point argument (state, level)
+    uint16_t reserved;
+} ProtectionOverloadTraceRecord;
+
+// Ring of one thread
+typedef struct {
+    uint32_t head;                      // Records written (sequence of the next record)
+    ProtectionOverloadTraceRecord records[PROTECTION_OVERLOAD_TRACE_RECORDS];
+} ProtectionOverloadTraceRing;
+
+extern PROTECTION_OVERLOAD_TRACE_THREAD_LOCAL ProtectionOverloadTraceRing protection_overload_trace_ring;
+
+// Writer: append to the calling thread's ring
+static inline void ProtectionOverload_TraceWrite(ProtectionOverloadTracePoint point, const void *instance, unsigned int arg, float value) {
+    ProtectionOverloadTraceRing *ring = &protection_overload_trace_ring;
+    ProtectionOverloadTraceRecord *record = &ring->records[ring->head & (PROTECTION_OVERLOAD_TRACE_RECORDS - 1u)];
+    record->timestamp = PROTECTION_OVERLOAD_TRACE_CLOCK(ring);
+    record->instance = (uint32_t)(uintptr_t)instance;
+    record->value = value;
+    record->point = (uint8_t)point;
+    record->arg = (uint8_t)arg;
+    ring->head++;
+}
+
+// Writer: energy levels crossed by a heating step
+static inline void ProtectionOverload_TraceLevels(const void *instance, float before, float after) {
+#define PROTECTION_OVERLOAD_TRACE_LEVEL(percent)                                \
+    if (before < (percent) / 100.0f && after >= (percent) / 100.0f) {           \
+        ProtectionOverload_TraceWrite(TRACE_ENERGY_LEVEL, instance, (percent), after); \
+    }
+    PROTECTION_OVERLOAD_TRACE_LEVELS(PROTECTION_OVERLOAD_TRACE_LEVEL)
+#undef PROTECTION_OVERLOAD_TRACE_LEVEL
+}
+
+// Engine trace points
+#if defined(PROTECTION_OVERLOAD_TRACE)
+#define PROTECTION_OVERLOAD_TRACE_POINT(point, sm, arg, value)  ProtectionOverload_TraceWrite((point), (sm), (arg), (value))
+#define PROTECTION_OVERLOAD_TRACE_ENERGY(sm, before, after)     ProtectionOverload_TraceLevels((sm), (before), (after))
+#else
+#define PROTECTION_OVERLOAD_TRACE_POINT(point, sm, arg, value)  ((void)0)
+#define PROTECTION_OVERLOAD_TRACE_ENERGY(sm, before, after)     ((void)0)
+#endif
+
+// Reader API: ring of the calling thread, records oldest first, point names
+ProtectionOverloadTraceRing *ProtectionOverload_TraceRing(void);
+uint32_t ProtectionOverload_TraceRead(const ProtectionOverloadTraceRing *ring, ProtectionOverloadTraceRecord *records, uint32_t max);
+const char *ProtectionOverload_TraceName(unsigned int point);
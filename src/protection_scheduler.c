@@ -0,0 +1,117 @@
+// Protection Scheduler
+
+#include "protection_scheduler.h"
+#include <string.h>
+
+// Greatest common divisor
+static uint32_t ProtectionScheduler_Gcd(uint32_t a, uint32_t b) {
+    while (b != 0) {
+        uint32_t r = a % b;
+        a = b;
+        b = r;
+    }
+    return a;
+}
+
+// Hyperperiod: LCM of all periods [base ticks], 0 if a task is invalid or the LCM overflows
+uint32_t ProtectionScheduler_Hyperperiod(const ProtectionSchedulerTask *tasks, unsigned int task_count) {
+    if (task_count == 0 || task_count > PROTECTION_SCHEDULER_MAX_TASKS) {
+        return 0;
+    }
+    uint64_t hyperperiod = 1;
+    for (unsigned int i = 0; i < task_count; i++) {
+        if (tasks[i].run == NULL || tasks[i].period == 0 || tasks[i].offset >= tasks[i].period) {
+            return 0;
+        }
+        hyperperiod = hyperperiod / ProtectionScheduler_Gcd((uint32_t)hyperperiod, tasks[i].period) * tasks[i].period;
+        if (hyperperiod > UINT16_MAX) {
+            return 0;
+        }
+    }
+    return (uint32_t)hyperperiod;
+}
+
+// Slot table entries: runs of all tasks over one hyperperiod
+uint32_t ProtectionScheduler_SlotEntries(const ProtectionSchedulerTask *tasks, unsigned int task_count) {
+    uint32_t hyperperiod = ProtectionScheduler_Hyperperiod(tasks, task_count);
+    uint32_t entries = 0;
+    for (unsigned int i = 0; hyperperiod != 0 && i < task_count; i++) {
+        entries += hyperperiod / tasks[i].period;
+    }
+    return entries;
+}
+
+// Scheduler Initialization: build slot table
+ProtectionSchedulerResult ProtectionScheduler_Init(ProtectionScheduler *sched, const ProtectionSchedulerConfig *config) {
+    uint32_t hyperperiod = ProtectionScheduler_Hyperperiod(config->tasks, config->task_count);
+    if (hyperperiod == 0) {
+        return PROTECTION_SCHEDULER_ERR_ARG;
+    }
+    uint32_t entries = ProtectionScheduler_SlotEntries(config->tasks, config->task_count);
+    if (config->slot_first_len < hyperperiod + 1 || config->slot_tasks_len < entries || entries > UINT16_MAX) {
+        return PROTECTION_SCHEDULER_ERR_SPACE;
+    }
+
+    memset(sched, 0, sizeof(*sched));
+    sched->config = *config;
+    sched->hyperperiod = hyperperiod;
+
+    // Slot s runs, in table order, every task with s = offset (mod period)
+    uint32_t entry = 0;
+    for (uint32_t slot = 0; slot < hyperperiod; slot++) {
+        config->slot_first[slot] = (uint16_t)entry;
+        for (unsigned int i = 0; i < config->task_count; i++) {
+            if (slot % config->tasks[i].period == config->tasks[i].offset) {
+                config->slot_tasks[entry++] = (uint8_t)i;
+            }
+        }
+    }
+    config->slot_first[hyperperiod] = (uint16_t)entry;
+
+    return PROTECTION_SCHEDULER_OK;
+}
+
+// Run elements due in the current slot (called once per base tick)
+void ProtectionScheduler_Tick(ProtectionScheduler *sched) {
+    const ProtectionSchedulerConfig *config = &sched->config;
+    uint32_t start = (config->clock != NULL) ? config->clock() : 0;
+    uint32_t first = config->slot_first[sched->slot];
+    uint32_t last = config->slot_first[sched->slot + 1];
+
+    for (uint32_t entry = first; entry < last; entry++) {
+        unsigned int i = config->slot_tasks[entry];
+        const ProtectionSchedulerTask *task = &config->tasks[i];
+        task->run(task->context);
+
+        if (config->clock != NULL) {
+            // Response time from tick start (includes elements run before in the slot)
+            uint32_t response = config->clock() - start;
+            if (response > sched->max_response[i]) {
+                sched->max_response[i] = response;
+            }
+            if (task->deadline != 0 && response > task->deadline) {
+                sched->overruns[i]++;
+            }
+        }
+    }
+    sched->runs += last - first;
+
+    // Slot longer than the base tick: next tick is late
+    if (config->clock != NULL && config->tick_budget != 0 && config->clock() - start > config->tick_budget) {
+        sched->slot_overruns++;
+    }
+
+    if (++sched->slot == sched->hyperperiod) {
+        sched->slot = 0;
+    }
+}
+
+/* Returns deadline misses of an element */
+uint32_t ProtectionScheduler_GetOverruns(const ProtectionScheduler *sched, unsigned int task) {
+    return (task < sched->config.task_count) ? sched->overruns[task] : 0;
+}
+
+/* Returns worst response time of an element [clock units] */
+uint32_t ProtectionScheduler_GetMaxResponse(const ProtectionScheduler *sched, unsigned int task) {
+    return (task < sched->config.task_count) ? sched->max_response[task] : 0;
+}
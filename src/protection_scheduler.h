@@ -0,0 +1,77 @@
+// Protection Scheduler Header
+//
+// Static multi-rate cooperative scheduler: every protection element runs at
+// its own period, a multiple of one base tick (e.g. 1 ms instantaneous,
+// 10 ms short-time, 100 ms thermal). Init precomputes a slot table over the
+// hyperperiod (LCM of the periods), so each tick only walks the elements due
+// in the current slot. Storage is provided by the caller, no allocation.
+//
+//   static const ProtectionSchedulerTask tasks[] = {
+//       {Instantaneous_Run, &inst, 1, 0, 200},     // Every tick, 200 cycles deadline
+//       {ShortTime_Run, &st, 10, 0, 0},
+//       {Thermal_Run, &th, 100, 5, 0},             // Offset: off the 10 ms slots
+//   };
+//   static uint16_t slot_first[100 + 1];
+//   static uint8_t slot_tasks[111];
+//   ProtectionScheduler_Init(&sched, &config);
+//   ProtectionScheduler_Tick(&sched);              // From the base tick interrupt
+//
+// Elements due in the same slot run in table order: list the fast elements
+// first to keep their latency. With a clock, each element response time
+// (from tick start to completion) is checked against its deadline, and a
+// slot running longer than the base tick is counted as a slot overrun.
+
+#pragma once
+
+#include <stdint.h>
+
+#define PROTECTION_SCHEDULER_MAX_TASKS  16      // Max elements per scheduler
+
+// Return codes
+typedef enum {
+    PROTECTION_SCHEDULER_OK = 0,
+    PROTECTION_SCHEDULER_ERR_ARG,               // Invalid task (period, offset, count)
+    PROTECTION_SCHEDULER_ERR_SPACE              // Slot table storage too small
+} ProtectionSchedulerResult;
+
+// Periodic protection element
+typedef struct {
+    void (*run)(void *context);                 // Element function
+    void *context;                              // Element instance (e.g. ProtectionOverloadSM)
+    uint16_t period;                            // Period [base ticks]
+    uint16_t offset;                            // First slot (< period), spreads slow elements
+    uint32_t deadline;                          // Max response time [clock units] (0 = none)
+} ProtectionSchedulerTask;
+
+// Scheduler configuration (tables and storage owned by the caller)
+typedef struct {
+    const ProtectionSchedulerTask *tasks;       // Elements, in priority order
+    unsigned int task_count;                    // Number of elements
+    uint32_t (*clock)(void);                    // Free-running counter (NULL = no overrun detection)
+    uint32_t tick_budget;                       // Base tick length [clock units] (0 = no slot check)
+    uint16_t *slot_first;                       // Storage [hyperperiod + 1]: first entry of each slot
+    uint32_t slot_first_len;                    // slot_first length
+    uint8_t *slot_tasks;                        // Storage [slot entries]: task indexes per slot
+    uint32_t slot_tasks_len;                    // slot_tasks length
+} ProtectionSchedulerConfig;
+
+// Scheduler state
+typedef struct {
+    ProtectionSchedulerConfig config;           // Configuration
+    uint32_t hyperperiod;                       // Slots in table [base ticks]
+    uint32_t slot;                              // Next slot
+    uint32_t runs;                              // Element runs (CPU load measure)
+    uint32_t slot_overruns;                     // Slots longer than tick_budget
+    uint32_t overruns[PROTECTION_SCHEDULER_MAX_TASKS];      // Deadline misses per element
+    uint32_t max_response[PROTECTION_SCHEDULER_MAX_TASKS];  // Worst response time per element
+} ProtectionScheduler;
+
+// Table sizing (hyperperiod, slot entries) of a task set, 0 if invalid
+uint32_t ProtectionScheduler_Hyperperiod(const ProtectionSchedulerTask *tasks, unsigned int task_count);
+uint32_t ProtectionScheduler_SlotEntries(const ProtectionSchedulerTask *tasks, unsigned int task_count);
+
+// Scheduler API
+ProtectionSchedulerResult ProtectionScheduler_Init(ProtectionScheduler *sched, const ProtectionSchedulerConfig *config);
+void ProtectionScheduler_Tick(ProtectionScheduler *sched);
+uint32_t ProtectionScheduler_GetOverruns(const ProtectionScheduler *sched, unsigned int task);
+uint32_t ProtectionScheduler_GetMaxResponse(const ProtectionScheduler *sched, unsigned int task);
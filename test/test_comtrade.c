@@ -0,0 +1,326 @@
+// COMTRADE reader unit tests
+
+#include "unity.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "comtrade.h"
+#include "protection_overload.h"
+
+#ifndef TEST_OUTPUT_DIR
+#define TEST_OUTPUT_DIR "build"
+#endif
+
+#define TEST_CFG    TEST_OUTPUT_DIR "/test_comtrade.cfg"
+#define TEST_DAT    TEST_OUTPUT_DIR "/test_comtrade.dat"
+
+#define TEST_PI     3.14159265358979
+
+// Test current value (mocked sensor value)
+float test_current = 0.0f;
+
+static ComtradeRecord rec;
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    memset(&rec, 0, sizeof(rec));
+}
+
+void tearDown(void) {
+    Comtrade_Close(&rec);
+}
+
+/* ------------------------------------------------
+        Mocked Sensor Read Function
+   ------------------------------------------------ */
+
+float Sensor_Read() {
+    return test_current;
+}
+
+/* ------------------------------------------------
+        Record Writers
+   ------------------------------------------------ */
+
+static void write_text(const char *path, const char *text) {
+    FILE *file = fopen(path, "wb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, "Cannot create test file.");
+    fputs(text, file);
+    fclose(file);
+}
+
+// Two channel record, 1 kHz, IA with a = 0.001 (raw in mA)
+static void write_cfg(const char *format, const char *rate_line) {
+    char cfg[512];
+    snprintf(cfg, sizeof(cfg),
+        "TEST STATION,RELAY1,1999\r\n"
+        "3,2A,1D\r\n"
+        "1,IA,A,,A,0.001,0.0,0,-32767,32767,1000,1,P\r\n"
+        "2,IB,B,,A,0.002,0.5,0,-32767,32767,1000,1,S\r\n"
+        "1,TRIP,,,0\r\n"
+        "50\r\n"
+        "%s"
+        "01/01/2024,00:00:00.000000\r\n"
+        "01/01/2024,00:00:00.100000\r\n"
+        "%s\r\n"
+        "1\r\n", rate_line, format);
+    write_text(TEST_CFG, cfg);
+}
+
+static void put_u32(FILE *file, uint32_t value) {
+    uint8_t bytes[4] = {value & 0xFF, (value >> 8) & 0xFF, (value >> 16) & 0xFF, (value >> 24) & 0xFF};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+static void put_i16(FILE *file, int16_t value) {
+    uint16_t u = (uint16_t)value;
+    uint8_t bytes[2] = {u & 0xFF, (u >> 8) & 0xFF};
+    fwrite(bytes, 1, sizeof(bytes), file);
+}
+
+// Binary 50 Hz sine of given RMS [A] on IA, IB constant raw value
+static void write_binary_sine(unsigned int samples, float rms) {
+    FILE *file = fopen(TEST_DAT, "wb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, "Cannot create test file.");
+    for (unsigned int n = 0; n < samples; n++) {
+        double ia = rms * sqrt(2.0) * sin(2.0 * TEST_PI * 50.0 * n / 1000.0);
+        put_u32(file, n + 1);
+        put_u32(file, n * 1000u);
+        put_i16(file, (int16_t)lround(ia / 0.001));
+        put_i16(file, 100);
+        put_i16(file, 0);
+    }
+    fclose(file);
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+void test_comtrade_cfg_parse(void) {
+    write_cfg("ASCII", "1\r\n1000,3\r\n");
+    write_text(TEST_DAT, "1,0,100,10,0\n2,1000,200,20,0\n3,2000,300,30,1\n");
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+    TEST_ASSERT_EQUAL_STRING("TEST STATION", rec.station);
+    TEST_ASSERT_EQUAL_UINT(1999, rec.rev_year);
+    TEST_ASSERT_EQUAL_UINT(2, rec.analog_count);
+    TEST_ASSERT_EQUAL_UINT(1, rec.digital_count);
+    TEST_ASSERT_EQUAL(COMTRADE_ASCII, rec.format);
+    TEST_ASSERT_EQUAL_STRING("IB", rec.analog[1].name);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.002f, rec.analog[1].a);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.5f, rec.analog[1].b);
+    TEST_ASSERT_TRUE(rec.analog[0].is_primary);
+    TEST_ASSERT_FALSE(rec.analog[1].is_primary);
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1000.0f, rec.sample_rate);
+    TEST_ASSERT_EQUAL_UINT32(3, rec.sample_count);
+}
+
+void test_comtrade_ascii_samples_scaled(void) {
+    write_cfg("ASCII", "1\r\n1000,3\r\n");
+    write_text(TEST_DAT, "1,0,100,10,0\n2,1000,,20,0\n3,2000,-300,99999,1");
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+
+    const unsigned int channels[] = {0, 1};
+    float values[2];
+    double time_sec;
+    ComtradeCursor cursor;
+    Comtrade_CursorInit(&cursor, &rec);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_CursorNext(&cursor, &time_sec, channels, 2, values));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.1f, values[0]);
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.52f, values[1]);
+
+    // Missing values (empty field, 99999) decode as NaN
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_CursorNext(&cursor, &time_sec, channels, 2, values));
+    TEST_ASSERT_TRUE(isnan(values[0]));
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, 0.001, time_sec);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_CursorNext(&cursor, &time_sec, channels, 2, values));
+    TEST_ASSERT_FLOAT_WITHIN(1e-6f, -0.3f, values[0]);
+    TEST_ASSERT_TRUE(isnan(values[1]));
+
+    TEST_ASSERT_EQUAL(COMTRADE_END, Comtrade_CursorNext(&cursor, &time_sec, channels, 2, values));
+}
+
+void test_comtrade_binary_samples_scaled(void) {
+    write_cfg("BINARY", "1\r\n1000,0\r\n");
+    write_binary_sine(100, 1.0f);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+    TEST_ASSERT_EQUAL_size_t(14, rec.record_size);
+    TEST_ASSERT_EQUAL_UINT32(100, rec.sample_count);
+
+    const unsigned int channels[] = {1};
+    float value;
+    double time_sec;
+    ComtradeCursor cursor;
+    Comtrade_CursorInit(&cursor, &rec);
+    for (unsigned int n = 0; n < 100; n++) {
+        TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_CursorNext(&cursor, &time_sec, channels, 1, &value));
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, 0.7f, value);
+    }
+    TEST_ASSERT_EQUAL(COMTRADE_END, Comtrade_CursorNext(&cursor, &time_sec, channels, 1, &value));
+}
+
+void test_comtrade_timestamps_when_no_rate(void) {
+    write_cfg("BINARY", "0\r\n0,10\r\n");
+    write_binary_sine(10, 1.0f);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, rec.sample_rate);
+
+    const unsigned int channels[] = {0};
+    float value;
+    double time_sec = 0.0;
+    ComtradeCursor cursor;
+    Comtrade_CursorInit(&cursor, &rec);
+    for (unsigned int n = 0; n < 5; n++) {
+        TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_CursorNext(&cursor, &time_sec, channels, 1, &value));
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-9, 0.004, time_sec);
+}
+
+// Missing binary timestamps (0xFFFFFFFF) continue the last sample interval
+void test_comtrade_missing_timestamp(void) {
+    write_cfg("BINARY", "0\r\n0,4\r\n");
+    FILE *file = fopen(TEST_DAT, "wb");
+    TEST_ASSERT_NOT_NULL_MESSAGE(file, "Cannot create test file.");
+    const uint32_t stamps[] = {0, 2000, 0xFFFFFFFFu, 6000};
+    for (unsigned int n = 0; n < 4; n++) {
+        put_u32(file, n + 1);
+        put_u32(file, stamps[n]);
+        put_i16(file, 1000);
+        put_i16(file, 0);
+        put_i16(file, 0);
+    }
+    fclose(file);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+    const unsigned int channels[] = {0};
+    const double times[] = {0.0, 0.002, 0.004, 0.006};
+    float value;
+    double time_sec;
+    ComtradeCursor cursor;
+    Comtrade_CursorInit(&cursor, &rec);
+    for (unsigned int n = 0; n < 4; n++) {
+        TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_CursorNext(&cursor, &time_sec, channels, 1, &value));
+        TEST_ASSERT_FLOAT_WITHIN(1e-9, times[n], time_sec);
+    }
+}
+
+void test_comtrade_invalid_channel(void) {
+    write_cfg("BINARY", "1\r\n1000,0\r\n");
+    write_binary_sine(10, 1.0f);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+
+    const unsigned int channels[] = {2};
+    ComtradeReplay replay;
+    TEST_ASSERT_EQUAL(COMTRADE_ERR_ARG, Comtrade_ReplayInit(&replay, &rec, channels, 1, COMTRADE_SIDE_RECORDED, 0.01f));
+}
+
+void test_comtrade_replay_rms(void) {
+    write_cfg("BINARY", "1\r\n1000,0\r\n");
+    write_binary_sine(1000, 2.0f);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+
+    const unsigned int channels[] = {0, 1};
+    ComtradeReplay replay;
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayInit(&replay, &rec, channels, 2, COMTRADE_SIDE_RECORDED, 0.01f));
+
+    // 1 s of record at 10 ms per call = 100 calls, max RMS among channels = IA
+    float current;
+    unsigned int calls = 0;
+    while (Comtrade_ReplayNext(&replay, &current) == COMTRADE_OK) {
+        TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, current);
+        calls++;
+    }
+    TEST_ASSERT_EQUAL_UINT(100, calls);
+}
+
+// Primary channel IA replayed on the secondary side, secondary channel IB on the primary side (CT 1000:1)
+void test_comtrade_replay_side(void) {
+    write_cfg("BINARY", "1\r\n1000,0\r\n");
+    write_binary_sine(1000, 2.0f);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+
+    const unsigned int ia[] = {0};
+    const unsigned int ib[] = {1};
+    ComtradeReplay replay;
+    float current;
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayInit(&replay, &rec, ia, 1, COMTRADE_SIDE_SECONDARY, 0.01f));
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayNext(&replay, &current));
+    TEST_ASSERT_FLOAT_WITHIN(2e-5f, 0.002f, current);
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayInit(&replay, &rec, ia, 1, COMTRADE_SIDE_PRIMARY, 0.01f));
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayNext(&replay, &current));
+    TEST_ASSERT_FLOAT_WITHIN(0.02f, 2.0f, current);
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayInit(&replay, &rec, ib, 1, COMTRADE_SIDE_PRIMARY, 0.01f));
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayNext(&replay, &current));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 700.0f, current);
+
+    // Conversion needs the transformer ratio
+    rec.analog[1].primary = 0.0f;
+    TEST_ASSERT_EQUAL(COMTRADE_ERR_CFG, Comtrade_ReplayInit(&replay, &rec, ib, 1, COMTRADE_SIDE_PRIMARY, 0.01f));
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayInit(&replay, &rec, ib, 1, COMTRADE_SIDE_RECORDED, 0.01f));
+}
+
+void test_comtrade_replay_trips_engine(void) {
+    write_cfg("BINARY", "1\r\n1000,0\r\n");
+    write_binary_sine(2000, 2.0f);
+
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_Open(&rec, TEST_CFG, TEST_DAT));
+
+    ProtectionOverloadParams params = {
+        .overload_threshold = 1.0f,
+        .k_factor = 1.0f,
+        .cooling_rate = 0.98f,
+        .max_energy = 1.0f
+    };
+    ProtectionOverload_SM_Init(&params);
+
+    const unsigned int channels[] = {0};
+    ComtradeReplay replay;
+    TEST_ASSERT_EQUAL(COMTRADE_OK, Comtrade_ReplayInit(&replay, &rec, channels, 1, COMTRADE_SIDE_RECORDED, ProtectionOverload_SM_GetCallRate()));
+
+    int iterations = 0;
+    while (ProtectionOverload_SM_GetState() != ST_OVERLOAD_TRIGGERED &&
+           Comtrade_ReplayNext(&replay, &test_current) == COMTRADE_OK) {
+        ProtectionOverload_SM_Run();
+        iterations++;
+    }
+
+    // Same trip time as fixed current 2,0 x Itrip
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, ProtectionOverload_SM_GetState());
+    TEST_ASSERT_FLOAT_WITHIN(0.033f, 0.33f, iterations * ProtectionOverload_SM_GetCallRate());
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nCOMTRADE reader\n");
+    RUN_TEST(test_comtrade_cfg_parse);
+    RUN_TEST(test_comtrade_ascii_samples_scaled);
+    RUN_TEST(test_comtrade_binary_samples_scaled);
+    RUN_TEST(test_comtrade_timestamps_when_no_rate);
+    RUN_TEST(test_comtrade_missing_timestamp);
+    RUN_TEST(test_comtrade_invalid_channel);
+
+    printf("\nCOMTRADE replay into protection engine\n");
+    RUN_TEST(test_comtrade_replay_rms);
+    RUN_TEST(test_comtrade_replay_side);
+    RUN_TEST(test_comtrade_replay_trips_engine);
+
+    return UNITY_END();
+}
@@ -0,0 +1,170 @@
+// Fleet engine unit tests
+
+#include "unity.h"
+#include "protection_overload.h"
+#include "fleet_engine.h"
+#include <stdatomic.h>
+#include <string.h>
+
+#define FLEET_COUNT         10000       // Instances (not a multiple of the shard size)
+#define FLEET_SHARD         256         // Instances per shard: 40 shards
+#define FLEET_TICKS         500         // 5 s at 10 ms
+#define FLEET_OVERLOADED    1500        // First instances in overload: uneven shard cost
+
+// Not used: currents are passed to the engine
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static const ProtectionOverloadParams fleet_params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+static ProtectionOverloadSM sm[FLEET_COUNT];
+static ProtectionOverloadSM reference[FLEET_COUNT];
+static uint32_t reference_trip[FLEET_COUNT];
+
+// Tick hook check: every instance loaded exactly once before the hook
+static atomic_uint loaded;
+static uint32_t hook_calls;
+static uint32_t hook_errors;
+
+/* ------------------------------------------------
+        Load model
+   ------------------------------------------------ */
+
+// Current of an instance at a tick: hashed, new level every second
+static float Test_Current(uint32_t instance, uint32_t tick) {
+    uint32_t h = instance * 2654435761u ^ (tick / 100u) * 40503u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    float level = (h % 256u) / 256.0f;
+    return (instance < FLEET_OVERLOADED) ? 1.2f + 2.0f * level : level;
+}
+
+static void Test_Load(void *context, uint32_t tick, uint32_t first, uint32_t count, float *currents) {
+    (void)context;
+    for (uint32_t i = 0; i < count; i++) {
+        currents[i] = Test_Current(first + i, tick);
+    }
+    atomic_fetch_add_explicit(&loaded, count, memory_order_relaxed);
+}
+
+static void Test_TickHook(void *context, uint32_t tick) {
+    (void)context;
+    hook_errors += (atomic_exchange_explicit(&loaded, 0u, memory_order_relaxed) != FLEET_COUNT);
+    hook_errors += (tick != ++hook_calls);
+}
+
+// Run the fleet with a number of threads, compare with the sequential reference
+static void Test_RunAndCompare(unsigned int threads) {
+    for (uint32_t i = 0; i < FLEET_COUNT; i++) {
+        ProtectionOverload_Init(&sm[i], &fleet_params, ProtectionOverload_SM_GetCallRate());
+    }
+    FleetEngineConfig config = {
+        .sm = sm, .count = FLEET_COUNT, .shard_channels = FLEET_SHARD, .threads = threads,
+        .load = Test_Load, .tick_hook = Test_TickHook
+    };
+    FleetEngine engine;
+    TEST_ASSERT_TRUE(FleetEngine_Create(&engine, &config));
+    TEST_ASSERT_TRUE(FleetEngine_Run(&engine, FLEET_TICKS / 2));
+    TEST_ASSERT_TRUE(FleetEngine_Run(&engine, FLEET_TICKS - FLEET_TICKS / 2));
+
+    TEST_ASSERT_EQUAL_UINT32(FLEET_TICKS, hook_calls);
+    TEST_ASSERT_EQUAL_UINT32(0, hook_errors);
+    for (uint32_t i = 0; i < FLEET_COUNT; i++) {
+        TEST_ASSERT_EQUAL_UINT32(reference_trip[i], FleetEngine_GetTripTick(&engine, i));
+        // Every Init has its own generation: the rest of the state is bit-identical
+        sm[i].generation = reference[i].generation;
+    }
+    TEST_ASSERT_EQUAL_MEMORY(reference, sm, sizeof(sm));
+    FleetEngine_Destroy(&engine);
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    // Sequential reference: one Run per instance and tick
+    for (uint32_t i = 0; i < FLEET_COUNT; i++) {
+        ProtectionOverload_Init(&reference[i], &fleet_params, ProtectionOverload_SM_GetCallRate());
+        reference_trip[i] = FLEET_ENGINE_NO_TRIP;
+        for (uint32_t tick = 1; tick <= FLEET_TICKS; tick++) {
+            ProtectionOverload_Run(&reference[i], Test_Current(i, tick));
+            if (reference_trip[i] == FLEET_ENGINE_NO_TRIP && ProtectionOverload_GetState(&reference[i]) == ST_OVERLOAD_TRIGGERED) {
+                reference_trip[i] = tick;
+            }
+        }
+    }
+    atomic_store(&loaded, 0u);
+    hook_calls = 0;
+    hook_errors = 0;
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+void test_fleet_engine_single_thread_matches_sequential(void) {
+    Test_RunAndCompare(1);
+}
+
+// Same trip ticks and bit-identical state for any thread count
+void test_fleet_engine_deterministic_across_threads(void) {
+    static const unsigned int threads[] = {2, 3, 8, 40};
+    for (unsigned int t = 0; t < sizeof(threads) / sizeof(threads[0]); t++) {
+        setUp();
+        Test_RunAndCompare(threads[t]);
+    }
+}
+
+void test_fleet_engine_trips_in_overloaded_shards_only(void) {
+    unsigned int trips = 0;
+    for (uint32_t i = 0; i < FLEET_COUNT; i++) {
+        if (reference_trip[i] != FLEET_ENGINE_NO_TRIP) {
+            TEST_ASSERT_TRUE(i < FLEET_OVERLOADED);
+            trips++;
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT(FLEET_OVERLOADED, trips);
+}
+
+// Shards rounded up to whole cache lines of instances, threads capped by shards
+void test_fleet_engine_shard_layout(void) {
+    FleetEngineConfig config = {.sm = sm, .count = 1000, .shard_channels = 100, .threads = 64, .load = Test_Load};
+    FleetEngine engine;
+    TEST_ASSERT_TRUE(FleetEngine_Create(&engine, &config));
+    TEST_ASSERT_EQUAL_UINT32(128, engine.config.shard_channels);
+    TEST_ASSERT_EQUAL_UINT(8, engine.shards);
+    TEST_ASSERT_EQUAL_UINT(8, engine.config.threads);
+    FleetEngine_Destroy(&engine);
+
+    config.load = NULL;
+    TEST_ASSERT_FALSE(FleetEngine_Create(&engine, &config));
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nSharded fleet engine\n");
+    RUN_TEST(test_fleet_engine_single_thread_matches_sequential);
+    RUN_TEST(test_fleet_engine_deterministic_across_threads);
+    RUN_TEST(test_fleet_engine_trips_in_overloaded_shards_only);
+    RUN_TEST(test_fleet_engine_shard_layout);
+
+    return UNITY_END();
+}
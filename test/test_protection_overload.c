@@ -298,6 +298,357 @@ void test_variable_current_215(void) {test_case_launch(&test_cases_variable_curr
 void test_variable_current_216(void) {test_case_launch(&test_cases_variable_current[16]);}
 void test_variable_current_217(void) {test_case_launch(&test_cases_variable_current[17]);}
 
+/* ------------------------------------------------ 
+        Test Cases - Curve Families
+   ------------------------------------------------ */
+
+// ! Curve families use the instance API, not available in the fixed ratings build
+#if !defined(PROTECTION_OVERLOAD_FIXED_CURVE)
+
+// Run instance at constant current until trip, return trip time [s]
+float test_curve_trip_time(ProtectionOverloadCurve curve, float k_factor, float current) {
+    ProtectionOverloadParams params = protectionParams;
+    params.curve = curve;
+    params.k_factor = k_factor;
+
+    ProtectionOverloadSM sm;
+    ProtectionOverload_Init(&sm, &params, ProtectionOverload_SM_GetCallRate());
+
+    int iterations = 0;
+    int max_iterations = TEST_MAX_TIME / ProtectionOverload_SM_GetCallRate();
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED && iterations < max_iterations) {
+        ProtectionOverload_Run(&sm, current);
+        iterations++;
+    }
+    TEST_ASSERT_EQUAL_MESSAGE(ST_OVERLOAD_TRIGGERED, ProtectionOverload_GetState(&sm), "Protection state mismatch.");
+    return iterations * ProtectionOverload_SM_GetCallRate();
+}
+
+// t_trip = k / (I/I_trip - 1)
+void test_curve_it_300(void) {
+    TEST_ASSERT_FLOAT_WITHIN(1.0f * protectionTolerance, 1.0f, test_curve_trip_time(CURVE_IT, 1.0f, 2.0f));
+}
+
+// t_trip = 0.14 / ((I/I_trip)^0.02 - 1)
+void test_curve_standard_inverse_301(void) {
+    TEST_ASSERT_FLOAT_WITHIN(10.03f * protectionTolerance, 10.03f, test_curve_trip_time(CURVE_STANDARD_INVERSE, 0.14f, 2.0f));
+}
+
+/* ------------------------------------------------ 
+        Test Cases - Adaptive Call Rate
+   ------------------------------------------------ */
+
+// Run instance with adaptive call rate over a current profile until trip or max_time,
+// return trip time [s] (max_time if no trip) and number of evaluations
+float test_adaptive_trip_time(const t_simulated_current_element *variable_currents, float max_time, int *evaluations) {
+    ProtectionOverloadSM sm;
+    ProtectionOverload_Init(&sm, &protectionParams, ProtectionOverload_SM_GetCallRate());
+
+    float time = 0.0f;
+    float interval = 0.0f;
+    *evaluations = 0;
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED && time < max_time) {
+        ProtectionOverload_RunElapsed(&sm, Sensor_Read_Variable_Current(variable_currents, time), interval);
+        (*evaluations)++;
+        interval = ProtectionOverload_GetNextInterval(&sm, PROTECTION_OVERLOAD_ADAPTIVE_MIN_SEC, PROTECTION_OVERLOAD_ADAPTIVE_MAX_SEC);
+        time += interval;
+    }
+    return (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED) ? time - interval : max_time;
+}
+
+// Same energy as the fixed call rate when the elapsed time is the call rate
+void test_adaptive_elapsed_302(void) {
+    ProtectionOverloadSM fixed, elapsed;
+    ProtectionOverload_Init(&fixed, &protectionParams, ProtectionOverload_SM_GetCallRate());
+    ProtectionOverload_Init(&elapsed, &protectionParams, ProtectionOverload_SM_GetCallRate());
+    for (int i = 0; i < 10; i++) {
+        ProtectionOverload_Run(&fixed, 1.4f);
+        ProtectionOverload_RunElapsed(&elapsed, 1.4f, ProtectionOverload_SM_GetCallRate());
+    }
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_GetEnergy(&fixed), ProtectionOverload_GetEnergy(&elapsed));
+}
+
+// Idle and cool: an order of magnitude fewer evaluations than the 10 ms call rate
+void test_adaptive_idle_303(void) {
+    int evaluations;
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, test_adaptive_trip_time(simulated_currents_201, 60.0f, &evaluations));
+    TEST_ASSERT_LESS_OR_EQUAL_INT((int)(60.0f / ProtectionOverload_SM_GetCallRate()) / 10 + 1, evaluations);  // +1 at start
+}
+
+// Same trip times as the fixed call rate, with fewer evaluations
+void test_adaptive_trip_304(void) {
+    int evaluations;
+    TEST_ASSERT_FLOAT_WITHIN(1.33f * protectionTolerance, 1.33f, test_adaptive_trip_time(simulated_currents_206, 10.0f, &evaluations));
+    TEST_ASSERT_LESS_OR_EQUAL_INT((int)(1.33f / ProtectionOverload_SM_GetCallRate()) / 4, evaluations);
+    TEST_ASSERT_FLOAT_WITHIN(4.27f * protectionTolerance, 4.27f, test_adaptive_trip_time(simulated_currents_213, 10.0f, &evaluations));
+    TEST_ASSERT_FLOAT_WITHIN(0.12f * protectionTolerance, 0.12f, test_adaptive_trip_time(simulated_currents_217, 10.0f, &evaluations));
+}
+
+#endif
+
+/* ------------------------------------------------ 
+        Test Cases - Transition Hooks
+   ------------------------------------------------ */
+
+// Hook calls recorded by the tests
+typedef struct {
+    int pickups;
+    int trips;
+    int resets;
+    int dropouts;
+    int tick;                           // Ticks run by the test
+    int trip_tick;                      // Tick of the last on_trip
+    ProtectionOverloadState trip_state; // State seen by on_trip
+} t_hook_log;
+
+static void test_hook_pickup(void *context, const ProtectionOverloadSM *sm) {
+    (void)sm;
+    ((t_hook_log *)context)->pickups++;
+}
+
+static void test_hook_trip(void *context, const ProtectionOverloadSM *sm) {
+    t_hook_log *log = context;
+    log->trips++;
+    log->trip_tick = log->tick;
+    log->trip_state = (ProtectionOverloadState)sm->state;
+}
+
+static void test_hook_reset(void *context, const ProtectionOverloadSM *sm) {
+    (void)sm;
+    ((t_hook_log *)context)->resets++;
+}
+
+static void test_hook_dropout(void *context, const ProtectionOverloadSM *sm) {
+    (void)sm;
+    ((t_hook_log *)context)->dropouts++;
+}
+
+// Hooks recording to a log
+#define TEST_HOOKS(log) {.on_pickup = test_hook_pickup, .on_trip = test_hook_trip, \
+                         .on_reset = test_hook_reset, .on_dropout = test_hook_dropout, .context = &(log)}
+
+// Run the single instance at a current until trip or max ticks, return ticks run
+static int test_hooks_run(t_hook_log *log, float current, int max_ticks) {
+    test_current = current;
+    int ticks = 0;
+    while (ProtectionOverload_SM_GetState() != ST_OVERLOAD_TRIGGERED && ticks < max_ticks) {
+        log->tick++;
+        ProtectionOverload_SM_Run();
+        ticks++;
+    }
+    return ticks;
+}
+
+// Pickup and trip hooks fire once, on the tick of the transition
+void test_hooks_pickup_trip_305(void) {
+    t_hook_log log = {0};
+    const ProtectionOverloadHooks hooks = TEST_HOOKS(log);
+    ProtectionOverload_SM_Init(&protectionParams);
+    ProtectionOverload_SM_SetHooks(&hooks);
+
+    test_hooks_run(&log, 0.5f, 100);
+    TEST_ASSERT_EQUAL_INT(0, log.pickups + log.trips + log.resets);
+
+    test_hooks_run(&log, 2.0f, 1000);
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, ProtectionOverload_SM_GetState());
+    TEST_ASSERT_EQUAL_INT(1, log.pickups);
+    TEST_ASSERT_EQUAL_INT(1, log.trips);
+    TEST_ASSERT_EQUAL_INT(log.tick, log.trip_tick);
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, log.trip_state);
+
+    // Tripped: no further events
+    for (int i = 0; i < 100; i++) {
+        ProtectionOverload_SM_Run();
+    }
+    TEST_ASSERT_EQUAL_INT(1, log.pickups);
+    TEST_ASSERT_EQUAL_INT(1, log.trips);
+}
+
+// Each rise above pickup is one pickup; reset re-arms and fires on_reset
+void test_hooks_reset_306(void) {
+    t_hook_log log = {0};
+    const ProtectionOverloadHooks hooks = TEST_HOOKS(log);
+    ProtectionOverload_SM_Init(&protectionParams);
+    ProtectionOverload_SM_SetHooks(&hooks);
+
+    for (int i = 0; i < 3; i++) {
+        test_hooks_run(&log, 1.2f, 10);
+        test_hooks_run(&log, 0.5f, 10);
+    }
+    TEST_ASSERT_EQUAL_INT(3, log.pickups);
+    TEST_ASSERT_EQUAL_INT(3, log.dropouts);
+    TEST_ASSERT_EQUAL_INT(0, log.trips);
+
+    int first = test_hooks_run(&log, 3.0f, 1000);
+    TEST_ASSERT_EQUAL_INT(1, log.trips);
+
+    // Breaker open for 0.5 s: the thermal image cools from about 1.0 to 0.5
+    test_current = 0.0f;
+    for (int i = 0; i < 50; i++) {
+        ProtectionOverload_SM_Run();
+    }
+    TEST_ASSERT_TRUE(ProtectionOverload_SM_Reset());
+    TEST_ASSERT_EQUAL_INT(1, log.resets);
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_SM_GetState());
+
+    // Re-armed with the thermal image: trips in about half the time
+    TEST_ASSERT_INT_WITHIN(2, first / 2, test_hooks_run(&log, 3.0f, 1000));
+    TEST_ASSERT_EQUAL_INT(5, log.pickups);
+    TEST_ASSERT_EQUAL_INT(2, log.trips);
+    TEST_ASSERT_EQUAL_INT(log.tick, log.trip_tick);
+    TEST_ASSERT_EQUAL_INT(3, log.dropouts);
+}
+
+/* ------------------------------------------------ 
+        Test Cases - Pickup and Dropout
+   ------------------------------------------------ */
+
+// ! Pickup and dropout ratios are runtime parameters of the instance API
+#if !defined(PROTECTION_OVERLOAD_FIXED_CURVE)
+
+// Run an instance with a current alternating every tick between two values,
+// return ticks run until trip (max_ticks if no trip)
+static int test_hysteresis_run(ProtectionOverloadSM *sm, t_hook_log *log, float high, float low, int max_ticks) {
+    int ticks = 0;
+    while (ProtectionOverload_GetState(sm) != ST_OVERLOAD_TRIGGERED && ticks < max_ticks) {
+        log->tick++;
+        ProtectionOverload_Run(sm, (ticks & 1) ? low : high);
+        ticks++;
+    }
+    return ticks;
+}
+
+// Current hovering around pickup: without dropout hysteresis the state toggles
+// every tick and cooling wins, with a 0.95 dropout ratio it stays picked up
+void test_pickup_dropout_hysteresis_307(void) {
+    t_hook_log log = {0};
+    const ProtectionOverloadHooks hooks = TEST_HOOKS(log);
+    ProtectionOverloadSM sm;
+    ProtectionOverload_Init(&sm, &protectionParams, ProtectionOverload_SM_GetCallRate());
+    ProtectionOverload_SetHooks(&sm, &hooks);
+    TEST_ASSERT_EQUAL_INT(1000, test_hysteresis_run(&sm, &log, 1.16f, 1.12f, 1000));
+    TEST_ASSERT_EQUAL_INT(500, log.pickups);
+    TEST_ASSERT_EQUAL_INT(500, log.dropouts);
+
+    ProtectionOverloadParams params = protectionParams;
+    params.dropout_ratio = 0.95f;
+    log = (t_hook_log){0};
+    ProtectionOverload_Init(&sm, &params, ProtectionOverload_SM_GetCallRate());
+    ProtectionOverload_SetHooks(&sm, &hooks);
+    test_hysteresis_run(&sm, &log, 1.16f, 1.12f, 10);
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_EQUAL_INT(1, log.pickups);
+    TEST_ASSERT_EQUAL_INT(0, log.dropouts);
+
+    // Dropout at 0.95 x 1.15 = 1.0925 x I_trip
+    ProtectionOverload_Run(&sm, 1.10f);
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_GetState(&sm));
+    ProtectionOverload_Run(&sm, 1.09f);
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_EQUAL_INT(1, log.dropouts);
+
+    // Picked up again: heats on both currents until trip (I2t: 1 / 0.3 = 3.3 s)
+    int ticks = test_hysteresis_run(&sm, &log, 1.16f, 1.12f, 1000);
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_INT_WITHIN(15, 330, ticks);
+    TEST_ASSERT_EQUAL_INT(2, log.pickups);
+    TEST_ASSERT_EQUAL_INT(1, log.trips);
+}
+
+// Configurable pickup level, ST_PICKUP while timing
+void test_pickup_ratio_308(void) {
+    ProtectionOverloadParams params = protectionParams;
+    params.pickup_ratio = 1.3f;
+    ProtectionOverloadSM sm;
+    ProtectionOverload_Init(&sm, &params, ProtectionOverload_SM_GetCallRate());
+    for (int i = 0; i < 1000; i++) {
+        ProtectionOverload_Run(&sm, 1.25f);
+    }
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ProtectionOverload_GetEnergy(&sm));
+
+    ProtectionOverload_Run(&sm, 1.35f);
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_TRUE(ProtectionOverload_GetEnergy(&sm) > 0.0f);
+    ProtectionOverload_Run(&sm, 1.25f);
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_GetState(&sm));
+}
+
+/* ------------------------------------------------ 
+        Test Cases - Reset and Lockout
+   ------------------------------------------------ */
+
+// Trip an instance at 3 x I_trip, return energy at trip
+static float test_lockout_trip(ProtectionOverloadSM *sm, const ProtectionOverloadParams *params) {
+    ProtectionOverload_Init(sm, params, ProtectionOverload_SM_GetCallRate());
+    while (ProtectionOverload_GetState(sm) != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverload_Run(sm, 3.0f);
+    }
+    return ProtectionOverload_GetEnergy(sm);
+}
+
+// Reset refused until the thermal image has cooled to the lockout energy,
+// remaining lockout in closed form
+void test_reset_lockout_309(void) {
+    ProtectionOverloadParams params = protectionParams;
+    params.lockout_energy = 0.5f;
+    ProtectionOverloadSM sm;
+    float trip_energy = test_lockout_trip(&sm, &params);
+
+    // max_energy 1.0: cooling at 1 per second
+    float lockout = ProtectionOverload_GetLockoutTime(&sm);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, trip_energy - 0.5f, lockout);
+    TEST_ASSERT_FALSE(ProtectionOverload_Reset(&sm));
+
+    int ticks = 0;
+    while (ProtectionOverload_GetLockoutTime(&sm) > 0.0f) {
+        TEST_ASSERT_FALSE(ProtectionOverload_Reset(&sm));
+        ProtectionOverload_Run(&sm, 0.0f);
+        ticks++;
+    }
+    TEST_ASSERT_INT_WITHIN(1, (int)(lockout / ProtectionOverload_SM_GetCallRate()) + 1, ticks);
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, ProtectionOverload_GetState(&sm));
+
+    TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, ProtectionOverload_GetEnergy(&sm));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ProtectionOverload_GetLockoutTime(&sm));
+    TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+}
+
+// Automatic re-arm: ticking, and tickless in one evaluation at the end of the lockout
+void test_reset_auto_310(void) {
+    t_hook_log log = {0};
+    const ProtectionOverloadHooks hooks = TEST_HOOKS(log);
+    ProtectionOverloadParams params = protectionParams;
+    params.lockout_energy = 0.2f;
+    params.auto_reset = true;
+    ProtectionOverloadSM sm;
+
+    float lockout = test_lockout_trip(&sm, &params) - 0.2f;
+    ProtectionOverload_SetHooks(&sm, &hooks);
+    int ticks = 0;
+    while (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED && ticks < 1000) {
+        ProtectionOverload_Run(&sm, 0.0f);
+        ticks++;
+    }
+    TEST_ASSERT_INT_WITHIN(1, (int)(lockout / ProtectionOverload_SM_GetCallRate()) + 1, ticks);
+    TEST_ASSERT_EQUAL_INT(1, log.resets);
+    TEST_ASSERT_EQUAL_INT(0, log.dropouts);
+
+    test_lockout_trip(&sm, &params);
+    ProtectionOverload_SetHooks(&sm, &hooks);
+    float interval = ProtectionOverload_GetNextInterval(&sm, PROTECTION_OVERLOAD_ADAPTIVE_MIN_SEC, PROTECTION_OVERLOAD_ADAPTIVE_MAX_SEC);
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_GetLockoutTime(&sm), interval);
+    TEST_ASSERT_TRUE(interval > PROTECTION_OVERLOAD_ADAPTIVE_MAX_SEC);
+    ProtectionOverload_RunElapsed(&sm, 0.0f, interval);
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_EQUAL_INT(2, log.resets);
+    TEST_ASSERT_FLOAT_WITHIN(1e-5f, 0.2f, ProtectionOverload_GetEnergy(&sm));
+}
+
+#endif
+
 /* ------------------------------------------------ 
         Main Function
    ------------------------------------------------ */  
@@ -336,5 +687,35 @@ int main() {
     RUN_TEST(test_variable_current_216);
     RUN_TEST(test_variable_current_217);
 
+#if !defined(PROTECTION_OVERLOAD_FIXED_CURVE)
+    // Test cases with other curve families
+    printf("\nProtection Overload Test with curve families\n");
+    RUN_TEST(test_curve_it_300);
+    RUN_TEST(test_curve_standard_inverse_301);
+
+    // Test cases with adaptive call rate
+    printf("\nProtection Overload Test with adaptive call rate\n");
+    RUN_TEST(test_adaptive_elapsed_302);
+    RUN_TEST(test_adaptive_idle_303);
+    RUN_TEST(test_adaptive_trip_304);
+#endif
+
+    // Test cases with transition hooks
+    printf("\nProtection Overload Test with transition hooks\n");
+    RUN_TEST(test_hooks_pickup_trip_305);
+    RUN_TEST(test_hooks_reset_306);
+
+#if !defined(PROTECTION_OVERLOAD_FIXED_CURVE)
+    // Test cases with pickup and dropout levels
+    printf("\nProtection Overload Test with pickup and dropout levels\n");
+    RUN_TEST(test_pickup_dropout_hysteresis_307);
+    RUN_TEST(test_pickup_ratio_308);
+
+    // Test cases with reset and lockout
+    printf("\nProtection Overload Test with reset and lockout\n");
+    RUN_TEST(test_reset_lockout_309);
+    RUN_TEST(test_reset_auto_310);
+#endif
+
     return UNITY_END();    
 }
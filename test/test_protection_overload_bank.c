@@ -0,0 +1,220 @@
+// Multi-channel bank unit tests
+
+#include "unity.h"
+#include "protection_overload.h"
+#include "protection_overload_bank.h"
+#include "protection_overload_pool.h"
+#include <stdint.h>
+#include <string.h>
+
+#define BANK_CHANNELS   150             // Not a multiple of 64: partial last word
+#define BANK_TICKS      2000            // 20 s at 10 ms
+
+// Lazy cooling (one closed-form step) vs per-tick decrements: float rounding only
+#define BANK_ENERGY_TOLERANCE   1e-5f
+
+// Not used: currents are passed to the bank
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static ProtectionOverloadParams params[BANK_CHANNELS];
+static float currents[BANK_CHANNELS];
+static float pickup_current[BANK_CHANNELS];
+static ProtectionOverloadBankChannel channel[BANK_CHANNELS];
+static uint64_t armed[PROTECTION_OVERLOAD_BANK_WORDS(BANK_CHANNELS)];
+static uint64_t active[PROTECTION_OVERLOAD_BANK_WORDS(BANK_CHANNELS)];
+static ProtectionOverloadBank bank;
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    // Channel settings: thresholds 1..2 A, curves and k rotating
+    for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+        params[i] = (ProtectionOverloadParams){
+            .overload_threshold = 1.0f + (i % 10) * 0.1f,
+            .k_factor = (i % 3 == 2) ? 0.14f : 1.0f + (i % 4),
+            .cooling_rate = 0.98f,
+            .max_energy = 1.0f + (i % 5),
+            .curve = (ProtectionOverloadCurve)(i % 3)
+        };
+        currents[i] = 0.0f;
+    }
+    const ProtectionOverloadBankStorage storage = {pickup_current, channel, armed, active};
+    TEST_ASSERT_TRUE(ProtectionOverload_BankInit(&bank, params, BANK_CHANNELS, ProtectionOverload_SM_GetCallRate(), &storage));
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+void test_bank_idle_channels_skipped(void) {
+    for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+        currents[i] = 0.9f * params[i].overload_threshold;
+    }
+    ProtectionOverload_BankRun(&bank, currents);
+    TEST_ASSERT_EQUAL_UINT(0, ProtectionOverload_BankGetActiveCount(&bank));
+
+    // Overload on 3 channels, one in the partial last word
+    currents[0] = 2.0f * params[0].overload_threshold;
+    currents[70] = 1.2f * params[70].overload_threshold;
+    currents[149] = 3.0f * params[149].overload_threshold;
+    ProtectionOverload_BankRun(&bank, currents);
+    TEST_ASSERT_EQUAL_UINT(3, ProtectionOverload_BankGetActiveCount(&bank));
+    float energy = ProtectionOverload_BankGetEnergy(&bank, 0);
+    TEST_ASSERT_TRUE(energy > 0.0f);
+
+    // Overload removed: cooling is lazy, no channel processed
+    currents[0] = currents[70] = currents[149] = 0.0f;
+    ProtectionOverload_BankRun(&bank, currents);
+    TEST_ASSERT_EQUAL_UINT(0, ProtectionOverload_BankGetActiveCount(&bank));
+    float cooling_tick = ProtectionOverload_SM_GetCallRate() / params[0].max_energy;
+    TEST_ASSERT_FLOAT_WITHIN(BANK_ENERGY_TOLERANCE, energy - cooling_tick, ProtectionOverload_BankGetEnergy(&bank, 0));
+    for (int tick = 0; tick < 1000; tick++) {
+        ProtectionOverload_BankRun(&bank, currents);
+    }
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ProtectionOverload_BankGetEnergy(&bank, 0));
+}
+
+// Channels below pickup are not written while cooling
+void test_bank_lazy_cooling_no_writes(void) {
+    currents[3] = 2.0f * params[3].overload_threshold;
+    for (int tick = 0; tick < 10; tick++) {
+        ProtectionOverload_BankRun(&bank, currents);
+    }
+    currents[3] = 0.0f;
+
+    static ProtectionOverloadBankChannel before[BANK_CHANNELS];
+    memcpy(before, channel, sizeof(channel));
+    for (int tick = 0; tick < 100; tick++) {
+        ProtectionOverload_BankRun(&bank, currents);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(before, channel, sizeof(channel));
+    TEST_ASSERT_TRUE(ProtectionOverload_BankGetEnergy(&bank, 3) < before[3].energy);
+}
+
+void test_bank_tripped_channels_skipped(void) {
+    currents[5] = 3.0f * params[5].overload_threshold;
+    int ticks = 0;
+    while (ProtectionOverload_BankGetState(&bank, 5) != ST_OVERLOAD_TRIGGERED && ticks < BANK_TICKS) {
+        ProtectionOverload_BankRun(&bank, currents);
+        ticks++;
+    }
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, ProtectionOverload_BankGetState(&bank, 5));
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_BankGetState(&bank, 4));
+
+    ProtectionOverload_BankRun(&bank, currents);
+    TEST_ASSERT_EQUAL_UINT(0, ProtectionOverload_BankGetActiveCount(&bank));
+}
+
+// Same energies (within rounding) and trips as one state machine per channel
+void test_bank_matches_single_instances(void) {
+    static ProtectionOverloadSM sm[BANK_CHANNELS];
+    for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+        ProtectionOverload_Init(&sm[i], &params[i], ProtectionOverload_SM_GetCallRate());
+    }
+
+    // Pseudo-random load steps between 0 and 3 x I_trip, including factors at pickup
+    uint32_t seed = 12345u;
+    for (int tick = 0; tick < BANK_TICKS; tick++) {
+        if (tick % 50 == 0) {
+            for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                float factor = (seed >> 8) * (3.0f / 16777216.0f);
+                currents[i] = ((seed & 7u) == 0 ? PROTECTION_OVERLOAD_PICKUP : factor) * params[i].overload_threshold;
+            }
+        }
+        ProtectionOverload_BankRun(&bank, currents);
+        for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+            ProtectionOverload_Run(&sm[i], currents[i]);
+        }
+    }
+
+    unsigned int trips = 0;
+    for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+        TEST_ASSERT_EQUAL(ProtectionOverload_GetState(&sm[i]), ProtectionOverload_BankGetState(&bank, i));
+        TEST_ASSERT_FLOAT_WITHIN(BANK_ENERGY_TOLERANCE, ProtectionOverload_GetEnergy(&sm[i]), ProtectionOverload_BankGetEnergy(&bank, i));
+        trips += (ProtectionOverload_BankGetState(&bank, i) == ST_OVERLOAD_TRIGGERED);
+    }
+    TEST_ASSERT_TRUE(trips > 0 && trips < BANK_CHANNELS);
+}
+
+// Storage carved from one pooled block: aligned, disjoint arrays, same results
+// No dropout band and no re-arm in the bank: such parameters are rejected
+void test_bank_rejects_dropout_band_and_auto_reset(void) {
+    const ProtectionOverloadBankStorage storage = {pickup_current, channel, armed, active};
+    ProtectionOverloadBank other;
+    params[3].dropout_ratio = 0.9f;
+    TEST_ASSERT_FALSE(ProtectionOverload_BankInit(&other, params, BANK_CHANNELS, ProtectionOverload_SM_GetCallRate(), &storage));
+    params[3].dropout_ratio = 1.0f;
+    TEST_ASSERT_TRUE(ProtectionOverload_BankInit(&other, params, BANK_CHANNELS, ProtectionOverload_SM_GetCallRate(), &storage));
+    params[5].auto_reset = true;
+    TEST_ASSERT_FALSE(ProtectionOverload_BankInit(&other, params, BANK_CHANNELS, ProtectionOverload_SM_GetCallRate(), &storage));
+    params[5].auto_reset = false;
+}
+
+void test_bank_storage_block(void) {
+    ProtectionOverloadPool pool;
+    size_t size = ProtectionOverload_BankStorageSize(BANK_CHANNELS);
+    TEST_ASSERT_TRUE(ProtectionOverload_PoolAlloc(&pool, size, true));
+    TEST_ASSERT_TRUE(pool.size >= size);
+    TEST_ASSERT_EQUAL_UINT(0, (uintptr_t)pool.base % PROTECTION_OVERLOAD_POOL_ALIGN);
+
+    ProtectionOverloadBankStorage storage;
+    ProtectionOverload_BankStorageInit(&storage, pool.base, BANK_CHANNELS);
+    uintptr_t base = (uintptr_t)pool.base;
+    uintptr_t arrays[][2] = {
+        {(uintptr_t)storage.armed, PROTECTION_OVERLOAD_BANK_WORDS(BANK_CHANNELS) * sizeof(uint64_t)},
+        {(uintptr_t)storage.active, PROTECTION_OVERLOAD_BANK_WORDS(BANK_CHANNELS) * sizeof(uint64_t)},
+        {(uintptr_t)storage.pickup_current, BANK_CHANNELS * sizeof(float)},
+        {(uintptr_t)storage.channel, BANK_CHANNELS * sizeof(ProtectionOverloadBankChannel)}
+    };
+    for (unsigned int a = 0; a < 4; a++) {
+        TEST_ASSERT_EQUAL_UINT(0, arrays[a][0] % PROTECTION_OVERLOAD_BANK_ALIGN);
+        TEST_ASSERT_TRUE(arrays[a][0] + arrays[a][1] <= base + size);
+        if (a > 0) {
+            TEST_ASSERT_TRUE(arrays[a - 1][0] + arrays[a - 1][1] <= arrays[a][0]);
+        }
+    }
+
+    ProtectionOverloadBank pooled;
+    TEST_ASSERT_TRUE(ProtectionOverload_BankInit(&pooled, params, BANK_CHANNELS, ProtectionOverload_SM_GetCallRate(), &storage));
+    for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+        currents[i] = (i % 4 == 0) ? 2.0f * params[i].overload_threshold : 0.5f * params[i].overload_threshold;
+    }
+    for (int tick = 0; tick < BANK_TICKS; tick++) {
+        ProtectionOverload_BankRun(&bank, currents);
+        ProtectionOverload_BankRun(&pooled, currents);
+    }
+    for (unsigned int i = 0; i < BANK_CHANNELS; i++) {
+        TEST_ASSERT_EQUAL(ProtectionOverload_BankGetState(&bank, i), ProtectionOverload_BankGetState(&pooled, i));
+        TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_BankGetEnergy(&bank, i), ProtectionOverload_BankGetEnergy(&pooled, i));
+    }
+
+    ProtectionOverload_PoolFree(&pool);
+    TEST_ASSERT_NULL(pool.base);
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nMulti-channel bank with active set\n");
+    RUN_TEST(test_bank_idle_channels_skipped);
+    RUN_TEST(test_bank_tripped_channels_skipped);
+    RUN_TEST(test_bank_lazy_cooling_no_writes);
+    RUN_TEST(test_bank_matches_single_instances);
+    RUN_TEST(test_bank_rejects_dropout_band_and_auto_reset);
+    RUN_TEST(test_bank_storage_block);
+
+    return UNITY_END();
+}
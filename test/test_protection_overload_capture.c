@@ -0,0 +1,347 @@
+// Record and replay unit tests (single instance API through the input tap)
+
+#include "unity.h"
+#include "unity_bench.h"
+#include "protection_overload.h"
+#include "protection_overload_capture.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef TEST_OUTPUT_DIR
+#define TEST_OUTPUT_DIR "build"
+#endif
+
+#define TEST_CAPTURE        TEST_OUTPUT_DIR "/test_capture.bin"
+#define CAPTURE_BUFFER      65536u      // Capture buffer [bytes]
+#define CAPTURE_EVENTS      8192u       // Expected events of the scripted profile
+#define CAPTURE_HOUR_TICKS  360000u     // One hour at 10 ms
+#define CAPTURE_CLOCK_STEP  10000u      // Fake clock [us] per tick
+#define CAPTURE_BENCH_RUNS  1000000     // Calls per timed batch
+#define CAPTURE_MIN_SPEED   100.0       // Replay speed [x real time]
+
+// Test current value (mocked sensor value), also fed by the replay
+static float test_current = 0.0f;
+
+float Sensor_Read() {
+    return test_current;
+}
+
+static ProtectionOverloadParams params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+static ProtectionOverloadCapture capture;
+static uint8_t buffer[CAPTURE_BUFFER];
+
+// Fake clock [us]: 10 ms steps with a 3 us jitter every 7th tick
+static uint64_t clock_us;
+static uint32_t clock_calls;
+static uint64_t Test_Clock(void) {
+    clock_us += CAPTURE_CLOCK_STEP + ((++clock_calls % 7u) == 0 ? 3u : 0u);
+    return clock_us;
+}
+
+// Deterministic noise in [-1, 1)
+static uint32_t noise_state = 1u;
+static float Test_Noise(void) {
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return (float)(int32_t)noise_state * (1.0f / 2147483648.0f);
+}
+
+// Events expected from the recording
+static ProtectionOverloadCaptureEvent expected[CAPTURE_EVENTS];
+static uint32_t expected_count;
+
+static void Test_Expect(ProtectionOverloadCaptureEventType type) {
+    TEST_ASSERT_TRUE(expected_count < CAPTURE_EVENTS);
+    expected[expected_count++] = (ProtectionOverloadCaptureEvent){.type = type, .current = test_current, .timestamp = clock_us};
+}
+
+static void Test_Run(float current) {
+    ProtectionOverloadState state = ProtectionOverload_SM_GetState();
+    test_current = current;
+    ProtectionOverload_SM_Run();
+    Test_Expect(CAPTURE_EVENT_SAMPLE);
+    if (ProtectionOverload_SM_GetState() == ST_OVERLOAD_TRIGGERED && state != ST_OVERLOAD_TRIGGERED) {
+        Test_Expect(CAPTURE_EVENT_TRIP);
+    }
+}
+
+// Steady load, a step, noise, overload to trip, resets and a second init
+static void Test_RecordProfile(void) {
+    expected_count = 0;
+    clock_us = 0;
+    clock_calls = 0;
+    ProtectionOverload_CaptureStart(&capture, buffer, sizeof(buffer), NULL, NULL, Test_Clock);
+    ProtectionOverload_SM_Init(&params);
+    Test_Expect(CAPTURE_EVENT_INIT);
+    for (int i = 0; i < 1000; i++) {
+        Test_Run(0.5f);
+    }
+    for (int i = 0; i < 500; i++) {
+        Test_Run(0.8f);
+    }
+    for (int i = 0; i < 500; i++) {
+        Test_Run(1.0f + 0.1f * Test_Noise());
+    }
+    while (ProtectionOverload_SM_GetState() != ST_OVERLOAD_TRIGGERED) {
+        Test_Run(2.0f + 0.05f * Test_Noise());
+    }
+    Test_Run(0.0f);
+    ProtectionOverload_SM_Reset();
+    Test_Expect(CAPTURE_EVENT_RESET);
+    for (int i = 0; i < 200; i++) {
+        Test_Run(0.0f);
+    }
+    ProtectionOverloadParams other = params;
+    other.k_factor = 4.0f;
+    other.lockout_energy = 0.5f;
+    ProtectionOverload_SM_Init(&other);
+    Test_Expect(CAPTURE_EVENT_INIT);
+    while (ProtectionOverload_SM_GetState() != ST_OVERLOAD_TRIGGERED) {
+        Test_Run(1.5f);
+    }
+    // Locked out: the rejected reset is an input too
+    TEST_ASSERT_FALSE(ProtectionOverload_SM_Reset());
+    Test_Expect(CAPTURE_EVENT_RESET);
+    for (int i = 0; i < 300; i++) {
+        Test_Run(0.2f);
+    }
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureStop(&capture));
+    Test_Expect(CAPTURE_EVENT_END);
+}
+
+// Steady clock [us] of a periodic task
+static uint64_t Test_SteadyClock(void) {
+    clock_us += CAPTURE_CLOCK_STEP;
+    return clock_us;
+}
+
+// Flush callback: append to a file
+static void Test_WriteChunk(void *context, const uint8_t *data, size_t size) {
+    TEST_ASSERT_EQUAL_size_t(size, fwrite(data, 1, size, context));
+}
+
+// Flush callback: count only
+static uint64_t discarded;
+static void Test_DiscardChunk(void *context, const uint8_t *data, size_t size) {
+    (void)context;
+    (void)data;
+    discarded += size;
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    ProtectionOverload_SM_SetInputTap(NULL);
+}
+
+void tearDown(void) {
+    ProtectionOverload_SM_SetInputTap(NULL);
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+// Every input decoded in order: currents bit for bit, timestamps, commands
+void test_capture_round_trip(void) {
+    Test_RecordProfile();
+    TEST_ASSERT_EQUAL_UINT64(capture.bytes, capture.used);
+
+    ProtectionOverloadCaptureReader reader;
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureOpen(&reader, buffer, capture.used));
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_SM_GetCallRate(), reader.header.call_rate_sec);
+    ProtectionOverloadCaptureEvent event;
+    uint32_t count = 0;
+    uint32_t inits = 0;
+    while (ProtectionOverload_CaptureNext(&reader, &event)) {
+        TEST_ASSERT_TRUE(count < expected_count);
+        TEST_ASSERT_EQUAL_INT(expected[count].type, event.type);
+        if (event.type == CAPTURE_EVENT_SAMPLE) {
+            TEST_ASSERT_EQUAL_MEMORY(&expected[count].current, &event.current, sizeof(float));
+            TEST_ASSERT_EQUAL_UINT64(expected[count].timestamp, event.timestamp);
+        } else if (event.type == CAPTURE_EVENT_INIT) {
+            TEST_ASSERT_EQUAL_FLOAT((inits == 0) ? 1.0f : 4.0f, event.params.k_factor);
+            inits++;
+        }
+        count++;
+    }
+    TEST_ASSERT_FALSE(reader.error);
+    TEST_ASSERT_EQUAL_UINT32(expected_count, count);
+    TEST_ASSERT_EQUAL_UINT32(2, inits);
+
+    // Unknown layout
+    buffer[4]++;
+    TEST_ASSERT_FALSE(ProtectionOverload_CaptureOpen(&reader, buffer, capture.used));
+    buffer[4]--;
+}
+
+// Replay through SM_Run: same trips, same energy bits, same final state; a changed setting is caught
+void test_capture_replay_bit_exact(void) {
+    Test_RecordProfile();
+    uint32_t samples = 0;
+    uint32_t trips = 0;
+    for (uint32_t i = 0; i < expected_count; i++) {
+        samples += (expected[i].type == CAPTURE_EVENT_SAMPLE);
+        trips += (expected[i].type == CAPTURE_EVENT_TRIP);
+    }
+
+    ProtectionOverload_SM_Init(&params);
+    ProtectionOverloadCaptureReader reader;
+    ProtectionOverloadReplayResult result;
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureOpen(&reader, buffer, capture.used));
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureReplay(&reader, &test_current, &result));
+    TEST_ASSERT_TRUE(result.complete);
+    TEST_ASSERT_FALSE(result.mismatch);
+    TEST_ASSERT_EQUAL_UINT64(samples, result.ticks);
+    TEST_ASSERT_EQUAL_UINT32(2, trips);
+    TEST_ASSERT_EQUAL_UINT32(trips, result.trips);
+    TEST_ASSERT_EQUAL_UINT32(trips + 1u, result.checkpoints);
+    TEST_ASSERT_TRUE(result.first_trip_tick > 2000);
+    TEST_ASSERT_EQUAL_UINT64(expected[1].timestamp, result.first_timestamp);
+
+    // k factor of the first init 1 % higher: the trip tick moves
+    float k_factor = 1.01f;
+    memcpy(&buffer[sizeof(ProtectionOverloadCaptureHeader) + 1u + sizeof(float)], &k_factor, sizeof(k_factor));
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureOpen(&reader, buffer, capture.used));
+    TEST_ASSERT_FALSE(ProtectionOverload_CaptureReplay(&reader, &test_current, &result));
+    TEST_ASSERT_TRUE(result.mismatch);
+    TEST_ASSERT_FALSE(result.complete);
+    TEST_ASSERT_EQUAL_UINT32(0, result.checkpoints);
+    TEST_ASSERT_TRUE(result.mismatch_sample > 2000 && result.mismatch_sample < samples);
+}
+
+// One hour at 10 ms through a small buffer flushed to a file: size, replay speed
+void test_capture_hour_to_file(void) {
+    static uint8_t chunk[256];
+    FILE *file = fopen(TEST_CAPTURE, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    clock_us = 0;
+    clock_calls = 0;
+    ProtectionOverload_CaptureStart(&capture, chunk, sizeof(chunk), Test_WriteChunk, file, Test_Clock);
+    ProtectionOverload_SM_Init(&params);
+    // Load steps every 10 s (ADC codes of 1 mA), an overload every 10 minutes
+    for (uint32_t tick = 0; tick < CAPTURE_HOUR_TICKS; tick++) {
+        float load = (float)(300 + (int)((tick / 1000u) * 37u % 500u)) * 0.001f;
+        test_current = (tick % 60000u >= 59000u) ? 1.6f : load;
+        ProtectionOverload_SM_Run();
+        // Reset once the overload has cleared
+        if (ProtectionOverload_SM_GetState() == ST_OVERLOAD_TRIGGERED && test_current < 1.0f) {
+            ProtectionOverload_SM_Reset();
+        }
+    }
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureStop(&capture));
+    fclose(file);
+    uint64_t hour_bytes = capture.bytes;
+
+    // Read back and replay
+    file = fopen(TEST_CAPTURE, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    uint8_t *data = malloc((size_t)hour_bytes);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_EQUAL_size_t((size_t)hour_bytes, fread(data, 1, (size_t)hour_bytes, file));
+    TEST_ASSERT_EQUAL_INT(EOF, fgetc(file));
+    fclose(file);
+
+    ProtectionOverloadCaptureReader reader;
+    ProtectionOverloadReplayResult result;
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureOpen(&reader, data, (size_t)hour_bytes));
+    clock_t start = clock();
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureReplay(&reader, &test_current, &result));
+    double replay_sec = (double)(clock() - start) / CLOCKS_PER_SEC;
+    free(data);
+    double recorded_sec = (double)(result.last_timestamp - reader.header.start) * 1e-6;
+    double speed = recorded_sec / ((replay_sec > 1e-6) ? replay_sec : 1e-6);
+    printf("One hour at 10 ms: %llu bytes (%.3f bytes per tick), %u trips, replay %.1f ms (%.0fx real time)\n",
+           (unsigned long long)hour_bytes, (double)hour_bytes / CAPTURE_HOUR_TICKS, (unsigned int)result.trips,
+           replay_sec * 1e3, speed);
+    TEST_ASSERT_EQUAL_UINT64(CAPTURE_HOUR_TICKS, result.ticks);
+    TEST_ASSERT_EQUAL_UINT32(6, result.trips);
+    TEST_ASSERT_TRUE(hour_bytes < CAPTURE_HOUR_TICKS);
+    TEST_ASSERT_TRUE(speed > CAPTURE_MIN_SPEED);
+}
+
+// Full buffer without flush: capture stops, the recorded part replays without a mismatch
+void test_capture_overflow(void) {
+    static uint8_t small[512];
+    ProtectionOverload_CaptureStart(&capture, small, sizeof(small), NULL, NULL, NULL);
+    ProtectionOverload_SM_Init(&params);
+    for (int i = 0; i < 1000; i++) {
+        test_current = 1.0f + 0.2f * Test_Noise();
+        ProtectionOverload_SM_Run();
+    }
+    TEST_ASSERT_FALSE(ProtectionOverload_CaptureStop(&capture));
+    TEST_ASSERT_TRUE(capture.overflow);
+    TEST_ASSERT_TRUE(capture.used <= sizeof(small));
+
+    ProtectionOverloadCaptureReader reader;
+    ProtectionOverloadReplayResult result;
+    TEST_ASSERT_TRUE(ProtectionOverload_CaptureOpen(&reader, small, capture.used));
+    TEST_ASSERT_FALSE(ProtectionOverload_CaptureReplay(&reader, &test_current, &result));
+    TEST_ASSERT_FALSE(reader.error);
+    TEST_ASSERT_FALSE(result.complete);
+    TEST_ASSERT_FALSE(result.mismatch);
+    TEST_ASSERT_TRUE(result.ticks > 100 && result.ticks < 1000);
+
+    // Buffer too small for the header: nothing recorded
+    ProtectionOverload_CaptureStart(&capture, small, 64, NULL, NULL, NULL);
+    TEST_ASSERT_FALSE(ProtectionOverload_CaptureStop(&capture));
+    TEST_ASSERT_EQUAL_size_t(0, capture.used);
+}
+
+// Cost of recording relative to SM_Run alone against test/perf_baseline.txt:
+// steady and noisy currents, with timestamps
+void test_capture_cost(void) {
+    ProtectionOverloadParams bench_params = params;
+    bench_params.k_factor = 1e9f;
+    ProtectionOverload_SM_Init(&bench_params);
+
+    UnityBench plain, steady, noisy;
+    TEST_BENCH_ROUNDS(r) {
+        test_current = 2.0f;
+        TEST_BENCH_BATCH(plain, "SM_Run heating, not recorded", CAPTURE_BENCH_RUNS, r) {
+            ProtectionOverload_SM_Run();
+        }
+        ProtectionOverload_CaptureStart(&capture, buffer, sizeof(buffer), Test_DiscardChunk, NULL, Test_SteadyClock);
+        TEST_BENCH_BATCH(steady, "SM_Run heating, recorded", CAPTURE_BENCH_RUNS, r) {
+            ProtectionOverload_SM_Run();
+        }
+        TEST_BENCH_BATCH(noisy, "SM_Run heating, noisy current recorded", CAPTURE_BENCH_RUNS, r) {
+            test_current = 2.0f + (float)(unity_bench_i & 1023) * 0.001f;
+            ProtectionOverload_SM_Run();
+        }
+        TEST_ASSERT_TRUE(ProtectionOverload_CaptureStop(&capture));
+    }
+    printf("SM_Run %.2f ns, recorded %.2f ns (steady), %.2f ns (noisy), %llu bytes flushed\n", plain.median_ns_per_call,
+           steady.median_ns_per_call, noisy.median_ns_per_call, (unsigned long long)discarded);
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_SM_GetState());
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(steady, plain);
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(noisy, plain);
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nRecord and replay\n");
+    RUN_TEST(test_capture_round_trip);
+    RUN_TEST(test_capture_replay_bit_exact);
+    RUN_TEST(test_capture_hour_to_file);
+    RUN_TEST(test_capture_overflow);
+    RUN_TEST(test_capture_cost);
+
+    return UNITY_END();
+}
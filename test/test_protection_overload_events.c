@@ -0,0 +1,251 @@
+// Transition event queue unit and stress tests
+
+#include "unity.h"
+#include "protection_overload.h"
+#include "protection_overload_events.h"
+#include <pthread.h>
+#include <stdatomic.h>
+
+#define EVENTS_PRODUCERS    4           // Producer threads (protection tasks)
+#define EVENTS_INSTANCES    512         // State machines per producer
+#define EVENTS_TICKS        300         // 3 s at 10 ms: every instance trips
+#define EVENTS_CAPACITY     4096        // Queue cells (two events per instance fit)
+#define EVENTS_SOURCES      (EVENTS_PRODUCERS * EVENTS_INSTANCES)
+
+// Not used: currents are passed to the instances
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static const ProtectionOverloadParams params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+static ProtectionOverloadEventCell cells[EVENTS_CAPACITY];
+static ProtectionOverloadEventQueue queue;
+
+// Producer clock: tick of the running producer thread
+static _Thread_local uint64_t producer_tick;
+
+static uint64_t Events_Clock(void) {
+    return producer_tick;
+}
+
+// Current of an instance: 1.2 to 2.7 x I_trip, from tick 10 (pickup after start)
+static float Events_Current(uint32_t source, uint32_t tick) {
+    return (tick < 10u) ? 0.5f : 1.2f + 0.1f * (float)(source % 16u);
+}
+
+// Trip tick of an instance without hooks (polled)
+static uint32_t Events_ReferenceTrip(uint32_t source) {
+    ProtectionOverloadSM sm;
+    ProtectionOverload_Init(&sm, &params, 0.01f);
+    for (uint32_t tick = 1; tick <= EVENTS_TICKS; tick++) {
+        ProtectionOverload_Run(&sm, Events_Current(source, tick));
+        if (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED) {
+            return tick;
+        }
+    }
+    return 0;
+}
+
+/* ------------------------------------------------
+        Producers and consumer
+   ------------------------------------------------ */
+
+typedef struct {
+    pthread_t thread;
+    uint32_t first;                     // First source id
+    ProtectionOverloadSM sm[EVENTS_INSTANCES];
+    ProtectionOverloadEventSource sources[EVENTS_INSTANCES];
+} EventsProducer;
+
+static void *Events_Producer(void *arg) {
+    EventsProducer *producer = arg;
+    for (uint32_t i = 0; i < EVENTS_INSTANCES; i++) {
+        ProtectionOverload_Init(&producer->sm[i], &params, 0.01f);
+        ProtectionOverload_EventSourceInit(&producer->sources[i], &queue, producer->first + i, Events_Clock);
+        ProtectionOverload_SetHooks(&producer->sm[i], &producer->sources[i].hooks);
+    }
+    for (producer_tick = 1; producer_tick <= EVENTS_TICKS; producer_tick++) {
+        for (uint32_t i = 0; i < EVENTS_INSTANCES; i++) {
+            ProtectionOverload_Run(&producer->sm[i], Events_Current(producer->first + i, (uint32_t)producer_tick));
+        }
+    }
+    return NULL;
+}
+
+// Per-source event log of the consumer
+typedef struct {
+    uint32_t pickups;
+    uint32_t trips;
+    uint64_t pickup_tick;
+    uint64_t trip_tick;
+    uint32_t errors;                    // Out of order or unexpected events
+} EventsLog;
+
+static EventsLog logs[EVENTS_SOURCES];
+static atomic_bool producers_done;
+
+static void Events_Consume(const ProtectionOverloadEventRecord *record) {
+    if (record->source >= EVENTS_SOURCES) {
+        logs[0].errors++;
+        return;
+    }
+    EventsLog *log = &logs[record->source];
+    switch (record->event) {
+        case EVENT_PICKUP:
+            log->pickups++;
+            log->pickup_tick = record->timestamp;
+            log->errors += (record->overload_factor <= PROTECTION_OVERLOAD_PICKUP);
+            break;
+        case EVENT_TRIP:
+            log->trips++;
+            log->trip_tick = record->timestamp;
+            log->errors += (log->pickups != 1u) || (record->energy < 1.0f);
+            break;
+        default:
+            log->errors++;
+            break;
+    }
+}
+
+static void *Events_Consumer(void *arg) {
+    (void)arg;
+    ProtectionOverloadEventRecord record;
+    for (;;) {
+        bool done = atomic_load_explicit(&producers_done, memory_order_acquire);
+        while (ProtectionOverload_EventPop(&queue, &record)) {
+            Events_Consume(&record);
+        }
+        if (done) {
+            return NULL;
+        }
+    }
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(ProtectionOverload_EventQueueInit(&queue, cells, EVENTS_CAPACITY));
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+void test_events_queue_init_rejects_bad_capacity(void) {
+    TEST_ASSERT_FALSE(ProtectionOverload_EventQueueInit(&queue, cells, 0));
+    TEST_ASSERT_FALSE(ProtectionOverload_EventQueueInit(&queue, cells, 1));
+    TEST_ASSERT_FALSE(ProtectionOverload_EventQueueInit(&queue, cells, 1000));
+    TEST_ASSERT_FALSE(ProtectionOverload_EventQueueInit(&queue, NULL, 1024));
+}
+
+// Records come out in push order, empty queue pops nothing
+void test_events_queue_fifo(void) {
+    ProtectionOverloadEventRecord record;
+    TEST_ASSERT_FALSE(ProtectionOverload_EventPop(&queue, &record));
+    // Three laps of the ring
+    for (uint32_t i = 0; i < 3u * EVENTS_CAPACITY; i++) {
+        record = (ProtectionOverloadEventRecord){.timestamp = i, .source = i, .event = EVENT_TRIP};
+        TEST_ASSERT_TRUE(ProtectionOverload_EventPush(&queue, &record));
+        TEST_ASSERT_TRUE(ProtectionOverload_EventPop(&queue, &record));
+        TEST_ASSERT_EQUAL_UINT32(i, record.source);
+    }
+    TEST_ASSERT_FALSE(ProtectionOverload_EventPop(&queue, &record));
+    TEST_ASSERT_EQUAL_UINT32(0, ProtectionOverload_EventDropped(&queue));
+}
+
+// Full queue: producers never wait, the event is dropped and counted
+void test_events_queue_full_drops(void) {
+    ProtectionOverloadEventCell small_cells[8];
+    ProtectionOverloadEventQueue small;
+    TEST_ASSERT_TRUE(ProtectionOverload_EventQueueInit(&small, small_cells, 8));
+    ProtectionOverloadEventRecord record = {.event = EVENT_PICKUP};
+    for (uint32_t i = 0; i < 10; i++) {
+        record.source = i;
+        TEST_ASSERT_EQUAL(i < 8, ProtectionOverload_EventPush(&small, &record));
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, ProtectionOverload_EventDropped(&small));
+    TEST_ASSERT_TRUE(ProtectionOverload_EventPop(&small, &record));
+    TEST_ASSERT_EQUAL_UINT32(0, record.source);
+    TEST_ASSERT_TRUE(ProtectionOverload_EventPush(&small, &record));
+}
+
+// Producer threads run instances with event sources, a consumer supervises them
+// all concurrently: each instance reports one pickup and one trip, on the
+// tick a poll of GetState would see it
+void test_events_producers_consumer_trip_once(void) {
+    static EventsProducer producers[EVENTS_PRODUCERS];
+    pthread_t consumer;
+    for (uint32_t s = 0; s < EVENTS_SOURCES; s++) {
+        logs[s] = (EventsLog){0};
+    }
+    atomic_store(&producers_done, false);
+    TEST_ASSERT_EQUAL_INT(0, pthread_create(&consumer, NULL, Events_Consumer, NULL));
+    for (uint32_t p = 0; p < EVENTS_PRODUCERS; p++) {
+        producers[p].first = p * EVENTS_INSTANCES;
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&producers[p].thread, NULL, Events_Producer, &producers[p]));
+    }
+    for (uint32_t p = 0; p < EVENTS_PRODUCERS; p++) {
+        pthread_join(producers[p].thread, NULL);
+    }
+    atomic_store_explicit(&producers_done, true, memory_order_release);
+    pthread_join(consumer, NULL);
+
+    TEST_ASSERT_EQUAL_UINT32(0, ProtectionOverload_EventDropped(&queue));
+    for (uint32_t s = 0; s < EVENTS_SOURCES; s++) {
+        TEST_ASSERT_EQUAL_UINT32(0, logs[s].errors);
+        TEST_ASSERT_EQUAL_UINT32(1, logs[s].pickups);
+        TEST_ASSERT_EQUAL_UINT32(1, logs[s].trips);
+        TEST_ASSERT_EQUAL_UINT64(10, logs[s].pickup_tick);
+        TEST_ASSERT_EQUAL_UINT64(Events_ReferenceTrip(s), logs[s].trip_tick);
+    }
+}
+
+// Reset of a tripped instance with a source reports EVENT_RESET
+void test_events_source_reset(void) {
+    ProtectionOverloadSM sm;
+    ProtectionOverloadEventSource source;
+    ProtectionOverload_Init(&sm, &params, 0.01f);
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverload_Run(&sm, 3.0f);
+    }
+    ProtectionOverload_EventSourceInit(&source, &queue, 7, NULL);
+    ProtectionOverload_SetHooks(&sm, &source.hooks);
+    TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+
+    ProtectionOverloadEventRecord record;
+    TEST_ASSERT_TRUE(ProtectionOverload_EventPop(&queue, &record));
+    TEST_ASSERT_EQUAL_UINT8(EVENT_RESET, record.event);
+    TEST_ASSERT_EQUAL_UINT32(7, record.source);
+    TEST_ASSERT_EQUAL_UINT64(0, record.timestamp);
+    TEST_ASSERT_FALSE(ProtectionOverload_EventPop(&queue, &record));
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nTransition event queue\n");
+    RUN_TEST(test_events_queue_init_rejects_bad_capacity);
+    RUN_TEST(test_events_queue_fifo);
+    RUN_TEST(test_events_queue_full_drops);
+    RUN_TEST(test_events_producers_consumer_trip_once);
+    RUN_TEST(test_events_source_reset);
+
+    return UNITY_END();
+}
@@ -0,0 +1,95 @@
+// Trip rate lookup table unit tests
+
+#include "unity.h"
+#include "protection_overload.h"
+#include "protection_overload_curve.h"
+#include "protection_overload_lut.h"
+
+#define LUT_SWEEP_POINTS    100000      // Overload factors checked per curve
+
+// Documented worst-case relative errors (protection_overload_lut.h)
+#define LUT_MAX_ERROR_I2T   0.0008f
+#define LUT_MAX_ERROR_IT    1e-5f
+#define LUT_MAX_ERROR_SI    0.0007f
+
+// Not used: the table is tested directly
+float Sensor_Read() {
+    return 0.0f;
+}
+
+/* ------------------------------------------------ 
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) { 
+}
+
+void tearDown(void) { 
+}
+
+/* ------------------------------------------------ 
+        Test Functions
+   ------------------------------------------------ */
+
+// Max relative error of the table over [pickup, max factor)
+float lut_max_relative_error(ProtectionOverloadCurve curve) {
+    ProtectionOverload_LutInit(curve);
+
+    float max_error = 0.0f;
+    for (int i = 0; i < LUT_SWEEP_POINTS; i++) {
+        float f = PROTECTION_OVERLOAD_PICKUP * 1.0000001f +
+                  (PROTECTION_OVERLOAD_LUT_MAX_FACTOR - PROTECTION_OVERLOAD_PICKUP) * i / LUT_SWEEP_POINTS;
+        float exact = ProtectionOverload_CurveTerm(curve, f);
+        float error = (ProtectionOverload_LutCurveTerm(curve, f) - exact) / exact;
+        if (error < 0.0f) error = -error;
+        if (error > max_error) max_error = error;
+    }
+    printf("Curve %d: max relative error %.6f %%\n", (int)curve, 100.0f * max_error);
+    return max_error;
+}
+
+void test_lut_size(void) {
+    TEST_ASSERT_LESS_OR_EQUAL_UINT(PROTECTION_OVERLOAD_LUT_SIZE, ProtectionOverload_LutNodes());
+    TEST_ASSERT_LESS_OR_EQUAL_UINT(4096, PROTECTION_OVERLOAD_LUT_SIZE * sizeof(ProtectionOverloadLutNode));
+}
+
+void test_lut_error_i2t(void) {
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(LUT_MAX_ERROR_I2T, lut_max_relative_error(CURVE_I2T));
+}
+
+void test_lut_error_it(void) {
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(LUT_MAX_ERROR_IT, lut_max_relative_error(CURVE_IT));
+}
+
+void test_lut_error_standard_inverse(void) {
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(LUT_MAX_ERROR_SI, lut_max_relative_error(CURVE_STANDARD_INVERSE));
+}
+
+// Nodes are exact, out of range factors use the exact curve
+void test_lut_exact_outside_range(void) {
+    ProtectionOverload_LutInit(CURVE_I2T);
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_CurveTerm(CURVE_I2T, PROTECTION_OVERLOAD_PICKUP),
+                            ProtectionOverload_LutCurveTerm(CURVE_I2T, PROTECTION_OVERLOAD_PICKUP));
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_CurveTerm(CURVE_I2T, 50.0f),
+                            ProtectionOverload_LutCurveTerm(CURVE_I2T, 50.0f));
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_CurveTerm(CURVE_I2T, 1.0f),
+                            ProtectionOverload_LutCurveTerm(CURVE_I2T, 1.0f));
+}
+
+/* ------------------------------------------------ 
+        Main Function
+   ------------------------------------------------ */  
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nTrip rate lookup table\n");
+    RUN_TEST(test_lut_size);
+    RUN_TEST(test_lut_error_i2t);
+    RUN_TEST(test_lut_error_it);
+    RUN_TEST(test_lut_error_standard_inverse);
+    RUN_TEST(test_lut_exact_outside_range);
+
+    return UNITY_END();    
+}
@@ -0,0 +1,129 @@
+// libm-free math unit tests
+//
+// The engine approximations (built with PROTECTION_OVERLOAD_NO_LIBM) are
+// checked against double precision libm over the full operating range.
+
+#include "unity.h"
+#include <math.h>
+#include "protection_overload.h"
+#include "protection_overload_curve.h"
+
+#define MATH_SWEEP_POINTS   1000000     // Points per sweep
+
+// Documented error bounds (protection_overload_math.h)
+#define MATH_MAX_ERROR_LOG2     2e-7f
+#define MATH_MAX_ERROR_EXP2     2e-7f
+#define MATH_MAX_ERROR_EXPM1    5e-7f
+#define MATH_MAX_ERROR_POW      2e-6f
+#define MATH_MAX_ERROR_CURVE    5e-7f    // Curve term, pickup to 100 x I_trip
+
+// Not used: the approximations are tested directly
+float Sensor_Read() {
+    return 0.0f;
+}
+
+/* ------------------------------------------------ 
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) { 
+}
+
+void tearDown(void) { 
+}
+
+/* ------------------------------------------------ 
+        Helpers
+   ------------------------------------------------ */
+
+// Log-spaced sweep point i of [lo, hi]
+static float sweep_log(double lo, double hi, int i) {
+    return (float)exp(log(lo) + (log(hi) - log(lo)) * i / MATH_SWEEP_POINTS);
+}
+
+// Linear sweep point i of [lo, hi]
+static float sweep_lin(double lo, double hi, int i) {
+    return (float)(lo + (hi - lo) * i / MATH_SWEEP_POINTS);
+}
+
+/* ------------------------------------------------ 
+        Test Functions
+   ------------------------------------------------ */
+
+void test_math_log2(void) {
+    double max_error = 0.0;
+    for (int i = 0; i <= MATH_SWEEP_POINTS; i++) {
+        float x = sweep_log(1e-6, 1e6, i);
+        double exact = log2((double)x);
+        double error = fabs(ProtectionOverload_Log2f(x) - exact) / fmax(1.0, fabs(exact));
+        if (error > max_error) max_error = error;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MATH_MAX_ERROR_LOG2, (float)max_error);
+}
+
+void test_math_exp2(void) {
+    double max_error = 0.0;
+    for (int i = 0; i <= MATH_SWEEP_POINTS; i++) {
+        float x = sweep_lin(-20.0, 20.0, i);
+        double exact = exp2((double)x);
+        double error = fabs(ProtectionOverload_Exp2f(x) - exact) / exact;
+        if (error > max_error) max_error = error;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MATH_MAX_ERROR_EXP2, (float)max_error);
+}
+
+void test_math_expm1(void) {
+    double max_error = 0.0;
+    for (int i = 0; i <= MATH_SWEEP_POINTS; i++) {
+        float x = sweep_lin(-2.0, 2.0, i);
+        if (x == 0.0f) continue;
+        double exact = expm1((double)x);
+        double error = fabs(ProtectionOverload_Expm1f(x) - exact) / fabs(exact);
+        if (error > max_error) max_error = error;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MATH_MAX_ERROR_EXPM1, (float)max_error);
+}
+
+void test_math_pow(void) {
+    const float exponents[] = {0.02f, 0.5f, 1.0f, 2.0f, 2.5f};
+    double max_error = 0.0;
+    for (unsigned int e = 0; e < sizeof(exponents) / sizeof(exponents[0]); e++) {
+        for (int i = 0; i <= MATH_SWEEP_POINTS; i += 10) {
+            float x = sweep_log(1e-3, 1e3, i);
+            double exact = pow((double)x, (double)exponents[e]);
+            double error = fabs(ProtectionOverload_Powf(x, exponents[e]) - exact) / exact;
+            if (error > max_error) max_error = error;
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MATH_MAX_ERROR_POW, (float)max_error);
+}
+
+// Standard inverse curve term over the full operating range
+void test_math_curve_standard_inverse(void) {
+    double max_error = 0.0;
+    for (int i = 0; i <= MATH_SWEEP_POINTS; i++) {
+        float f = sweep_lin(PROTECTION_OVERLOAD_PICKUP, 100.0, i);
+        double exact = pow((double)f, 0.02) - 1.0;
+        double error = fabs(ProtectionOverload_CurveTerm(CURVE_STANDARD_INVERSE, f) - exact) / exact;
+        if (error > max_error) max_error = error;
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MATH_MAX_ERROR_CURVE, (float)max_error);
+}
+
+/* ------------------------------------------------ 
+        Main Function
+   ------------------------------------------------ */  
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nlibm-free math approximations\n");
+    RUN_TEST(test_math_log2);
+    RUN_TEST(test_math_exp2);
+    RUN_TEST(test_math_expm1);
+    RUN_TEST(test_math_pow);
+    RUN_TEST(test_math_curve_standard_inverse);
+
+    return UNITY_END();    
+}
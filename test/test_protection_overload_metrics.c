@@ -0,0 +1,300 @@
+// Live metrics unit tests: shared memory segment read by a second mapping and by a monitor process
+
+#define _POSIX_C_SOURCE 200809L         // fork, waitpid
+
+#include "unity.h"
+#include "unity_bench.h"
+#include "protection_overload.h"
+#include "protection_overload_metrics.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define METRICS_NAME        "/protection_overload_test"
+#define METRICS_SLOTS       4           // Instance slots in the test segment
+#define METRICS_CALL_RATE   0.01f       // Call rate [s]
+#define METRICS_FAKE_NS     100u        // Fake clock step: every timed Run takes 100 ns
+#define METRICS_MONITOR_TICKS 2000000u  // Ticks run while the monitor process polls
+#define METRICS_BENCH_RUNS  1000000     // Calls per timed batch
+
+// Not used: currents are passed to the engine
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static const ProtectionOverloadParams params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+static ProtectionOverloadMetrics metrics;
+static ProtectionOverloadSM sm;
+static ProtectionOverloadMetricsWriter writer;
+
+// Deterministic Run time
+static uint64_t fake_clock_ns;
+static uint64_t Test_FakeClock(void) {
+    fake_clock_ns += METRICS_FAKE_NS;
+    return fake_clock_ns;
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    TEST_ASSERT_TRUE(ProtectionOverload_MetricsCreate(&metrics, METRICS_NAME, METRICS_SLOTS));
+    ProtectionOverload_Init(&sm, &params, METRICS_CALL_RATE);
+}
+
+void tearDown(void) {
+    ProtectionOverload_MetricsClose(&metrics);
+    ProtectionOverload_MetricsUnlink(METRICS_NAME);
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+// Versioned layout: header checked by monitors, slots on their own cache lines
+void test_metrics_layout(void) {
+    ProtectionOverloadMetricsHeader *header = metrics.header;
+    TEST_ASSERT_EQUAL_HEX32(PROTECTION_OVERLOAD_METRICS_MAGIC, header->magic);
+    TEST_ASSERT_EQUAL_UINT16(PROTECTION_OVERLOAD_METRICS_VERSION, header->version);
+    TEST_ASSERT_EQUAL_UINT32(METRICS_SLOTS, header->slots);
+    TEST_ASSERT_EQUAL_UINT32(ProtectionOverload_MetricsSize(METRICS_SLOTS), metrics.size);
+    TEST_ASSERT_EQUAL_UINT32(64, (uintptr_t)ProtectionOverload_MetricsSlot(&metrics, 0) - (uintptr_t)header);
+    TEST_ASSERT_EQUAL_UINT32(192, (uintptr_t)ProtectionOverload_MetricsSlot(&metrics, 1) - (uintptr_t)ProtectionOverload_MetricsSlot(&metrics, 0));
+    TEST_ASSERT_NULL(ProtectionOverload_MetricsSlot(&metrics, METRICS_SLOTS));
+
+    // Read-only mapping of the same segment
+    ProtectionOverloadMetrics monitor;
+    TEST_ASSERT_TRUE(ProtectionOverload_MetricsOpen(&monitor, METRICS_NAME));
+    TEST_ASSERT_EQUAL_UINT32(METRICS_SLOTS, monitor.header->slots);
+    ProtectionOverload_MetricsClose(&monitor);
+
+    // Another layout version, or no segment: not opened
+    header->version++;
+    TEST_ASSERT_FALSE(ProtectionOverload_MetricsOpen(&monitor, METRICS_NAME));
+    TEST_ASSERT_NULL(monitor.header);
+    header->version--;
+    TEST_ASSERT_FALSE(ProtectionOverload_MetricsOpen(&monitor, "/protection_overload_missing"));
+
+    // Caller memory: alignment and size checked
+    static _Alignas(64) uint8_t memory[64 + 2 * 192];
+    ProtectionOverloadMetrics local;
+    TEST_ASSERT_TRUE(ProtectionOverload_MetricsInit(&local, memory, sizeof(memory), 2));
+    TEST_ASSERT_NOT_NULL(ProtectionOverload_MetricsSlot(&local, 1));
+    TEST_ASSERT_FALSE(ProtectionOverload_MetricsInit(&local, memory, sizeof(memory), 3));
+    TEST_ASSERT_FALSE(ProtectionOverload_MetricsInit(&local, memory + 8, sizeof(memory) - 8, 1));
+}
+
+// Counters seen through a second mapping: ticks, time above pickup, peak energy, trips, state, Run time
+void test_metrics_counters(void) {
+    ProtectionOverloadMetricsSlot *slot = ProtectionOverload_MetricsSlot(&metrics, 2);
+    ProtectionOverload_MetricsAttach(&writer, slot, &sm, 7, Test_FakeClock);
+
+    uint64_t ticks = 0;
+    uint64_t pickup_ticks = 0;
+    float peak_energy = 0.0f;
+    for (int trip = 0; trip < 3; trip++) {
+        for (int i = 0; i < 500; i++, ticks++) {
+            ProtectionOverload_MetricsRun(&writer, &sm, 0.5f);
+        }
+        while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED) {
+            ProtectionOverload_MetricsRun(&writer, &sm, 1.5f + 0.25f * (float)trip);
+            ticks++;
+            pickup_ticks += (ProtectionOverload_GetState(&sm) == ST_PICKUP);
+            peak_energy = (ProtectionOverload_GetEnergy(&sm) > peak_energy) ? ProtectionOverload_GetEnergy(&sm) : peak_energy;
+        }
+        TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+    }
+    ProtectionOverload_MetricsRun(&writer, &sm, 0.0f);
+    ticks++;
+
+    ProtectionOverloadMetrics monitor;
+    TEST_ASSERT_TRUE(ProtectionOverload_MetricsOpen(&monitor, METRICS_NAME));
+    ProtectionOverloadMetricsValues values;
+    ProtectionOverload_MetricsRead(ProtectionOverload_MetricsSlot(&monitor, 2), &values);
+    ProtectionOverload_MetricsClose(&monitor);
+
+    TEST_ASSERT_TRUE(values.attached);
+    TEST_ASSERT_EQUAL_UINT32(7, values.source);
+    TEST_ASSERT_EQUAL_UINT64(ticks, values.ticks);
+    TEST_ASSERT_EQUAL_UINT64(pickup_ticks * 10000000u, (uint64_t)(values.pickup_sec * 1e9 + 0.5));
+    TEST_ASSERT_EQUAL_UINT32(3, values.trips);
+    TEST_ASSERT_EQUAL(ST_IDLE, values.state);
+    TEST_ASSERT_EQUAL_FLOAT(ProtectionOverload_GetEnergy(&sm), values.energy);
+    TEST_ASSERT_EQUAL_FLOAT(peak_energy, values.peak_energy);
+    TEST_ASSERT_TRUE(values.peak_energy >= 1.0f);
+
+    // One Run in PROTECTION_OVERLOAD_METRICS_TIMING timed, all in the [64, 128) ns bin
+    TEST_ASSERT_EQUAL_UINT32(ticks / PROTECTION_OVERLOAD_METRICS_TIMING, values.run_ns[6]);
+    TEST_ASSERT_EQUAL_UINT64(128, ProtectionOverload_MetricsPercentile(&values, 0.5));
+    TEST_ASSERT_EQUAL_UINT64(128, ProtectionOverload_MetricsPercentile(&values, 0.999));
+
+    // Percentiles across bins
+    memset(values.run_ns, 0, sizeof(values.run_ns));
+    values.run_ns[3] = 90;
+    values.run_ns[10] = 9;
+    values.run_ns[20] = 1;
+    TEST_ASSERT_EQUAL_UINT64(16, ProtectionOverload_MetricsPercentile(&values, 0.5));
+    TEST_ASSERT_EQUAL_UINT64(16, ProtectionOverload_MetricsPercentile(&values, 0.9));
+    TEST_ASSERT_EQUAL_UINT64(2048, ProtectionOverload_MetricsPercentile(&values, 0.99));
+    TEST_ASSERT_EQUAL_UINT64(2097152, ProtectionOverload_MetricsPercentile(&values, 0.999));
+
+    // Detached slot reported as such, reattach restarts the counters
+    ProtectionOverload_MetricsDetach(&writer);
+    ProtectionOverload_MetricsRead(slot, &values);
+    TEST_ASSERT_FALSE(values.attached);
+    ProtectionOverload_MetricsAttach(&writer, slot, &sm, 7, NULL);
+    ProtectionOverload_MetricsRead(slot, &values);
+    TEST_ASSERT_EQUAL_UINT64(0, values.ticks);
+    TEST_ASSERT_EQUAL_UINT32(0, values.trips);
+    TEST_ASSERT_EQUAL_UINT64(0, ProtectionOverload_MetricsPercentile(&values, 0.5));
+}
+
+// Reset re-arms from the thermal image: the next tick trips again with no idle tick in between
+void test_metrics_trips_after_reset(void) {
+    ProtectionOverloadMetricsSlot *slot = ProtectionOverload_MetricsSlot(&metrics, 1);
+    ProtectionOverload_MetricsAttach(&writer, slot, &sm, 1, NULL);
+    ProtectionOverloadMetricsValues values;
+    for (uint32_t trip = 1; trip <= 3; trip++) {
+        while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED) {
+            ProtectionOverload_MetricsRun(&writer, &sm, 3.0f);
+        }
+        ProtectionOverload_MetricsRead(slot, &values);
+        TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, values.state);
+        TEST_ASSERT_EQUAL_UINT32(trip, values.trips);
+        TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+    }
+    // Re-armed above 1.0: one tick trips again
+    ProtectionOverload_MetricsRun(&writer, &sm, 3.0f);
+    ProtectionOverload_MetricsRead(slot, &values);
+    TEST_ASSERT_EQUAL_UINT32(4, ProtectionOverload_GetTrips(&sm));
+    TEST_ASSERT_EQUAL_UINT32(4, values.trips);
+
+    // New Init: the instance count restarts, the slot keeps counting
+    ProtectionOverload_Init(&sm, &params, METRICS_CALL_RATE);
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverload_MetricsRun(&writer, &sm, 3.0f);
+    }
+    ProtectionOverload_MetricsRead(slot, &values);
+    TEST_ASSERT_EQUAL_UINT32(1, ProtectionOverload_GetTrips(&sm));
+    TEST_ASSERT_EQUAL_UINT32(5, values.trips);
+}
+
+// A new Init is told by its generation, not by the trip count: a trip on the
+// first tick after it counts even when the old instance had as many trips
+void test_metrics_trip_on_first_tick_after_init(void) {
+    ProtectionOverloadMetricsSlot *slot = ProtectionOverload_MetricsSlot(&metrics, 2);
+    ProtectionOverloadMetricsValues values;
+    ProtectionOverload_MetricsAttach(&writer, slot, &sm, 2, NULL);
+    for (uint32_t trip = 1; trip <= 2; trip++) {
+        if (trip > 1) {
+            ProtectionOverload_Init(&sm, &params, METRICS_CALL_RATE);
+        }
+        // I^2 - 1 above 1 / call rate: trips in one tick
+        ProtectionOverload_MetricsRun(&writer, &sm, 20.0f);
+        TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, ProtectionOverload_GetState(&sm));
+        TEST_ASSERT_EQUAL_UINT32(1, ProtectionOverload_GetTrips(&sm));
+        ProtectionOverload_MetricsRead(slot, &values);
+        TEST_ASSERT_EQUAL_UINT32(trip, values.trips);
+    }
+}
+
+// Monitor process polling the segment while the protection runs: counters never go back
+void test_metrics_monitor_process(void) {
+    ProtectionOverload_MetricsAttach(&writer, ProtectionOverload_MetricsSlot(&metrics, 0), &sm, 0,
+                                     ProtectionOverload_MetricsClockNs);
+    fflush(stdout);
+    pid_t monitor_pid = fork();
+    TEST_ASSERT_TRUE(monitor_pid >= 0);
+    if (monitor_pid == 0) {
+        ProtectionOverloadMetrics monitor;
+        if (!ProtectionOverload_MetricsOpen(&monitor, METRICS_NAME)) {
+            _exit(2);
+        }
+        ProtectionOverloadMetricsValues last = {0};
+        ProtectionOverloadMetricsValues values;
+        uint64_t deadline = ProtectionOverload_MetricsClockNs() + 30000000000u;
+        do {
+            ProtectionOverload_MetricsRead(ProtectionOverload_MetricsSlot(&monitor, 0), &values);
+            if (values.ticks < last.ticks || values.trips < last.trips || values.pickup_sec < last.pickup_sec ||
+                values.peak_energy < last.peak_energy) {
+                _exit(1);
+            }
+            last = values;
+        } while (values.ticks < METRICS_MONITOR_TICKS && ProtectionOverload_MetricsClockNs() < deadline);
+        _exit((values.ticks == METRICS_MONITOR_TICKS && values.trips > 0) ? 0 : 3);
+    }
+
+    // Trip and reset repeatedly
+    for (uint32_t tick = 0; tick < METRICS_MONITOR_TICKS; tick++) {
+        ProtectionOverload_MetricsRun(&writer, &sm, ((tick >> 12) & 1u) ? 2.0f : 0.5f);
+        if (ProtectionOverload_GetState(&sm) == ST_OVERLOAD_TRIGGERED) {
+            ProtectionOverload_Reset(&sm);
+        }
+    }
+    int status = 0;
+    TEST_ASSERT_EQUAL_INT(monitor_pid, waitpid(monitor_pid, &status, 0));
+    TEST_ASSERT_TRUE(WIFEXITED(status));
+    TEST_ASSERT_EQUAL_INT(0, WEXITSTATUS(status));
+}
+
+// Cost of the counters relative to Run alone against test/perf_baseline.txt;
+// with Run timing it depends on the host clock source and is only printed
+void test_metrics_cost(void) {
+    ProtectionOverloadParams bench_params = params;
+    bench_params.k_factor = 1e9f;
+    ProtectionOverload_Init(&sm, &bench_params, METRICS_CALL_RATE);
+    ProtectionOverloadMetricsSlot *slot = ProtectionOverload_MetricsSlot(&metrics, 1);
+
+    UnityBench plain, counters, timed;
+    ProtectionOverload_MetricsAttach(&writer, slot, &sm, 1, NULL);
+    TEST_BENCH_ROUNDS(r) {
+        TEST_BENCH_BATCH(plain, "Run heating, no metrics", METRICS_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 2.0f);
+        }
+        TEST_BENCH_BATCH(counters, "Run heating, metrics", METRICS_BENCH_RUNS, r) {
+            ProtectionOverload_MetricsRun(&writer, &sm, 2.0f);
+        }
+    }
+    ProtectionOverload_MetricsAttach(&writer, slot, &sm, 1, ProtectionOverload_MetricsClockNs);
+    TEST_BENCH(timed, "Run heating, metrics and timing", METRICS_BENCH_RUNS) {
+        ProtectionOverload_MetricsRun(&writer, &sm, 2.0f);
+    }
+    ProtectionOverloadMetricsValues values;
+    ProtectionOverload_MetricsRead(slot, &values);
+    printf("Run %.2f ns, with metrics %.2f ns, with metrics and timing %.2f ns (p50 <= %llu ns, p99 <= %llu ns)\n",
+           plain.median_ns_per_call, counters.median_ns_per_call, timed.median_ns_per_call,
+           (unsigned long long)ProtectionOverload_MetricsPercentile(&values, 0.5),
+           (unsigned long long)ProtectionOverload_MetricsPercentile(&values, 0.99));
+    TEST_ASSERT_EQUAL(ST_PICKUP, values.state);
+    TEST_ASSERT_TRUE(values.ticks > 0);
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(counters, plain);
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nLive metrics\n");
+    RUN_TEST(test_metrics_layout);
+    RUN_TEST(test_metrics_counters);
+    RUN_TEST(test_metrics_trips_after_reset);
+    RUN_TEST(test_metrics_trip_on_first_tick_after_init);
+    RUN_TEST(test_metrics_monitor_process);
+    RUN_TEST(test_metrics_cost);
+
+    return UNITY_END();
+}
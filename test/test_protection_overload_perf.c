@@ -0,0 +1,107 @@
+// Performance tests
+//
+// Median cost of ProtectionOverload_SM_Run per scenario, checked against an
+// absolute limit and against test/perf_baseline.txt (see unity_bench.h).
+
+#include "unity.h"
+#include "unity_bench.h"
+#include "protection_overload.h"
+
+#define PERF_ITERATIONS     1000000 // Calls per timed batch
+#define PERF_MAX_NS         1000.0  // Absolute limit per call [ns]
+
+// Test current value (mocked sensor value)
+float test_current = 0.0f;
+
+// Protection parameters (same as functional tests)
+ProtectionOverloadParams protectionParams = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f
+};
+
+/* ------------------------------------------------ 
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) { 
+    ProtectionOverload_SM_Init(&protectionParams);
+}
+
+void tearDown(void) { 
+}
+
+/* ------------------------------------------------ 
+        Mocked Sensor Read Function
+   ------------------------------------------------ */
+
+float Sensor_Read() {
+    return test_current;
+}
+
+/* ------------------------------------------------ 
+        Test Functions
+   ------------------------------------------------ */
+
+// Below pickup with no energy: the common case of every protection
+void test_perf_run_idle(void) {
+    UnityBench bench;
+    test_current = 0.8f;
+
+    TEST_BENCH(bench, "SM_Run idle", PERF_ITERATIONS) {
+        ProtectionOverload_SM_Run();
+    }
+
+    TEST_ASSERT_MAX_NS_PER_CALL(PERF_MAX_NS, bench);
+    TEST_ASSERT_BENCH_BASELINE(bench);
+}
+
+// Above pickup: inverse-time curve evaluation (k large enough not to trip)
+void test_perf_run_overload(void) {
+    UnityBench bench;
+    ProtectionOverloadParams params = protectionParams;
+    params.k_factor = 1e9f;
+    ProtectionOverload_SM_Init(&params);
+    test_current = 2.0f;
+
+    TEST_BENCH(bench, "SM_Run overload", PERF_ITERATIONS) {
+        ProtectionOverload_SM_Run();
+    }
+
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_SM_GetState());
+    TEST_ASSERT_MAX_NS_PER_CALL(PERF_MAX_NS, bench);
+    TEST_ASSERT_BENCH_BASELINE(bench);
+}
+
+// Tripped protection
+void test_perf_run_tripped(void) {
+    UnityBench bench;
+    test_current = 10.0f;
+    while (ProtectionOverload_SM_GetState() != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverload_SM_Run();
+    }
+
+    TEST_BENCH(bench, "SM_Run tripped", PERF_ITERATIONS) {
+        ProtectionOverload_SM_Run();
+    }
+
+    TEST_ASSERT_MAX_NS_PER_CALL(PERF_MAX_NS, bench);
+    TEST_ASSERT_BENCH_BASELINE(bench);
+}
+
+/* ------------------------------------------------ 
+        Main Function
+   ------------------------------------------------ */  
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nProtection Overload performance\n");
+    RUN_TEST(test_perf_run_idle);
+    RUN_TEST(test_perf_run_overload);
+    RUN_TEST(test_perf_run_tripped);
+
+    return UNITY_END();    
+}
@@ -0,0 +1,256 @@
+// Disturbance recorder and trip log unit tests
+
+#include "unity.h"
+#include "unity_bench.h"
+#include "protection_overload.h"
+#include "protection_overload_recorder.h"
+#include <string.h>
+
+#define RECORDER_CURRENT_LSB    0.001f      // Current quantization [A]
+#define RECORDER_TICKS          20000u      // Round trip: ring wrapped several times
+#define RECORDER_HOUR_TICKS     360000u     // One hour at 10 ms
+#define RECORDER_HOUR_BLOCKS    128u        // 32 KB
+#define RECORDER_BENCH_RUNS     1000000     // Calls per timed batch
+
+// Not used: currents are passed to the engine
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static const ProtectionOverloadParams params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+static ProtectionOverloadSM sm;
+static ProtectionOverloadRecorder recorder;
+static ProtectionOverloadRecorderBlock blocks[RECORDER_HOUR_BLOCKS];
+static ProtectionOverloadTripRecord trip_records[4];
+static ProtectionOverloadTripLog trip_log;
+
+// Reference of every tick
+static float reference_current[RECORDER_HOUR_TICKS];
+static float reference_energy[RECORDER_HOUR_TICKS];
+static uint8_t reference_state[RECORDER_HOUR_TICKS];
+static ProtectionOverloadRecorderSample samples[RECORDER_HOUR_TICKS];
+
+// Hashed level, new level every period ticks
+static float Test_Level(uint32_t tick, uint32_t period) {
+    uint32_t h = (tick / period) * 2654435761u;
+    h ^= h >> 15;
+    h *= 2246822519u;
+    h ^= h >> 13;
+    return (h % 1024u) / 1024.0f;
+}
+
+static void Test_Tick(uint32_t tick, float current) {
+    ProtectionOverload_Run(&sm, current);
+    ProtectionOverload_RecorderRecord(&recorder, &sm, current);
+    reference_current[tick] = current;
+    reference_energy[tick] = ProtectionOverload_GetEnergy(&sm);
+    reference_state[tick] = sm.state;
+}
+
+// Decoded samples are the recorded ticks within half a quantization step
+static void Test_CheckSamples(uint32_t count, uint32_t last_tick) {
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t tick = samples[i].tick;
+        TEST_ASSERT_EQUAL_UINT32(last_tick + 1u - count + i, tick);
+        TEST_ASSERT_FLOAT_WITHIN(0.51f * RECORDER_CURRENT_LSB, reference_current[tick], samples[i].current);
+        TEST_ASSERT_FLOAT_WITHIN(0.51f * PROTECTION_OVERLOAD_RECORDER_ENERGY_LSB, reference_energy[tick], samples[i].energy);
+        TEST_ASSERT_EQUAL(reference_state[tick], samples[i].state);
+    }
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    ProtectionOverload_Init(&sm, &params, ProtectionOverload_SM_GetCallRate());
+    ProtectionOverload_TripLogInit(&trip_log, trip_records, 4);
+    TEST_ASSERT_TRUE(ProtectionOverload_RecorderInit(&recorder, blocks, 16, RECORDER_CURRENT_LSB, 7, &trip_log));
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+// Steps, noise, pickups and dropouts: the ring keeps the newest ticks
+void test_recorder_round_trip(void) {
+    ProtectionOverloadParams slow = params;
+    slow.k_factor = 1000.0f;
+    slow.max_energy = 100.0f;
+    ProtectionOverload_Init(&sm, &slow, ProtectionOverload_SM_GetCallRate());
+    for (uint32_t tick = 0; tick < RECORDER_TICKS; tick++) {
+        float current = 2.0f * Test_Level(tick, 300);
+        if (tick % 4000u < 1000u) {
+            current += 0.01f * Test_Level(tick, 1);
+        }
+        Test_Tick(tick, current);
+    }
+    TEST_ASSERT_FALSE(recorder.frozen);
+    TEST_ASSERT_EQUAL_UINT32(16, recorder.used_blocks);
+
+    uint32_t history = ProtectionOverload_RecorderHistoryTicks(&recorder);
+    TEST_ASSERT_TRUE(history > 0 && history < RECORDER_TICKS);
+    TEST_ASSERT_EQUAL_UINT32(history, ProtectionOverload_RecorderRead(&recorder, samples, RECORDER_TICKS));
+    Test_CheckSamples(history, RECORDER_TICKS - 1u);
+
+    // Last second only
+    TEST_ASSERT_EQUAL_UINT32(100, ProtectionOverload_RecorderRead(&recorder, samples, 100));
+    Test_CheckSamples(100, RECORDER_TICKS - 1u);
+}
+
+// History frozen on the trip tick, one trip record
+void test_recorder_frozen_on_trip(void) {
+    uint32_t tick = 0;
+    for (; tick < 500u; tick++) {
+        Test_Tick(tick, 0.5f);
+    }
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED && tick < 1000u) {
+        Test_Tick(tick++, 2.0f);
+    }
+    uint32_t trip_tick = tick - 1u;
+    for (uint32_t i = 0; i < 100u; i++) {
+        ProtectionOverload_Run(&sm, 0.0f);
+        ProtectionOverload_RecorderRecord(&recorder, &sm, 0.0f);
+    }
+
+    TEST_ASSERT_TRUE(recorder.frozen);
+    TEST_ASSERT_EQUAL_UINT32(trip_tick + 1u, ProtectionOverload_RecorderHistoryTicks(&recorder));
+    uint32_t count = ProtectionOverload_RecorderRead(&recorder, samples, RECORDER_TICKS);
+    TEST_ASSERT_EQUAL_UINT32(trip_tick + 1u, count);
+    Test_CheckSamples(count, trip_tick);
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, samples[count - 1u].state);
+    // Steady load before the overload: a few bytes
+    TEST_ASSERT_TRUE(ProtectionOverload_RecorderBytes(&recorder) < 512u);
+
+    ProtectionOverloadTripRecord record;
+    TEST_ASSERT_TRUE(ProtectionOverload_TripLogGet(&trip_log, 0, &record));
+    TEST_ASSERT_FALSE(ProtectionOverload_TripLogGet(&trip_log, 1, &record));
+    TEST_ASSERT_EQUAL_UINT32(1, record.sequence);
+    TEST_ASSERT_EQUAL_UINT32(7, record.source);
+    TEST_ASSERT_EQUAL_UINT32(trip_tick, record.tick);
+    TEST_ASSERT_EQUAL_UINT32(trip_tick + 1u, record.history_ticks);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, record.current);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, record.overload_factor);
+    TEST_ASSERT_TRUE(record.energy >= 1.0f);
+
+    // Rearm after the reset: new history, tick numbering continues
+    TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+    ProtectionOverload_RecorderRearm(&recorder);
+    ProtectionOverload_Run(&sm, 0.5f);
+    ProtectionOverload_RecorderRecord(&recorder, &sm, 0.5f);
+    TEST_ASSERT_EQUAL_UINT32(1, ProtectionOverload_RecorderRead(&recorder, samples, RECORDER_TICKS));
+    TEST_ASSERT_EQUAL_UINT32(trip_tick + 1u, samples[0].tick);
+    TEST_ASSERT_EQUAL(ST_IDLE, samples[0].state);
+}
+
+// One hour of load steps with overload excursions (pickup, heating, cooling) in 32 KB
+void test_recorder_hour_in_32k(void) {
+    ProtectionOverloadParams feeder = params;
+    feeder.k_factor = 10.0f;
+    feeder.max_energy = 60.0f;
+    ProtectionOverload_Init(&sm, &feeder, ProtectionOverload_SM_GetCallRate());
+    TEST_ASSERT_TRUE(ProtectionOverload_RecorderInit(&recorder, blocks, RECORDER_HOUR_BLOCKS, RECORDER_CURRENT_LSB, 7, NULL));
+
+    for (uint32_t tick = 0; tick < RECORDER_HOUR_TICKS; tick++) {
+        // New level every 10 s, 5 s at 1.3 x I_trip every 10 min
+        float current = (tick % 60000u < 500u) ? 1.3f : 0.2f + 0.7f * Test_Level(tick, 1000);
+        Test_Tick(tick, current);
+    }
+    size_t bytes = ProtectionOverload_RecorderBytes(&recorder);
+    printf("1 h at 10 ms: %zu bytes (%.3f bytes per tick)\n", bytes, (double)bytes / RECORDER_HOUR_TICKS);
+    TEST_ASSERT_EQUAL(ST_IDLE, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_EQUAL_UINT32(RECORDER_HOUR_TICKS, ProtectionOverload_RecorderHistoryTicks(&recorder));
+    TEST_ASSERT_TRUE(bytes <= sizeof(blocks));
+
+    TEST_ASSERT_EQUAL_UINT32(RECORDER_HOUR_TICKS, ProtectionOverload_RecorderRead(&recorder, samples, RECORDER_HOUR_TICKS));
+    Test_CheckSamples(RECORDER_HOUR_TICKS, RECORDER_HOUR_TICKS - 1u);
+}
+
+// Restart: valid records kept, corrupted one erased, sequence continues
+void test_trip_log_survives_restart(void) {
+    for (uint32_t i = 1; i <= 6u; i++) {
+        ProtectionOverloadTripRecord record = {.source = i, .tick = 100u * i, .energy = 1.0f};
+        ProtectionOverload_TripLogAppend(&trip_log, &record);
+    }
+    // Torn write of trip 4
+    trip_records[3].energy = 0.5f;
+
+    ProtectionOverloadTripLog restarted;
+    TEST_ASSERT_EQUAL_UINT32(3, ProtectionOverload_TripLogAttach(&restarted, trip_records, 4));
+    TEST_ASSERT_EQUAL_UINT32(6, restarted.sequence);
+
+    ProtectionOverloadTripRecord record;
+    TEST_ASSERT_TRUE(ProtectionOverload_TripLogGet(&restarted, 0, &record));
+    TEST_ASSERT_EQUAL_UINT32(6, record.sequence);
+    TEST_ASSERT_EQUAL_UINT32(600, record.tick);
+    TEST_ASSERT_TRUE(ProtectionOverload_TripLogGet(&restarted, 1, &record));
+    TEST_ASSERT_EQUAL_UINT32(5, record.source);
+    TEST_ASSERT_FALSE(ProtectionOverload_TripLogGet(&restarted, 2, &record));
+    TEST_ASSERT_TRUE(ProtectionOverload_TripLogGet(&restarted, 3, &record));
+    TEST_ASSERT_EQUAL_UINT32(3, record.sequence);
+    TEST_ASSERT_FALSE(ProtectionOverload_TripLogGet(&restarted, 4, &record));
+
+    record = (ProtectionOverloadTripRecord){.source = 7};
+    ProtectionOverload_TripLogAppend(&restarted, &record);
+    TEST_ASSERT_EQUAL_UINT32(7, record.sequence);
+    TEST_ASSERT_EQUAL_UINT32(7, trip_records[2].sequence);
+}
+
+// Recording cost per tick relative to Run alone, against test/perf_baseline.txt:
+// steady load (run counter) and a new sample every tick
+void test_recorder_cost(void) {
+    ProtectionOverloadParams bench_params = params;
+    bench_params.k_factor = 1e9f;
+    ProtectionOverload_Init(&sm, &bench_params, ProtectionOverload_SM_GetCallRate());
+
+    UnityBench run, steady, varying;
+    TEST_BENCH_ROUNDS(r) {
+        TEST_BENCH_BATCH(run, "Run below pickup, not recorded", RECORDER_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 0.5f);
+        }
+        TEST_BENCH_BATCH(steady, "Run + record, steady", RECORDER_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 0.5f);
+            ProtectionOverload_RecorderRecord(&recorder, &sm, 0.5f);
+        }
+        TEST_BENCH_BATCH(varying, "Run + record, new sample", RECORDER_BENCH_RUNS, r) {
+            float current = 0.5f + 0.01f * (float)(unity_bench_i & 7u);
+            ProtectionOverload_Run(&sm, current);
+            ProtectionOverload_RecorderRecord(&recorder, &sm, current);
+        }
+    }
+
+    printf("Run %.2f ns, + record steady %.2f ns (overhead %.2f ns), new sample %.2f ns (overhead %.2f ns)\n",
+           run.median_ns_per_call, steady.median_ns_per_call, steady.median_ns_per_call - run.median_ns_per_call,
+           varying.median_ns_per_call, varying.median_ns_per_call - run.median_ns_per_call);
+    TEST_ASSERT_FALSE(recorder.frozen);
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(steady, run);
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(varying, run);
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nDisturbance recorder and trip log\n");
+    RUN_TEST(test_recorder_round_trip);
+    RUN_TEST(test_recorder_frozen_on_trip);
+    RUN_TEST(test_recorder_hour_in_32k);
+    RUN_TEST(test_trip_log_survives_restart);
+    RUN_TEST(test_recorder_cost);
+
+    return UNITY_END();
+}
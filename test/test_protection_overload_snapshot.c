@@ -0,0 +1,201 @@
+// Snapshot (seqlock) unit and stress tests
+
+#include "unity.h"
+#include "unity_bench.h"
+#include "protection_overload.h"
+#include "protection_overload_snapshot.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+
+#define SNAPSHOT_READERS    3           // Concurrent reader threads
+#define SNAPSHOT_WRITES     2000000u    // Tuples published by the stress writer
+#define SNAPSHOT_BENCH_RUNS 1000000     // Calls per timed batch
+
+// Test current value (mocked sensor value)
+static float test_current = 0.0f;
+
+float Sensor_Read() {
+    return test_current;
+}
+
+static ProtectionOverloadParams params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+/* ------------------------------------------------
+        Concurrent readers
+   ------------------------------------------------ */
+
+static ProtectionOverloadSeqlock stress_lock;
+static atomic_bool stress_done;
+
+typedef struct {
+    pthread_t thread;
+    uint64_t reads;                     // Consistent snapshots read
+    uint64_t retries;                   // Attempts during a write
+    uint64_t errors;                    // Inconsistent tuples or tick going back
+    atomic_bool has_read;               // At least one consistent read
+} SnapshotReader;
+
+// Published tuples satisfy: state = tick & 1, energy = tick / 4, factor = -tick
+static void *Snapshot_Reader(void *arg) {
+    SnapshotReader *reader = arg;
+    uint32_t last_tick = 0;
+    while (!atomic_load_explicit(&stress_done, memory_order_relaxed)) {
+        ProtectionOverloadSnapshot snapshot;
+        if (!ProtectionOverload_SnapshotTryRead(&stress_lock, &snapshot)) {
+            reader->retries++;
+            continue;
+        }
+        reader->errors += (snapshot.state != (ProtectionOverloadState)(snapshot.tick & 1u)) ||
+                          (snapshot.energy != (float)snapshot.tick * 0.25f) ||
+                          (snapshot.overload_factor != -(float)snapshot.tick) ||
+                          (snapshot.tick < last_tick);
+        last_tick = snapshot.tick;
+        if (reader->reads++ == 0) {
+            atomic_store_explicit(&reader->has_read, true, memory_order_release);
+        }
+    }
+    return NULL;
+}
+
+static void Snapshot_StartReaders(SnapshotReader *readers) {
+    atomic_store(&stress_done, false);
+    for (int r = 0; r < SNAPSHOT_READERS; r++) {
+        readers[r] = (SnapshotReader){0};
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&readers[r].thread, NULL, Snapshot_Reader, &readers[r]));
+    }
+}
+
+// Stop once every reader has a consistent read (a reader may not be scheduled during the writes)
+static void Snapshot_StopReaders(SnapshotReader *readers) {
+    for (int r = 0; r < SNAPSHOT_READERS; r++) {
+        while (!atomic_load_explicit(&readers[r].has_read, memory_order_acquire)) {
+            sched_yield();
+        }
+    }
+    atomic_store(&stress_done, true);
+    for (int r = 0; r < SNAPSHOT_READERS; r++) {
+        pthread_join(readers[r].thread, NULL);
+    }
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    ProtectionOverload_SM_Init(&params);
+    ProtectionOverload_SnapshotWrite(&stress_lock, ST_IDLE, 0.0f, -0.0f, 0);
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+// Single instance publishes after Init and after every Run
+void test_snapshot_tracks_single_instance(void) {
+    ProtectionOverloadSnapshot snapshot;
+    ProtectionOverload_SM_GetSnapshot(&snapshot);
+    TEST_ASSERT_EQUAL(ST_IDLE, snapshot.state);
+    TEST_ASSERT_EQUAL_UINT32(0, snapshot.tick);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, snapshot.energy);
+
+    test_current = 2.0f;
+    uint32_t ticks = 0;
+    while (ProtectionOverload_SM_GetState() != ST_OVERLOAD_TRIGGERED && ticks < 1000) {
+        ProtectionOverload_SM_Run();
+        ticks++;
+        ProtectionOverload_SM_GetSnapshot(&snapshot);
+        TEST_ASSERT_EQUAL_UINT32(ticks, snapshot.tick);
+        TEST_ASSERT_EQUAL_FLOAT(2.0f, snapshot.overload_factor);
+    }
+    TEST_ASSERT_EQUAL(ST_OVERLOAD_TRIGGERED, snapshot.state);
+    TEST_ASSERT_TRUE(snapshot.energy >= 1.0f);
+    // I2t at 2 x I_trip: t_trip = 1 / (4 - 1) s
+    TEST_ASSERT_UINT32_WITHIN(1, 34, snapshot.tick);
+}
+
+// Readers on other threads never see a mixed tuple, the writer never waits
+void test_snapshot_concurrent_readers_consistent(void) {
+    static SnapshotReader readers[SNAPSHOT_READERS];
+    Snapshot_StartReaders(readers);
+    for (uint32_t tick = 1; tick <= SNAPSHOT_WRITES; tick++) {
+        ProtectionOverload_SnapshotWrite(&stress_lock, (ProtectionOverloadState)(tick & 1u), (float)tick * 0.25f, -(float)tick, tick);
+    }
+    Snapshot_StopReaders(readers);
+
+    uint64_t reads = 0, retries = 0;
+    for (int r = 0; r < SNAPSHOT_READERS; r++) {
+        TEST_ASSERT_EQUAL_UINT64(0, readers[r].errors);
+        reads += readers[r].reads;
+        retries += readers[r].retries;
+    }
+    printf("%u writes, %llu consistent reads, %llu retries during writes\n", SNAPSHOT_WRITES,
+           (unsigned long long)reads, (unsigned long long)retries);
+    TEST_ASSERT_TRUE(reads > 0);
+
+    ProtectionOverloadSnapshot snapshot;
+    ProtectionOverload_SnapshotRead(&stress_lock, &snapshot);
+    TEST_ASSERT_EQUAL_UINT32(SNAPSHOT_WRITES, snapshot.tick);
+}
+
+// Writer cost of a publish after each Run, relative to Run alone, against
+// test/perf_baseline.txt; with readers polling the snapshot it depends on the
+// core count and is only printed
+void test_snapshot_writer_overhead(void) {
+    static SnapshotReader readers[SNAPSHOT_READERS];
+    ProtectionOverloadSM sm;
+    ProtectionOverloadParams bench_params = params;
+    bench_params.k_factor = 1e9f;
+    ProtectionOverload_Init(&sm, &bench_params, ProtectionOverload_SM_GetCallRate());
+
+    UnityBench run, publish, contended;
+    uint32_t tick = 0;
+    TEST_BENCH_ROUNDS(r) {
+        TEST_BENCH_BATCH(run, "Run heating, no publish", SNAPSHOT_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 2.0f);
+        }
+        TEST_BENCH_BATCH(publish, "Run + publish", SNAPSHOT_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 2.0f);
+            ProtectionOverload_SnapshotPublish(&stress_lock, &sm, ++tick);
+        }
+    }
+    // With readers: the writer shares the snapshot cache line (and the CPU when cores are few)
+    Snapshot_StartReaders(readers);
+    TEST_BENCH(contended, "Run + publish, readers", SNAPSHOT_BENCH_RUNS) {
+        ProtectionOverload_Run(&sm, 2.0f);
+        ProtectionOverload_SnapshotPublish(&stress_lock, &sm, ++tick);
+    }
+    Snapshot_StopReaders(readers);
+
+    printf("Run %.2f ns, + publish %.2f ns (overhead %.2f ns), with %d readers %.2f ns\n", run.median_ns_per_call,
+           publish.median_ns_per_call, publish.median_ns_per_call - run.median_ns_per_call, SNAPSHOT_READERS,
+           contended.median_ns_per_call);
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(publish, run);
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nSeqlock state snapshots\n");
+    RUN_TEST(test_snapshot_tracks_single_instance);
+    RUN_TEST(test_snapshot_concurrent_readers_consistent);
+    RUN_TEST(test_snapshot_writer_overhead);
+
+    return UNITY_END();
+}
@@ -0,0 +1,225 @@
+// Trace points unit tests (engine built with -DPROTECTION_OVERLOAD_TRACE)
+
+#include "unity.h"
+#include "unity_bench.h"
+#include "protection_overload.h"
+#include "protection_overload_trace.h"
+#include "trace_dump.h"
+#include <pthread.h>
+#include <string.h>
+
+#ifndef TEST_OUTPUT_DIR
+#define TEST_OUTPUT_DIR "build"
+#endif
+
+#define TEST_DUMP           TEST_OUTPUT_DIR "/test_trace.bin"
+#define TRACE_THREADS       4           // Threads with their own ring and instance
+#define TRACE_THREAD_TRIPS  200         // Trips per thread (rings wrap)
+#define TRACE_BENCH_RUNS    1000000     // Calls per timed batch
+
+// Not used: currents are passed to the engine
+float Sensor_Read() {
+    return 0.0f;
+}
+
+static const ProtectionOverloadParams params = {
+    .overload_threshold = 1.0f,
+    .k_factor = 1.0f,
+    .cooling_rate = 0.98f,
+    .max_energy = 1.0f,
+    .curve = CURVE_I2T
+};
+
+static ProtectionOverloadSM sm;
+static ProtectionOverloadTraceRecord records[PROTECTION_OVERLOAD_TRACE_RECORDS];
+
+// Records written by the calling thread since head
+static uint32_t Test_ReadSince(uint32_t head) {
+    const ProtectionOverloadTraceRing *ring = ProtectionOverload_TraceRing();
+    return ProtectionOverload_TraceRead(ring, records, ring->head - head);
+}
+
+static void Test_AssertRecord(const ProtectionOverloadTraceRecord *record, const void *instance,
+                              ProtectionOverloadTracePoint point, unsigned int arg) {
+    TEST_ASSERT_EQUAL_HEX32((uint32_t)(uintptr_t)instance, record->instance);
+    TEST_ASSERT_EQUAL_STRING(ProtectionOverload_TraceName(point), ProtectionOverload_TraceName(record->point));
+    TEST_ASSERT_EQUAL_UINT(arg, record->arg);
+}
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+// Init, pickup, energy levels, trip and reset in order, nothing traced on steady ticks
+void test_trace_points_to_trip(void) {
+    uint32_t head = ProtectionOverload_TraceRing()->head;
+    ProtectionOverload_Init(&sm, &params, ProtectionOverload_SM_GetCallRate());
+    for (int i = 0; i < 100; i++) {
+        ProtectionOverload_Run(&sm, 0.5f);
+    }
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverload_Run(&sm, 2.0f);
+    }
+    ProtectionOverload_Run(&sm, 0.0f);
+    TEST_ASSERT_TRUE(ProtectionOverload_Reset(&sm));
+
+    TEST_ASSERT_EQUAL_UINT32(9, Test_ReadSince(head));
+    Test_AssertRecord(&records[0], &sm, TRACE_STATE_ENTRY, ST_IDLE);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, records[0].value);
+    Test_AssertRecord(&records[1], &sm, TRACE_PICKUP, 0);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, records[1].value);
+    Test_AssertRecord(&records[2], &sm, TRACE_STATE_ENTRY, ST_PICKUP);
+    Test_AssertRecord(&records[3], &sm, TRACE_ENERGY_LEVEL, 50);
+    Test_AssertRecord(&records[4], &sm, TRACE_ENERGY_LEVEL, 75);
+    Test_AssertRecord(&records[5], &sm, TRACE_ENERGY_LEVEL, 90);
+    TEST_ASSERT_TRUE(records[5].value >= 0.9f && records[5].value < 1.0f);
+    Test_AssertRecord(&records[6], &sm, TRACE_TRIP, 0);
+    TEST_ASSERT_TRUE(records[6].value >= 1.0f);
+    Test_AssertRecord(&records[7], &sm, TRACE_STATE_ENTRY, ST_OVERLOAD_TRIGGERED);
+    Test_AssertRecord(&records[8], &sm, TRACE_STATE_ENTRY, ST_IDLE);
+    // Default clock: sequence in the thread ring
+    TEST_ASSERT_EQUAL_UINT32(head, records[0].timestamp);
+    TEST_ASSERT_EQUAL_UINT32(head + 8u, records[8].timestamp);
+}
+
+typedef struct {
+    pthread_t thread;
+    ProtectionOverloadSM sm;
+    uint32_t head;                      // Records written by the thread
+    uint32_t records;                   // Records in the thread ring
+    uint32_t foreign;                   // Records of another instance
+} TraceWorker;
+
+// Trip repeatedly from cold, then check the own ring only holds the own instance
+static void *Trace_Worker(void *arg) {
+    TraceWorker *worker = arg;
+    for (int trip = 0; trip < TRACE_THREAD_TRIPS; trip++) {
+        ProtectionOverload_Init(&worker->sm, &params, ProtectionOverload_SM_GetCallRate());
+        while (ProtectionOverload_GetState(&worker->sm) != ST_OVERLOAD_TRIGGERED) {
+            ProtectionOverload_Run(&worker->sm, 3.0f);
+        }
+    }
+    static _Thread_local ProtectionOverloadTraceRecord own[PROTECTION_OVERLOAD_TRACE_RECORDS];
+    worker->head = ProtectionOverload_TraceRing()->head;
+    worker->records = ProtectionOverload_TraceRead(ProtectionOverload_TraceRing(), own, PROTECTION_OVERLOAD_TRACE_RECORDS);
+    for (uint32_t i = 0; i < worker->records; i++) {
+        worker->foreign += (own[i].instance != (uint32_t)(uintptr_t)&worker->sm);
+    }
+    return NULL;
+}
+
+// One ring per thread: no lock, no interleaving
+void test_trace_rings_per_thread(void) {
+    static TraceWorker workers[TRACE_THREADS];
+    uint32_t head = ProtectionOverload_TraceRing()->head;
+    for (int t = 0; t < TRACE_THREADS; t++) {
+        TEST_ASSERT_EQUAL_INT(0, pthread_create(&workers[t].thread, NULL, Trace_Worker, &workers[t]));
+    }
+    for (int t = 0; t < TRACE_THREADS; t++) {
+        pthread_join(workers[t].thread, NULL);
+        // Per trip: init, pickup, 2 entries, 3 levels, trip
+        TEST_ASSERT_EQUAL_UINT32(8u * TRACE_THREAD_TRIPS, workers[t].head);
+        TEST_ASSERT_EQUAL_UINT32(PROTECTION_OVERLOAD_TRACE_RECORDS, workers[t].records);
+        TEST_ASSERT_EQUAL_UINT32(0, workers[t].foreign);
+    }
+    TEST_ASSERT_EQUAL_UINT32(head, ProtectionOverload_TraceRing()->head);
+}
+
+// Dump, read back and timeline
+void test_trace_dump_timeline(void) {
+    ProtectionOverload_Init(&sm, &params, ProtectionOverload_SM_GetCallRate());
+    while (ProtectionOverload_GetState(&sm) != ST_OVERLOAD_TRIGGERED) {
+        ProtectionOverload_Run(&sm, 2.0f);
+    }
+    const ProtectionOverloadTraceRing *ring = ProtectionOverload_TraceRing();
+    FILE *file = fopen(TEST_DUMP, "wb");
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_TRUE(TraceDump_Write(file, 1, ring));
+    TEST_ASSERT_TRUE(TraceDump_Write(file, 2, ring));
+    fclose(file);
+
+    static ProtectionOverloadTraceRecord expected[PROTECTION_OVERLOAD_TRACE_RECORDS];
+    uint32_t count = ProtectionOverload_TraceRead(ring, expected, PROTECTION_OVERLOAD_TRACE_RECORDS);
+    file = fopen(TEST_DUMP, "rb");
+    TEST_ASSERT_NOT_NULL(file);
+    TraceDumpHeader header;
+    TEST_ASSERT_TRUE(TraceDump_Read(file, &header, records, PROTECTION_OVERLOAD_TRACE_RECORDS));
+    TEST_ASSERT_EQUAL_UINT32(1, header.thread);
+    TEST_ASSERT_EQUAL_UINT32(count, header.count);
+    TEST_ASSERT_EQUAL_UINT32(ring->head - count, header.first_sequence);
+    TEST_ASSERT_EQUAL_MEMORY(expected, records, count * sizeof(records[0]));
+    // Second block truncated to 4 records
+    TEST_ASSERT_TRUE(TraceDump_Read(file, &header, records, 4));
+    TEST_ASSERT_EQUAL_UINT32(2, header.thread);
+    TEST_ASSERT_EQUAL_UINT32(4, header.count);
+    TEST_ASSERT_FALSE(TraceDump_Read(file, &header, records, 4));
+    fclose(file);
+
+    // Last records of the timeline: trip, then entry in the tripped state
+    char timeline[512] = {0};
+    file = tmpfile();
+    TEST_ASSERT_NOT_NULL(file);
+    header = (TraceDumpHeader){.thread = 1, .first_sequence = ring->head - 2u, .count = 2};
+    TraceDump_Timeline(file, &header, &expected[count - 2u]);
+    rewind(file);
+    TEST_ASSERT_TRUE(fread(timeline, 1, sizeof(timeline) - 1u, file) > 0);
+    fclose(file);
+    TEST_ASSERT_NOT_NULL(strstr(timeline, "trip         energy 1.0"));
+    TEST_ASSERT_NOT_NULL(strstr(timeline, "state entry  TRIGGERED"));
+}
+
+// Cost of a trace point, and of a heating tick with the level compares, relative
+// to an idle tick (no trace point on its path) against test/perf_baseline.txt
+void test_trace_cost(void) {
+    ProtectionOverloadParams bench_params = params;
+    bench_params.k_factor = 1e9f;
+    ProtectionOverload_Init(&sm, &bench_params, ProtectionOverload_SM_GetCallRate());
+
+    UnityBench idle, write, heating;
+    TEST_BENCH_ROUNDS(r) {
+        // Idle from a fresh start, the heating batch of the last round left the engine in pickup
+        ProtectionOverload_Init(&sm, &bench_params, ProtectionOverload_SM_GetCallRate());
+        TEST_BENCH_BATCH(idle, "Run below pickup, traced build", TRACE_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 0.5f);
+        }
+        TEST_BENCH_BATCH(write, "Trace point", TRACE_BENCH_RUNS, r) {
+            ProtectionOverload_TraceWrite(TRACE_PICKUP, &sm, 0u, (float)unity_bench_i);
+        }
+        TEST_BENCH_BATCH(heating, "Run heating, traced", TRACE_BENCH_RUNS, r) {
+            ProtectionOverload_Run(&sm, 2.0f);
+        }
+    }
+
+    printf("Idle tick %.2f ns, trace point %.2f ns, heating tick with trace points %.2f ns\n", idle.median_ns_per_call,
+           write.median_ns_per_call, heating.median_ns_per_call);
+    TEST_ASSERT_EQUAL(ST_PICKUP, ProtectionOverload_GetState(&sm));
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(write, idle);
+    TEST_ASSERT_BENCH_BASELINE_RELATIVE(heating, idle);
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nTrace points\n");
+    RUN_TEST(test_trace_points_to_trip);
+    RUN_TEST(test_trace_rings_per_thread);
+    RUN_TEST(test_trace_dump_timeline);
+    RUN_TEST(test_trace_cost);
+
+    return UNITY_END();
+}
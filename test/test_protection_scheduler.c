@@ -0,0 +1,216 @@
+// Multi-rate protection scheduler unit tests
+
+#include "unity.h"
+#include "protection_overload.h"
+#include "protection_scheduler.h"
+
+#define TEST_BASE_TICK_SEC  0.001f      // Base tick [s] = 1 ms
+
+// Test current value (mocked sensor value)
+float test_current = 0.0f;
+
+// Mocked cycle counter, advanced by the test elements
+static uint32_t test_cycles;
+
+// Run log: element context of each run
+static int run_log[64];
+static unsigned int run_log_count;
+
+static ProtectionScheduler sched;
+static uint16_t slot_first[1000 + 1];
+static uint8_t slot_tasks[2000];
+
+/* ------------------------------------------------
+        Unity setup and teardown functions
+   ------------------------------------------------ */
+
+void setUp(void) {
+    test_current = 0.0f;
+    test_cycles = 0;
+    run_log_count = 0;
+}
+
+void tearDown(void) {
+}
+
+/* ------------------------------------------------
+        Mocked Sensor Read and Clock Functions
+   ------------------------------------------------ */
+
+float Sensor_Read() {
+    return test_current;
+}
+
+static uint32_t test_clock(void) {
+    return test_cycles;
+}
+
+/* ------------------------------------------------
+        Test Elements
+   ------------------------------------------------ */
+
+// Logs its id and consumes 100 cycles
+static void element_log(void *context) {
+    if (run_log_count < sizeof(run_log) / sizeof(run_log[0])) {
+        run_log[run_log_count++] = *(const int *)context;
+    }
+    test_cycles += 100;
+}
+
+static void element_engine(void *context) {
+    ProtectionOverload_Run((ProtectionOverloadSM *)context, Sensor_Read());
+}
+
+static const int ids[] = {0, 1, 2};
+
+static ProtectionSchedulerResult init_scheduler(const ProtectionSchedulerTask *tasks, unsigned int task_count) {
+    ProtectionSchedulerConfig config = {
+        .tasks = tasks,
+        .task_count = task_count,
+        .clock = test_clock,
+        .tick_budget = 250,
+        .slot_first = slot_first,
+        .slot_first_len = sizeof(slot_first) / sizeof(slot_first[0]),
+        .slot_tasks = slot_tasks,
+        .slot_tasks_len = sizeof(slot_tasks)
+    };
+    return ProtectionScheduler_Init(&sched, &config);
+}
+
+/* ------------------------------------------------
+        Test Functions
+   ------------------------------------------------ */
+
+void test_scheduler_table_size(void) {
+    const ProtectionSchedulerTask tasks[] = {
+        {element_log, (void *)&ids[0], 1, 0, 0},
+        {element_log, (void *)&ids[1], 10, 0, 0},
+        {element_log, (void *)&ids[2], 100, 5, 0},
+    };
+    TEST_ASSERT_EQUAL_UINT32(100, ProtectionScheduler_Hyperperiod(tasks, 3));
+    TEST_ASSERT_EQUAL_UINT32(111, ProtectionScheduler_SlotEntries(tasks, 3));
+
+    const ProtectionSchedulerTask coprime[] = {
+        {element_log, (void *)&ids[0], 4, 0, 0},
+        {element_log, (void *)&ids[1], 6, 0, 0},
+    };
+    TEST_ASSERT_EQUAL_UINT32(12, ProtectionScheduler_Hyperperiod(coprime, 2));
+}
+
+void test_scheduler_invalid_tasks(void) {
+    const ProtectionSchedulerTask zero_period[] = {{element_log, (void *)&ids[0], 0, 0, 0}};
+    const ProtectionSchedulerTask bad_offset[] = {{element_log, (void *)&ids[0], 10, 10, 0}};
+    const ProtectionSchedulerTask too_long[] = {{element_log, (void *)&ids[0], 7, 0, 0}, {element_log, (void *)&ids[1], 300, 0, 0}};
+
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_ERR_ARG, init_scheduler(zero_period, 1));
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_ERR_ARG, init_scheduler(bad_offset, 1));
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_ERR_ARG, init_scheduler(bad_offset, 0));
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_ERR_SPACE, init_scheduler(too_long, 2));
+}
+
+void test_scheduler_rates(void) {
+    const ProtectionSchedulerTask tasks[] = {
+        {element_log, (void *)&ids[0], 1, 0, 0},
+        {element_log, (void *)&ids[1], 10, 0, 0},
+        {element_log, (void *)&ids[2], 100, 5, 0},
+    };
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_OK, init_scheduler(tasks, 3));
+
+    // 1 s: 1000 + 100 + 10 runs instead of 3000 at the fastest rate
+    for (int tick = 0; tick < 1000; tick++) {
+        ProtectionScheduler_Tick(&sched);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1110, sched.runs);
+}
+
+void test_scheduler_slot_order_and_offset(void) {
+    const ProtectionSchedulerTask tasks[] = {
+        {element_log, (void *)&ids[0], 1, 0, 0},
+        {element_log, (void *)&ids[1], 10, 0, 0},
+        {element_log, (void *)&ids[2], 100, 5, 0},
+    };
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_OK, init_scheduler(tasks, 3));
+
+    // Slot 0: fast element first, slot 5: thermal element, off the 10 ms slot
+    const int expected[] = {0, 1, 0, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 1};
+    for (int tick = 0; tick < 11; tick++) {
+        ProtectionScheduler_Tick(&sched);
+    }
+    TEST_ASSERT_EQUAL_UINT(sizeof(expected) / sizeof(expected[0]), run_log_count);
+    TEST_ASSERT_EQUAL_INT_ARRAY(expected, run_log, run_log_count);
+}
+
+void test_scheduler_deadline_overrun(void) {
+    // Each element takes 100 cycles: on slot 0 the 10 ms element completes at 200
+    const ProtectionSchedulerTask tasks[] = {
+        {element_log, (void *)&ids[0], 1, 0, 150},
+        {element_log, (void *)&ids[1], 10, 0, 150},
+        {element_log, (void *)&ids[2], 10, 0, 0},
+    };
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_OK, init_scheduler(tasks, 3));
+
+    for (int tick = 0; tick < 100; tick++) {
+        ProtectionScheduler_Tick(&sched);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, ProtectionScheduler_GetOverruns(&sched, 0));
+    TEST_ASSERT_EQUAL_UINT32(10, ProtectionScheduler_GetOverruns(&sched, 1));
+    TEST_ASSERT_EQUAL_UINT32(0, ProtectionScheduler_GetOverruns(&sched, 2));
+    TEST_ASSERT_EQUAL_UINT32(300, ProtectionScheduler_GetMaxResponse(&sched, 2));
+
+    // 300 cycles on the 10 ms slots exceed the 250 cycles tick budget
+    TEST_ASSERT_EQUAL_UINT32(10, sched.slot_overruns);
+}
+
+void test_scheduler_engines_at_own_rate(void) {
+    ProtectionOverloadParams params = {
+        .overload_threshold = 1.0f,
+        .k_factor = 1.0f,
+        .cooling_rate = 0.98f,
+        .max_energy = 1.0f
+    };
+    const uint16_t periods[] = {1, 10, 100};
+    ProtectionOverloadSM engines[3];
+    ProtectionSchedulerTask tasks[3];
+    for (int i = 0; i < 3; i++) {
+        ProtectionOverload_Init(&engines[i], &params, periods[i] * TEST_BASE_TICK_SEC);
+        tasks[i] = (ProtectionSchedulerTask){element_engine, &engines[i], periods[i], 0, 0};
+    }
+    TEST_ASSERT_EQUAL(PROTECTION_SCHEDULER_OK, init_scheduler(tasks, 3));
+
+    // Overload 2,0 x Itrip: 0,33 s trip time, each element within its own period (+1 tick rounding)
+    test_current = 2.0f;
+    int trip_tick[3] = {-1, -1, -1};
+    for (int tick = 1; tick <= 1000; tick++) {
+        ProtectionScheduler_Tick(&sched);
+        for (int i = 0; i < 3; i++) {
+            if (trip_tick[i] < 0 && ProtectionOverload_GetState(&engines[i]) == ST_OVERLOAD_TRIGGERED) {
+                trip_tick[i] = tick;
+            }
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_TRUE(trip_tick[i] > 0);
+        TEST_ASSERT_FLOAT_WITHIN((periods[i] + 1) * TEST_BASE_TICK_SEC, 0.333f, trip_tick[i] * TEST_BASE_TICK_SEC);
+    }
+}
+
+/* ------------------------------------------------
+        Main Function
+   ------------------------------------------------ */
+
+int main() {
+
+    UNITY_BEGIN();
+
+    printf("\nMulti-rate scheduler\n");
+    RUN_TEST(test_scheduler_table_size);
+    RUN_TEST(test_scheduler_invalid_tasks);
+    RUN_TEST(test_scheduler_rates);
+    RUN_TEST(test_scheduler_slot_order_and_offset);
+    RUN_TEST(test_scheduler_deadline_overrun);
+
+    printf("\nProtection elements at their own rate\n");
+    RUN_TEST(test_scheduler_engines_at_own_rate);
+
+    return UNITY_END();
+}
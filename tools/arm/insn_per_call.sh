@@ -0,0 +1,30 @@
+#!/bin/sh
+# Deterministic instructions per ProtectionOverload_SM_Run under QEMU.
+#
+# Usage: insn_per_call.sh <label> <command ...>
+# The command must contain the placeholder @N@ for the benchmark iteration count
+# and load the QEMU "insn" plugin with -d plugin. The benchmark is run with two
+# iteration counts: the difference removes startup and libc cost.
+
+N1=100000
+N2=200000
+
+label=$1
+shift
+
+count_insns() {
+    cmd=$(echo "$*" | sed "s/@N@/$N/g")
+    # libinsn prints "insns: <count>" (per vCPU lines are summed)
+    eval "$cmd" 2>&1 | awk '/insns:/ { sum += $NF } END { print sum + 0 }'
+}
+
+N=$N1; i1=$(count_insns "$@")
+N=$N2; i2=$(count_insns "$@")
+
+if [ "$i1" -eq 0 ] || [ "$i2" -eq 0 ]; then
+    echo "$label: no instruction count (is the QEMU insn plugin available?)" >&2
+    exit 1
+fi
+
+awk -v l="$label" -v a="$i1" -v b="$i2" -v n1="$N1" -v n2="$N2" \
+    'BEGIN { printf "%s: %.1f instructions per ProtectionOverload_SM_Run\n", l, (b - a) / (n2 - n1) }'
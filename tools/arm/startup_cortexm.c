@@ -0,0 +1,50 @@
+// Cortex-M startup for QEMU MPS2 boards (mps2-an386 Cortex-M4, mps2-an500 Cortex-M7)
+//
+// Minimal vector table: QEMU loads the ELF segments directly into the board
+// SSRAM, so no .data copy is needed. Reset enables the FPU and jumps to the
+// newlib/rdimon C runtime (_start), which clears .bss, sets up semihosting
+// argv/stdio and calls main().
+
+#include <stdint.h>
+
+extern uint32_t __StackTop;
+extern void _start(void);
+
+void Reset_Handler(void);
+void Default_Handler(void);
+
+// Coprocessor Access Control Register
+#define SCB_CPACR   (*(volatile uint32_t *)0xE000ED88u)
+
+__attribute__((section(".isr_vector"), used))
+void (*const vector_table[16])(void) = {
+    (void (*)(void))&__StackTop,        // Initial stack pointer
+    Reset_Handler,                      // Reset
+    Default_Handler,                    // NMI
+    Default_Handler,                    // HardFault
+    Default_Handler,                    // MemManage
+    Default_Handler,                    // BusFault
+    Default_Handler,                    // UsageFault
+    0, 0, 0, 0,                         // Reserved
+    Default_Handler,                    // SVCall
+    Default_Handler,                    // DebugMonitor
+    0,                                  // Reserved
+    Default_Handler,                    // PendSV
+    Default_Handler                     // SysTick
+};
+
+void Reset_Handler(void) {
+#if defined(__ARM_FP)
+    // Full access to CP10/CP11 (single/double precision FPU)
+    SCB_CPACR |= (0xFu << 20);
+    __asm volatile("dsb\n\tisb");
+#endif
+    _start();
+    for (;;) {
+    }
+}
+
+void Default_Handler(void) {
+    for (;;) {
+    }
+}
@@ -0,0 +1,354 @@
+/* =========================================================================
+    Unity Bench - Performance assertions for Unity
+========================================================================= */
+
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include "unity_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif !defined(UNITY_BENCH_NO_CLOCK)
+#include <time.h>
+#endif
+
+#define UNITY_BENCH_MAX_ENTRIES 64
+
+/*-------------------------------------------------------
+ * Clock
+ *-------------------------------------------------------*/
+
+static double UnityBenchNowNs(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER count, freq;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&freq);
+    return (double)count.QuadPart * 1e9 / (double)freq.QuadPart;
+#elif !defined(UNITY_BENCH_NO_CLOCK)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#else
+    return 0.0;
+#endif
+}
+
+/*-------------------------------------------------------
+ * Measurement
+ *-------------------------------------------------------*/
+
+static int UnityBenchCompare(const void* a, const void* b)
+{
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+void UnityBenchBegin(UnityBench* bench, const char* name, unsigned long iterations)
+{
+    bench->name = name;
+    bench->iterations = (iterations > 0) ? iterations : 1;
+    bench->repeat = 0;
+    bench->median_ns_per_call = 0.0;
+    bench->start_ns = UnityBenchNowNs();
+}
+
+int UnityBenchRunning(UnityBench* bench)
+{
+    if (bench->repeat < UNITY_BENCH_REPEATS)
+    {
+        return 1;
+    }
+
+    /* All batches done: median ns per call */
+    double sorted[UNITY_BENCH_REPEATS];
+    memcpy(sorted, bench->batch_ns, sizeof(sorted));
+    qsort(sorted, UNITY_BENCH_REPEATS, sizeof(sorted[0]), UnityBenchCompare);
+    bench->median_ns_per_call = sorted[UNITY_BENCH_REPEATS / 2] / (double)bench->iterations;
+    return 0;
+}
+
+void UnityBenchNext(UnityBench* bench)
+{
+    double now = UnityBenchNowNs();
+    bench->batch_ns[bench->repeat++] = now - bench->start_ns;
+    bench->start_ns = UnityBenchNowNs();
+}
+
+/* One batch of an interleaved benchmark: the first round begins it */
+int UnityBenchBatchBegin(UnityBench* bench, const char* name, unsigned long iterations, unsigned int round)
+{
+    if (round == 0)
+    {
+        UnityBenchBegin(bench, name, iterations);
+    }
+    bench->start_ns = UnityBenchNowNs();
+    return 1;
+}
+
+/* End of a batch, the last one computes the result */
+int UnityBenchBatchEnd(UnityBench* bench)
+{
+    UnityBenchNext(bench);
+    (void)UnityBenchRunning(bench);
+    return 0;
+}
+
+static void UnityBenchReport(const UnityBench* bench, const char* what, double reference)
+{
+    UnityPrint(bench->name);
+    UnityPrint(": ");
+    UnityPrintFloat(bench->median_ns_per_call);
+    UnityPrint(" ns/call, ");
+    UnityPrint(what);
+    UnityPrint(" ");
+    UnityPrintFloat(reference);
+    UnityPrint(" ns/call");
+    UNITY_PRINT_EOL();
+}
+
+void UnityBenchAssertMaxNs(const UnityBench* bench, double max_ns, const char* msg, const UNITY_LINE_TYPE line)
+{
+#if defined(UNITY_BENCH_NO_CLOCK)
+    (void)bench; (void)max_ns; (void)msg;
+    UnityIgnore("No clock available for benchmarks", line);
+#else
+    UnityBenchReport(bench, "limit", max_ns);
+    if (bench->median_ns_per_call > max_ns)
+    {
+        UnityFail(msg != NULL ? msg : "Median time per call exceeds limit.", line);
+    }
+#endif
+}
+
+/*-------------------------------------------------------
+ * Baseline file
+ *-------------------------------------------------------*/
+
+typedef struct
+{
+    char name[UNITY_BENCH_MAX_NAME];
+    double ns_per_call;
+} UnityBenchEntry;
+
+static UnityBenchEntry baseline[UNITY_BENCH_MAX_ENTRIES];
+static unsigned int baseline_count;
+static int baseline_loaded;
+
+/* Entry names are the bench names with blanks replaced by '_' */
+static void UnityBenchKey(char* key, const char* name)
+{
+    size_t i;
+    for (i = 0; i < UNITY_BENCH_MAX_NAME - 1 && name[i] != '\0'; i++)
+    {
+        key[i] = (name[i] == ' ' || name[i] == '\t') ? '_' : name[i];
+    }
+    key[i] = '\0';
+}
+
+static void UnityBenchLoad(void)
+{
+    FILE* file;
+    char line[160];
+
+    baseline_loaded = 1;
+    file = fopen(UNITY_BENCH_BASELINE_FILE, "r");
+    if (file == NULL)
+    {
+        return;
+    }
+    while (fgets(line, sizeof(line), file) != NULL && baseline_count < UNITY_BENCH_MAX_ENTRIES)
+    {
+        UnityBenchEntry* entry = &baseline[baseline_count];
+        if (line[0] == '#')
+        {
+            continue;
+        }
+        if (sscanf(line, "%63s %lf", entry->name, &entry->ns_per_call) == 2)
+        {
+            baseline_count++;
+        }
+    }
+    fclose(file);
+}
+
+static void UnityBenchSave(void)
+{
+    FILE* file = fopen(UNITY_BENCH_BASELINE_FILE, "w");
+    unsigned int i;
+    if (file == NULL)
+    {
+        return;
+    }
+    fprintf(file, "# Unity Bench baseline: <name> <median ns per call>\n");
+    fprintf(file, "# Regenerate with UNITY_BENCH_UPDATE=1 on the reference machine\n");
+    for (i = 0; i < baseline_count; i++)
+    {
+        fprintf(file, "%s %.2f\n", baseline[i].name, baseline[i].ns_per_call);
+    }
+    fclose(file);
+}
+
+static UnityBenchEntry* UnityBenchFind(const char* key)
+{
+    unsigned int i;
+    for (i = 0; i < baseline_count; i++)
+    {
+        if (strcmp(baseline[i].name, key) == 0)
+        {
+            return &baseline[i];
+        }
+    }
+    return NULL;
+}
+
+/* Update mode: UNITY_BENCH_UPDATE=1 in the environment */
+static int UnityBenchUpdating(void)
+{
+    const char* env = getenv("UNITY_BENCH_UPDATE");
+    return env != NULL && env[0] == '1';
+}
+
+/* Tolerance [%]: argument, else UNITY_BENCH_TOLERANCE, else the build default */
+static double UnityBenchTolerance(double tolerance_pct)
+{
+    const char* env;
+    if (tolerance_pct >= 0.0)
+    {
+        return tolerance_pct;
+    }
+    env = getenv("UNITY_BENCH_TOLERANCE");
+    return (env != NULL) ? atof(env) : (double)UNITY_BENCH_TOLERANCE_PCT;
+}
+
+/* Entry of a benchmark (NULL: none), loading the file on first use */
+static UnityBenchEntry* UnityBenchEntryOf(const UnityBench* bench)
+{
+    char key[UNITY_BENCH_MAX_NAME];
+    if (!baseline_loaded)
+    {
+        UnityBenchLoad();
+    }
+    UnityBenchKey(key, bench->name);
+    return UnityBenchFind(key);
+}
+
+/* Store a measurement as new baseline entry */
+static void UnityBenchStore(const UnityBench* bench, double ns_per_call)
+{
+    UnityBenchEntry* entry = UnityBenchEntryOf(bench);
+    if (entry == NULL && baseline_count < UNITY_BENCH_MAX_ENTRIES)
+    {
+        entry = &baseline[baseline_count++];
+        UnityBenchKey(entry->name, bench->name);
+    }
+    if (entry != NULL)
+    {
+        entry->ns_per_call = ns_per_call;
+        UnityBenchSave();
+    }
+}
+
+void UnityBenchAssertBaseline(const UnityBench* bench, double tolerance_pct, const char* msg, const UNITY_LINE_TYPE line)
+{
+#if defined(UNITY_BENCH_NO_CLOCK)
+    (void)bench; (void)tolerance_pct; (void)msg;
+    UnityIgnore("No clock available for benchmarks", line);
+#else
+    UnityBenchEntry* entry;
+
+    /* Update mode: store the measurement as new baseline */
+    if (UnityBenchUpdating())
+    {
+        UnityBenchStore(bench, bench->median_ns_per_call);
+        UnityBenchReport(bench, "new baseline", bench->median_ns_per_call);
+        return;
+    }
+
+    entry = UnityBenchEntryOf(bench);
+    if (entry == NULL)
+    {
+        UnityIgnore("No baseline for this benchmark (run with UNITY_BENCH_UPDATE=1)", line);
+    }
+
+    UnityBenchReport(bench, "baseline", entry->ns_per_call);
+    if (bench->median_ns_per_call > entry->ns_per_call * (1.0 + UnityBenchTolerance(tolerance_pct) / 100.0))
+    {
+        UnityFail(msg != NULL ? msg : "Median time per call regressed beyond tolerance.", line);
+    }
+#endif
+}
+
+#if !defined(UNITY_BENCH_NO_CLOCK)
+/* Median over the rounds of the time per call relative to the reference */
+static double UnityBenchRatio(const UnityBench* bench, const UnityBench* reference)
+{
+    double ratios[UNITY_BENCH_REPEATS];
+    unsigned int i;
+    for (i = 0; i < UNITY_BENCH_REPEATS; i++)
+    {
+        ratios[i] = (bench->batch_ns[i] / (double)bench->iterations) /
+                    (reference->batch_ns[i] / (double)reference->iterations);
+    }
+    qsort(ratios, UNITY_BENCH_REPEATS, sizeof(ratios[0]), UnityBenchCompare);
+    return ratios[UNITY_BENCH_REPEATS / 2];
+}
+
+static void UnityBenchReportRatio(const UnityBench* bench, const UnityBench* reference, const char* what, double ratio)
+{
+    UnityPrint(bench->name);
+    UnityPrint(": ");
+    UnityPrintFloat(UnityBenchRatio(bench, reference));
+    UnityPrint(" x ");
+    UnityPrint(reference->name);
+    UnityPrint(", ");
+    UnityPrint(what);
+    UnityPrint(" ");
+    UnityPrintFloat(ratio);
+    UnityPrint(" x");
+    UNITY_PRINT_EOL();
+}
+#endif
+
+void UnityBenchAssertBaselineRelative(const UnityBench* bench, const UnityBench* reference, double tolerance_pct,
+                                      const char* msg, const UNITY_LINE_TYPE line)
+{
+#if defined(UNITY_BENCH_NO_CLOCK)
+    (void)bench; (void)reference; (void)tolerance_pct; (void)msg;
+    UnityIgnore("No clock available for benchmarks", line);
+#else
+    UnityBenchEntry* entry;
+    UnityBenchEntry* reference_entry;
+    double ratio;
+
+    /* Update mode: store the reference median, and the benchmark at the measured ratio to it */
+    if (UnityBenchUpdating())
+    {
+        ratio = UnityBenchRatio(bench, reference);
+        UnityBenchStore(bench, reference->median_ns_per_call * ratio);
+        UnityBenchStore(reference, reference->median_ns_per_call);
+        UnityBenchReportRatio(bench, reference, "new baseline", ratio);
+        return;
+    }
+
+    entry = UnityBenchEntryOf(bench);
+    reference_entry = UnityBenchEntryOf(reference);
+    if (entry == NULL || reference_entry == NULL)
+    {
+        UnityIgnore("No baseline for this benchmark or its reference (run with UNITY_BENCH_UPDATE=1)", line);
+    }
+
+    ratio = entry->ns_per_call / reference_entry->ns_per_call;
+    UnityBenchReportRatio(bench, reference, "baseline", ratio);
+    if (UnityBenchRatio(bench, reference) > ratio * (1.0 + UnityBenchTolerance(tolerance_pct) / 100.0))
+    {
+        UnityFail(msg != NULL ? msg : "Time per call relative to the reference regressed beyond tolerance.", line);
+    }
+#endif
+}
@@ -0,0 +1,113 @@
+/* =========================================================================
+    Unity Bench - Performance assertions for Unity
+    Times a block over many iterations and checks the median cost per call
+    against an absolute limit or a stored baseline.
+========================================================================= */
+
+#ifndef UNITY_BENCH_H
+#define UNITY_BENCH_H
+
+#include "unity.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/*-------------------------------------------------------
+ * Configuration
+ *-------------------------------------------------------*/
+
+/* Number of timed batches, the median batch is used (odd) */
+#ifndef UNITY_BENCH_REPEATS
+#define UNITY_BENCH_REPEATS 11
+#endif
+
+/* Allowed median regression against baseline [%] (overridden at run time by
+ * the UNITY_BENCH_TOLERANCE environment variable) */
+#ifndef UNITY_BENCH_TOLERANCE_PCT
+#define UNITY_BENCH_TOLERANCE_PCT 50
+#endif
+
+/* Baseline file: one "<name> <median ns per call>" entry per line. Running
+ * with UNITY_BENCH_UPDATE=1 in the environment rewrites measured entries.
+ * A relative assertion compares the ratio of a benchmark to a reference timed
+ * in the same run with the ratio of their entries, so that a host running
+ * slower or faster as a whole does not move it. It uses the fastest batch of
+ * each, the one least disturbed by other load, and so do its entries. */
+#ifndef UNITY_BENCH_BASELINE_FILE
+#define UNITY_BENCH_BASELINE_FILE "perf_baseline.txt"
+#endif
+
+#define UNITY_BENCH_MAX_NAME 64
+
+/*-------------------------------------------------------
+ * Measurement
+ *-------------------------------------------------------*/
+
+typedef struct
+{
+    const char* name;
+    unsigned long iterations;           /* Calls per batch */
+    unsigned int repeat;                /* Current batch */
+    double start_ns;
+    double batch_ns[UNITY_BENCH_REPEATS];
+    double median_ns_per_call;          /* Result, valid after the TEST_BENCH loop */
+} UnityBench;
+
+void UnityBenchBegin(UnityBench* bench, const char* name, unsigned long iterations);
+int UnityBenchRunning(UnityBench* bench);
+void UnityBenchNext(UnityBench* bench);
+int UnityBenchBatchBegin(UnityBench* bench, const char* name, unsigned long iterations, unsigned int round);
+int UnityBenchBatchEnd(UnityBench* bench);
+
+void UnityBenchAssertMaxNs(const UnityBench* bench, double max_ns, const char* msg, const UNITY_LINE_TYPE line);
+void UnityBenchAssertBaseline(const UnityBench* bench, double tolerance_pct, const char* msg, const UNITY_LINE_TYPE line);
+void UnityBenchAssertBaselineRelative(const UnityBench* bench, const UnityBench* reference, double tolerance_pct,
+                                      const char* msg, const UNITY_LINE_TYPE line);
+
+/*-------------------------------------------------------
+ * Test Macros
+ *-------------------------------------------------------*/
+
+/* Time the following statement or block:
+ *     UnityBench bench;
+ *     TEST_BENCH(bench, "SM_Run idle", 100000) { ProtectionOverload_SM_Run(); }
+ *     TEST_ASSERT_MAX_NS_PER_CALL(200.0, bench);
+ *     TEST_ASSERT_BENCH_BASELINE(bench);
+ *     TEST_ASSERT_BENCH_BASELINE_RELATIVE(bench, reference);
+ */
+#define TEST_BENCH(bench, name, calls) \
+    for (UnityBenchBegin(&(bench), (name), (calls)); UnityBenchRunning(&(bench)); UnityBenchNext(&(bench))) \
+        for (unsigned long unity_bench_i = 0; unity_bench_i < (bench).iterations; unity_bench_i++)
+
+/* Time several blocks in alternating batches, one batch of each per round, so
+ * that all of them see the same host load (compare them with
+ * TEST_ASSERT_BENCH_BASELINE_RELATIVE, which works round by round):
+ *     UnityBench run, publish;
+ *     TEST_BENCH_ROUNDS(r)
+ *     {
+ *         TEST_BENCH_BATCH(run, "Run", 100000, r) { ProtectionOverload_Run(&sm, 2.0f); }
+ *         TEST_BENCH_BATCH(publish, "Run + publish", 100000, r) { ... }
+ *     }
+ *     TEST_ASSERT_BENCH_BASELINE_RELATIVE(publish, run);
+ */
+#define TEST_BENCH_ROUNDS(round) \
+    for (unsigned int round = 0; round < UNITY_BENCH_REPEATS; round++)
+
+#define TEST_BENCH_BATCH(bench, name, calls, round) \
+    for (int unity_bench_batch = UnityBenchBatchBegin(&(bench), (name), (calls), (round)); unity_bench_batch; \
+         unity_bench_batch = UnityBenchBatchEnd(&(bench))) \
+        for (unsigned long unity_bench_i = 0; unity_bench_i < (bench).iterations; unity_bench_i++)
+
+#define TEST_ASSERT_MAX_NS_PER_CALL(max_ns, bench)                      UnityBenchAssertMaxNs(&(bench), (max_ns), NULL, __LINE__)
+#define TEST_ASSERT_MAX_NS_PER_CALL_MESSAGE(max_ns, bench, message)     UnityBenchAssertMaxNs(&(bench), (max_ns), (message), __LINE__)
+#define TEST_ASSERT_BENCH_BASELINE(bench)                               UnityBenchAssertBaseline(&(bench), -1.0, NULL, __LINE__)
+#define TEST_ASSERT_BENCH_BASELINE_WITHIN(pct, bench)                   UnityBenchAssertBaseline(&(bench), (pct), NULL, __LINE__)
+#define TEST_ASSERT_BENCH_BASELINE_RELATIVE(bench, reference)           UnityBenchAssertBaselineRelative(&(bench), &(reference), -1.0, NULL, __LINE__)
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UNITY_BENCH_H */